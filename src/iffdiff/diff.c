@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "diff.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ifftypes.h"
+#include "id.h"
+#include "fileio.h"
+
+#define IFFDIFF_BLOCK_SIZE 65536
+
+/* Header size of a chunk, consisting of its chunk id and size */
+#define IFFDIFF_HEADER_SIZE 8
+
+typedef struct
+{
+    /** Offset of the chunk header in the file */
+    long offset;
+    
+    IFF_ID chunkId;
+    IFF_ULong chunkSize;
+    
+    /** Indicates whether the chunk is a group chunk, which has a group type followed by sub chunks */
+    int isGroup;
+    IFF_ID groupType;
+    
+    /** Number of bytes that the chunk occupies in its parent, including its header and padding byte */
+    IFF_ULong length;
+}
+IFF_DiffEntry;
+
+typedef struct
+{
+    FILE *file[2];
+    const char *filename[2];
+    
+    /** Path of the chunk that is currently compared */
+    char *path;
+    size_t pathLength;
+    size_t pathCapacity;
+    
+    /** Buffers in which the chunks of both files are read to compare them */
+    IFF_UByte *block[2];
+    
+    /** Number of differences that have been reported so far */
+    unsigned int differences;
+}
+IFF_Diff;
+
+static IFF_ULong parseULong(const IFF_UByte *bytes)
+{
+    return (IFF_ULong)bytes[0] << 24 | (IFF_ULong)bytes[1] << 16 | (IFF_ULong)bytes[2] << 8 | (IFF_ULong)bytes[3];
+}
+
+static int isGroupChunk(const IFF_ID chunkId, const IFF_ID parentChunkId)
+{
+    return IFF_compareId(chunkId, "FORM") == 0 ||
+	IFF_compareId(chunkId, "CAT ") == 0 ||
+	IFF_compareId(chunkId, "LIST") == 0 ||
+	(parentChunkId != NULL && IFF_compareId(parentChunkId, "LIST") == 0 && IFF_compareId(chunkId, "PROP") == 0);
+}
+
+/**
+ * Reads the headers of the chunks that are stored in the given range of a file,
+ * without reading their contents.
+ */
+static int readEntries(IFF_Diff *diff, const unsigned int side, const IFF_ID parentChunkId, long offset, const long end, IFF_DiffEntry **entries, unsigned int *entriesLength)
+{
+    unsigned int capacity = 0;
+    
+    *entries = NULL;
+    *entriesLength = 0;
+    
+    while(offset < end)
+    {
+	IFF_UByte header[IFFDIFF_HEADER_SIZE + IFF_ID_SIZE];
+	IFF_DiffEntry *entry;
+	
+	if(end - offset < IFFDIFF_HEADER_SIZE || !IFF_readFileRange(diff->file[side], offset, header, IFFDIFF_HEADER_SIZE))
+	{
+	    fprintf(stderr, "ERROR: Cannot read chunk header at offset %ld of: %s\n", offset, diff->filename[side]);
+	    free(*entries);
+	    return FALSE;
+	}
+	
+	if(*entriesLength == capacity)
+	{
+	    IFF_DiffEntry *newEntries;
+	    
+	    capacity = capacity == 0 ? 16 : capacity * 2;
+	    
+	    if((newEntries = (IFF_DiffEntry*)realloc(*entries, capacity * sizeof(IFF_DiffEntry))) == NULL)
+	    {
+		fprintf(stderr, "ERROR: Cannot allocate memory for the chunks of: %s\n", diff->filename[side]);
+		free(*entries);
+		return FALSE;
+	    }
+	    
+	    *entries = newEntries;
+	}
+	
+	entry = &(*entries)[*entriesLength];
+	entry->offset = offset;
+	memcpy(entry->chunkId, header, IFF_ID_SIZE);
+	entry->chunkSize = parseULong(header + IFF_ID_SIZE);
+	entry->isGroup = isGroupChunk(entry->chunkId, parentChunkId);
+	
+	if(entry->chunkSize > (IFF_ULong)(end - offset - IFFDIFF_HEADER_SIZE))
+	{
+	    fprintf(stderr, "ERROR: Chunk at offset %ld of %s exceeds the size of its parent\n", offset, diff->filename[side]);
+	    free(*entries);
+	    return FALSE;
+	}
+	
+	if(entry->isGroup)
+	{
+	    if(entry->chunkSize < IFF_ID_SIZE || !IFF_readFileRange(diff->file[side], offset + IFFDIFF_HEADER_SIZE, entry->groupType, IFF_ID_SIZE))
+	    {
+		fprintf(stderr, "ERROR: Cannot read group type at offset %ld of: %s\n", offset, diff->filename[side]);
+		free(*entries);
+		return FALSE;
+	    }
+	}
+	
+	/* Chunks with an odd size are followed by a padding byte, which may be missing at the end of the parent */
+	entry->length = IFFDIFF_HEADER_SIZE + entry->chunkSize;
+	
+	if((entry->chunkSize & 1) && (IFF_ULong)(end - offset) > entry->length)
+	    entry->length++;
+	
+	(*entriesLength)++;
+	offset += entry->length;
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Checks whether the bytes that two chunks of the same length occupy in both
+ * files are identical, by comparing them block by block. Stops at the first
+ * block that differs.
+ */
+static int compareRanges(IFF_Diff *diff, const IFF_DiffEntry *entry1, const IFF_DiffEntry *entry2, int *equal)
+{
+    long offset1 = entry1->offset;
+    long offset2 = entry2->offset;
+    IFF_ULong remaining = entry1->length;
+    
+    *equal = TRUE;
+    
+    while(remaining > 0)
+    {
+	IFF_ULong blockSize = remaining < IFFDIFF_BLOCK_SIZE ? remaining : IFFDIFF_BLOCK_SIZE;
+	
+	if(!IFF_readFileRange(diff->file[0], offset1, diff->block[0], blockSize))
+	{
+	    fprintf(stderr, "ERROR: Cannot read chunk at offset %ld of: %s\n", entry1->offset, diff->filename[0]);
+	    return FALSE;
+	}
+	
+	if(!IFF_readFileRange(diff->file[1], offset2, diff->block[1], blockSize))
+	{
+	    fprintf(stderr, "ERROR: Cannot read chunk at offset %ld of: %s\n", entry2->offset, diff->filename[1]);
+	    return FALSE;
+	}
+	
+	if(memcmp(diff->block[0], diff->block[1], blockSize) != 0)
+	{
+	    *equal = FALSE;
+	    break;
+	}
+	
+	offset1 += blockSize;
+	offset2 += blockSize;
+	remaining -= blockSize;
+    }
+    
+    return TRUE;
+}
+
+static int compareHeaders(const IFF_DiffEntry *entry1, const IFF_DiffEntry *entry2)
+{
+    return memcmp(entry1->chunkId, entry2->chunkId, IFF_ID_SIZE) == 0 &&
+	entry1->isGroup == entry2->isGroup &&
+	(!entry1->isGroup || memcmp(entry1->groupType, entry2->groupType, IFF_ID_SIZE) == 0);
+}
+
+/**
+ * Checks whether two chunks are byte-identical by comparing their sizes and
+ * contents.
+ */
+static int compareEntries(IFF_Diff *diff, const IFF_DiffEntry *entry1, const IFF_DiffEntry *entry2, int *equal)
+{
+    *equal = FALSE;
+    
+    if(!compareHeaders(entry1, entry2) || entry1->chunkSize != entry2->chunkSize || entry1->length != entry2->length)
+	return TRUE;
+    
+    return compareRanges(diff, entry1, entry2, equal);
+}
+
+/**
+ * Appends a path component of the given chunk to the current path and stores
+ * the length of the path before the component has been appended in pathLength.
+ */
+static int pushPath(IFF_Diff *diff, const IFF_DiffEntry *entry, const unsigned int index, size_t *pathLength)
+{
+    size_t maxLength = diff->pathLength + 1 + IFF_ID_SIZE + 1 + IFF_ID_SIZE + 2 + 10 + 1; /* "/ID:TYPE[index]" and the terminator */
+    
+    if(maxLength > diff->pathCapacity)
+    {
+	char *path = (char*)realloc(diff->path, maxLength * 2);
+	
+	if(path == NULL)
+	{
+	    fprintf(stderr, "ERROR: Cannot allocate memory for the path of a chunk\n");
+	    return FALSE;
+	}
+	
+	diff->path = path;
+	diff->pathCapacity = maxLength * 2;
+    }
+    
+    *pathLength = diff->pathLength;
+    
+    if(entry->isGroup)
+	diff->pathLength += sprintf(diff->path + *pathLength, "/%.4s:%.4s[%u]", entry->chunkId, entry->groupType, index);
+    else
+	diff->pathLength += sprintf(diff->path + *pathLength, "/%.4s[%u]", entry->chunkId, index);
+    
+    return TRUE;
+}
+
+static void popPath(IFF_Diff *diff, const size_t pathLength)
+{
+    diff->pathLength = pathLength;
+    diff->path[pathLength] = '\0';
+}
+
+static int reportDifference(IFF_Diff *diff, const char marker, const IFF_DiffEntry *entry, const unsigned int index)
+{
+    size_t pathLength;
+    
+    if(!pushPath(diff, entry, index, &pathLength))
+	return FALSE;
+    
+    printf("%c %s\n", marker, diff->path);
+    diff->differences++;
+    
+    popPath(diff, pathLength);
+    return TRUE;
+}
+
+static int diffChunks(IFF_Diff *diff, IFF_DiffEntry *entry1, IFF_DiffEntry *entry2, const unsigned int index);
+
+/**
+ * Compares the sub chunks in the given ranges of both files. If the numbers of
+ * sub chunks differ, leading and trailing sub chunks that are identical are
+ * skipped first. The remaining sub chunks are compared by position, and the sub
+ * chunks that are left over in one of the files are reported as removed or
+ * added. If both files have the same number of sub chunks, they are compared by
+ * position right away, so that the contents of nested chunks are only read once.
+ */
+static int diffSubChunks(IFF_Diff *diff, const IFF_ID parentChunkId, const long offset1, const long end1, const long offset2, const long end2)
+{
+    IFF_DiffEntry *entries1, *entries2;
+    unsigned int entries1Length, entries2Length;
+    unsigned int prefixLength = 0, suffixLength = 0;
+    unsigned int i;
+    int equal = TRUE;
+    int status = TRUE;
+    
+    if(!readEntries(diff, 0, parentChunkId, offset1, end1, &entries1, &entries1Length))
+	return FALSE;
+    
+    if(!readEntries(diff, 1, parentChunkId, offset2, end2, &entries2, &entries2Length))
+    {
+	free(entries1);
+	return FALSE;
+    }
+    
+    if(entries1Length != entries2Length)
+    {
+	/* Skip the identical sub chunks at the beginning */
+	while(prefixLength < entries1Length && prefixLength < entries2Length &&
+	    (status = compareEntries(diff, &entries1[prefixLength], &entries2[prefixLength], &equal)) && equal)
+	    prefixLength++;
+	
+	/* Skip the identical sub chunks at the end */
+	while(status && prefixLength + suffixLength < entries1Length && prefixLength + suffixLength < entries2Length &&
+	    (status = compareEntries(diff, &entries1[entries1Length - 1 - suffixLength], &entries2[entries2Length - 1 - suffixLength], &equal)) && equal)
+	    suffixLength++;
+    }
+    
+    /* Compare the remaining sub chunks */
+    for(i = prefixLength; status && i < entries1Length - suffixLength && i < entries2Length - suffixLength; i++)
+	status = diffChunks(diff, &entries1[i], &entries2[i], i);
+    
+    for(; status && i < entries1Length - suffixLength; i++)
+	status = reportDifference(diff, '-', &entries1[i], i);
+    
+    for(i = entries1Length - suffixLength; status && i < entries2Length - suffixLength; i++)
+	status = reportDifference(diff, '+', &entries2[i], i);
+    
+    free(entries1);
+    free(entries2);
+    
+    return status;
+}
+
+/**
+ * Compares two chunks that reside at the same position in both files. Group
+ * chunks are compared by their sub chunks, so that only the contents of data
+ * chunks are read.
+ */
+static int diffChunks(IFF_Diff *diff, IFF_DiffEntry *entry1, IFF_DiffEntry *entry2, const unsigned int index)
+{
+    if(!compareHeaders(entry1, entry2))
+    {
+	/* Chunks of a different kind are not comparable */
+	return reportDifference(diff, '-', entry1, index) &&
+	    reportDifference(diff, '+', entry2, index);
+    }
+    else if(entry1->isGroup)
+    {
+	/* Look for the sub chunks that differ */
+	unsigned int differences = diff->differences;
+	long offset1 = entry1->offset + IFFDIFF_HEADER_SIZE + IFF_ID_SIZE;
+	long offset2 = entry2->offset + IFFDIFF_HEADER_SIZE + IFF_ID_SIZE;
+	size_t pathLength;
+	int status;
+	
+	if(!pushPath(diff, entry1, index, &pathLength))
+	    return FALSE;
+	
+	status = diffSubChunks(diff, entry1->chunkId,
+	    offset1, offset1 + (long)entry1->chunkSize - IFF_ID_SIZE,
+	    offset2, offset2 + (long)entry2->chunkSize - IFF_ID_SIZE);
+	
+	popPath(diff, pathLength);
+	
+	/* If no sub chunk differs, but the groups do, for example because of their padding bytes, then report the group itself */
+	if(status && diff->differences == differences &&
+	    (entry1->chunkSize != entry2->chunkSize || entry1->length != entry2->length))
+	    status = reportDifference(diff, '!', entry1, index);
+	
+	return status;
+    }
+    else
+    {
+	int equal;
+	
+	if(!compareEntries(diff, entry1, entry2, &equal))
+	    return FALSE;
+	
+	if(equal)
+	    return TRUE;
+	else
+	    return reportDifference(diff, '!', entry1, index);
+    }
+}
+
+static long determineFileSize(FILE *file)
+{
+    if(fseek(file, 0, SEEK_END) != 0)
+	return -1;
+    else
+	return ftell(file);
+}
+
+int IFF_diff(const char *filename1, const char *filename2)
+{
+    IFF_Diff diff;
+    long size1, size2;
+    int status = 2;
+    
+    diff.filename[0] = filename1;
+    diff.filename[1] = filename2;
+    diff.path = NULL;
+    diff.pathLength = 0;
+    diff.pathCapacity = 0;
+    diff.differences = 0;
+    
+    if((diff.file[0] = fopen(filename1, "rb")) == NULL)
+    {
+	fprintf(stderr, "ERROR: Cannot open IFF file: %s\n", filename1);
+	return status;
+    }
+    
+    if((diff.file[1] = fopen(filename2, "rb")) == NULL)
+    {
+	fprintf(stderr, "ERROR: Cannot open IFF file: %s\n", filename2);
+	fclose(diff.file[0]);
+	return status;
+    }
+    
+    diff.block[0] = (IFF_UByte*)malloc(IFFDIFF_BLOCK_SIZE);
+    diff.block[1] = (IFF_UByte*)malloc(IFFDIFF_BLOCK_SIZE);
+    
+    if((size1 = determineFileSize(diff.file[0])) < 0 || (size2 = determineFileSize(diff.file[1])) < 0)
+	fprintf(stderr, "ERROR: Cannot determine the sizes of the IFF files\n");
+    else if(diff.block[0] != NULL && diff.block[1] != NULL && diffSubChunks(&diff, NULL, 0, size1, 0, size2))
+	status = diff.differences > 0;
+    
+    /* Cleanup */
+    free(diff.block[0]);
+    free(diff.block[1]);
+    free(diff.path);
+    fclose(diff.file[0]);
+    fclose(diff.file[1]);
+    
+    return status;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_DIFF_H
+#define __IFF_DIFF_H
+
+/**
+ * Compares the chunk hierarchies of two IFF files and displays the paths of the
+ * chunks that differ on the standard output. Lines starting with '-' refer to
+ * chunks that only exist in the first file, lines starting with '+' to chunks
+ * that only exist in the second file and lines starting with '!' to data
+ * chunks whose contents differ.
+ *
+ * The files are never loaded as a whole. Chunks are located by their offsets
+ * and their contents are compared block by block. Group chunks with the same
+ * number of sub chunks are compared by their sub chunks, without reading their
+ * contents as a whole first.
+ *
+ * @param filename1 Path to the first IFF file
+ * @param filename2 Path to the second IFF file
+ * @return 0 if both files are equal, 1 if they differ, 2 if an error occured
+ */
+int IFF_diff(const char *filename1, const char *filename2);
+
+#endif
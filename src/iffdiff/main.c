@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if HAVE_GETOPT_H == 1
+#include <getopt.h>
+#elif _MSC_VER
+#include <string.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include "diff.h"
+
+static void printUsage(const char *command)
+{
+    printf("Usage: %s [OPTION] file1.IFF file2.IFF\n\n", command);
+
+    puts(
+    "The command `iffdiff' compares the chunk hierarchies of two IFF files and\n"
+    "displays the paths of the chunks that differ. Lines starting with `-' refer to\n"
+    "chunks that only exist in the first file, lines starting with `+' to chunks that\n"
+    "only exist in the second file and lines starting with `!' to chunks whose\n"
+    "contents differ. Chunks are compared block by block, and the files are never\n"
+    "loaded in memory as a whole.\n\n"
+
+    "The exit status is 0 if the files are equal, 1 if they differ and 2 if an error\n"
+    "occured.\n\n"
+
+    "Options:\n"
+#if _MSC_VER
+    "  /?    Shows the usage of this command to the user\n"
+    "  /v    Shows the version of this command to the user"
+#else
+    "  -h, --help       Shows the usage of this command to the user\n"
+    "  -v, --version    Shows the version of this command to the user"
+#endif
+    );
+}
+
+static void printVersion(const char *command)
+{
+    printf(
+    "%s (" PACKAGE_NAME ") " PACKAGE_VERSION "\n\n"
+    "Copyright (C) 2012-2015 Sander van der Burg\n"
+    , command);
+}
+
+int main(int argc, char *argv[])
+{
+#if _MSC_VER
+    unsigned int optind = 1;
+    unsigned int i;
+
+    for(i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "/?") == 0)
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (strcmp(argv[i], "/v") == 0)
+        {
+            printVersion(argv[0]);
+            return 0;
+        }
+    }
+#else
+    int c;
+#if HAVE_GETOPT_H == 1
+    int option_index = 0;
+    struct option long_options[] =
+    {
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0}
+    };
+#endif
+    
+    /* Parse command-line options */
+#if HAVE_GETOPT_H == 1
+    while((c = getopt_long(argc, argv, "hv", long_options, &option_index)) != -1)
+#else
+    while((c = getopt(argc, argv, "hv")) != -1)
+#endif
+    {
+        switch(c)
+        {
+            case 'h':
+                printUsage(argv[0]);
+                return 0;
+            case '?':
+                printUsage(argv[0]);
+                return 2;
+            case 'v':
+                printVersion(argv[0]);
+                return 0;
+        }
+    }
+#endif
+    /* Validate non options */
+    
+    if(argc - optind != 2)
+    {
+        fprintf(stderr, "ERROR: Two IFF input files must be given!\n");
+        return 2;
+    }
+    else
+        return IFF_diff(argv[optind], argv[optind + 1]); /* Compare the IFF files */
+}
@@ -38,11 +38,10 @@ int IFF_join(char **inputFilenames, const unsigned int inputFilenamesLength, con
     
     for(i = 0; i < inputFilenamesLength; i++)
     {
-	/* Open each input IFF file */
-	IFF_Chunk *chunk = IFF_read(inputFilenames[i], NULL, 0);
+	/* Open each input IFF file and check whether it is valid while it is read */
+	IFF_Chunk *chunk = IFF_readChecked(inputFilenames[i], NULL, 0);
 	
-	/* Check whether the IFF file is valid */
-	if(chunk == NULL || !IFF_check(chunk, NULL, 0))
+	if(chunk == NULL)
 	{
 	    IFF_free((IFF_Chunk*)cat, NULL, 0);
 	    return 1;
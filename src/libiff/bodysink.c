@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bodysink.h"
+#include <stdlib.h>
+#include "id.h"
+#include "error.h"
+
+void IFF_setBodySinks(IFF_Reader *reader, const IFF_BodySink *sinks, const unsigned int sinksLength)
+{
+    reader->bodySinks = sinks;
+    reader->bodySinksLength = sinksLength;
+}
+
+const IFF_BodySink *IFF_findBodySink(const IFF_Reader *reader, const char *chunkId)
+{
+    unsigned int i;
+    
+    for(i = 0; i < reader->bodySinksLength; i++)
+    {
+	if(IFF_compareId(reader->bodySinks[i].chunkId, chunkId) == 0)
+	    return &reader->bodySinks[i];
+    }
+    
+    return NULL;
+}
+
+int IFF_readBody(IFF_Reader *reader, const IFF_BodySink *sink, const IFF_ID chunkId, const IFF_Long chunkSize)
+{
+    IFF_UByte block[IFF_BODY_BLOCK_SIZE];
+    IFF_ULong remaining = chunkSize;
+    
+    if(sink->beginBody != NULL && !sink->beginBody(chunkId, chunkSize, sink->userData))
+	return FALSE;
+    
+    while(remaining > 0)
+    {
+	IFF_ULong blockSize = remaining < IFF_BODY_BLOCK_SIZE ? remaining : IFF_BODY_BLOCK_SIZE;
+	
+	if(IFF_readData(reader, block, blockSize) != TRUE)
+	{
+	    IFF_error("Error reading chunk body of chunk: '");
+	    IFF_errorId(chunkId);
+	    IFF_error("'\n");
+	    return FALSE;
+	}
+	
+	if(!sink->consumeBody(block, blockSize, sink->userData))
+	    return FALSE;
+	
+	remaining -= blockSize;
+    }
+    
+    if(sink->endBody != NULL && !sink->endBody(sink->userData))
+	return FALSE;
+    
+    return TRUE;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_BODYSINK_H
+#define __IFF_BODYSINK_H
+
+typedef struct IFF_BodySink IFF_BodySink;
+
+#include "ifftypes.h"
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum amount of bytes that is passed to a body sink at once */
+#define IFF_BODY_BLOCK_SIZE 65536
+
+/**
+ * @brief Receives the body of a data chunk in blocks, so that arbitrarily
+ * large bodies can be processed with a constant amount of memory.
+ */
+struct IFF_BodySink
+{
+    /** A 4 character id of the chunks whose bodies are passed to the sink */
+    const char *chunkId;
+    
+    /** Optional: invoked before the first block of a body is passed to the sink */
+    int (*beginBody) (const IFF_ID chunkId, const IFF_Long chunkSize, void *userData);
+    
+    /** Invoked for every consecutive block of the body */
+    int (*consumeBody) (const IFF_UByte *block, const IFF_ULong size, void *userData);
+    
+    /** Optional: invoked after the last block of a body has been passed to the sink */
+    int (*endBody) (void *userData);
+    
+    /** Pointer that is passed to the functions of the sink */
+    void *userData;
+};
+
+/**
+ * Registers body sinks with a reader. Raw chunks with a chunk id for which a
+ * sink is registered are not kept in memory, but their bodies are passed to the
+ * sink while they are read. The resulting raw chunks have no chunk data, so they
+ * can only be written by a writer that copies unmodified chunks from their
+ * source file, such as the passthrough writer.
+ *
+ * @param reader A reader instance
+ * @param sinks An array of body sinks, which must stay valid as long as the reader is used
+ * @param sinksLength Length of the body sinks array
+ */
+void IFF_setBodySinks(IFF_Reader *reader, const IFF_BodySink *sinks, const unsigned int sinksLength);
+
+/**
+ * Searches for the body sink that has been registered with a reader for the given chunk id.
+ *
+ * @param reader A reader instance
+ * @param chunkId A 4 character chunk id
+ * @return The body sink for the given chunk id, or NULL if there is none
+ */
+const IFF_BodySink *IFF_findBodySink(const IFF_Reader *reader, const char *chunkId);
+
+/**
+ * Reads a chunk body of the given size and passes it to a body sink in blocks of
+ * at most IFF_BODY_BLOCK_SIZE bytes. The padding byte is not read. Extensions may
+ * invoke this function from their readChunk function to process large bodies
+ * with their own sink.
+ *
+ * @param reader A reader instance
+ * @param sink A body sink
+ * @param chunkId A 4 character chunk id
+ * @param chunkSize Size of the chunk body in bytes
+ * @return TRUE if the body has been successfully read and consumed, else FALSE
+ */
+int IFF_readBody(IFF_Reader *reader, const IFF_BodySink *sink, const IFF_ID chunkId, const IFF_Long chunkSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
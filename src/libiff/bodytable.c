@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bodytable.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_SLOT_CAPACITY 64
+
+/**
+ * Computes the 32-bit FNV-1a hash of a body.
+ */
+static unsigned long hashBody(const IFF_UByte *data, const IFF_ULong size)
+{
+    unsigned long hash = 2166136261UL;
+    IFF_ULong i;
+    
+    for(i = 0; i < size; i++)
+    {
+	hash ^= data[i];
+	hash = (hash * 16777619UL) & 0xffffffffUL;
+    }
+    
+    return hash;
+}
+
+static int allocateSlots(IFF_BodyTable *table, const unsigned int slotCapacity)
+{
+    table->hash = (unsigned long*)malloc(slotCapacity * sizeof(unsigned long));
+    table->body = (IFF_SharedData**)calloc(slotCapacity, sizeof(IFF_SharedData*));
+    
+    if(table->hash == NULL || table->body == NULL)
+    {
+	free(table->hash);
+	free(table->body);
+	return FALSE;
+    }
+    
+    table->slotCapacity = slotCapacity;
+    return TRUE;
+}
+
+/**
+ * Returns the slot that contains the given body, or the empty slot in which it should be stored.
+ */
+static unsigned int findSlot(const IFF_BodyTable *table, const unsigned long hash, const IFF_UByte *data, const IFF_ULong size)
+{
+    unsigned int mask = table->slotCapacity - 1;
+    unsigned int slot = hash & mask;
+    
+    while(table->body[slot] != NULL)
+    {
+	const IFF_SharedData *body = table->body[slot];
+	
+	if(table->hash[slot] == hash && body->size == size && memcmp(body->data, data, size) == 0)
+	    break;
+	
+	slot = (slot + 1) & mask;
+    }
+    
+    return slot;
+}
+
+/**
+ * Doubles the number of slots, so that the table stays at most half full.
+ */
+static int growTable(IFF_BodyTable *table)
+{
+    unsigned long *hash = table->hash;
+    IFF_SharedData **body = table->body;
+    unsigned int slotCapacity = table->slotCapacity;
+    unsigned int i;
+    
+    if(!allocateSlots(table, slotCapacity * 2))
+    {
+	table->hash = hash;
+	table->body = body;
+	return FALSE;
+    }
+    
+    for(i = 0; i < slotCapacity; i++)
+    {
+	if(body[i] != NULL)
+	{
+	    unsigned int slot = hash[i] & (table->slotCapacity - 1);
+	    
+	    /* All bodies are distinct, so only an empty slot has to be found */
+	    while(table->body[slot] != NULL)
+		slot = (slot + 1) & (table->slotCapacity - 1);
+	    
+	    table->hash[slot] = hash[i];
+	    table->body[slot] = body[i];
+	}
+    }
+    
+    free(hash);
+    free(body);
+    return TRUE;
+}
+
+IFF_BodyTable *IFF_createBodyTable(void)
+{
+    IFF_BodyTable *table = (IFF_BodyTable*)malloc(sizeof(IFF_BodyTable));
+    
+    if(table != NULL)
+    {
+	table->bodyLength = 0;
+	
+	if(!allocateSlots(table, INITIAL_SLOT_CAPACITY))
+	{
+	    free(table);
+	    return NULL;
+	}
+    }
+    
+    return table;
+}
+
+IFF_SharedData *IFF_internBody(IFF_BodyTable *table, IFF_UByte *data, const IFF_ULong size)
+{
+    unsigned long hash = hashBody(data, size);
+    unsigned int slot = findSlot(table, hash, data, size);
+    IFF_SharedData *body = table->body[slot];
+    
+    if(body != NULL)
+    {
+	/* An identical body has been read before */
+	free(data);
+	return IFF_retainSharedData(body);
+    }
+    
+    if(2 * (table->bodyLength + 1) > table->slotCapacity)
+    {
+	if(!growTable(table))
+	    return NULL;
+	
+	slot = findSlot(table, hash, data, size);
+    }
+    
+    if((body = IFF_createSharedData(data, size, NULL, NULL)) == NULL)
+	return NULL;
+    
+    table->hash[slot] = hash;
+    table->body[slot] = body;
+    table->bodyLength++;
+    
+    return IFF_retainSharedData(body);
+}
+
+void IFF_freeBodyTable(IFF_BodyTable *table)
+{
+    unsigned int i;
+    
+    for(i = 0; i < table->slotCapacity; i++)
+    {
+	if(table->body[i] != NULL)
+	    IFF_releaseSharedData(table->body[i]);
+    }
+    
+    free(table->hash);
+    free(table->body);
+    free(table);
+}
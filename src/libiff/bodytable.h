@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_BODYTABLE_H
+#define __IFF_BODYTABLE_H
+
+#include "ifftypes.h"
+#include "shareddata.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A hash table of the distinct raw chunk bodies that have been read, so
+ * that identical bodies can be stored only once.
+ */
+typedef struct IFF_BodyTable
+{
+    /** Number of slots in the table, which is always a power of two */
+    unsigned int slotCapacity;
+    
+    /** Number of distinct bodies in the table */
+    unsigned int bodyLength;
+    
+    /** Contains the hash of the body in each slot */
+    unsigned long *hash;
+    
+    /** Contains the body in each slot, or NULL if the slot is empty. The table holds a reference to each body. */
+    IFF_SharedData **body;
+}
+IFF_BodyTable;
+
+/**
+ * Creates an empty body table. The resulting table must be freed using IFF_freeBodyTable().
+ *
+ * @return An empty body table, or NULL if the memory can't be allocated
+ */
+IFF_BodyTable *IFF_createBodyTable(void);
+
+/**
+ * Looks up a body in the table and adds it if no identical body has been added
+ * before. The table takes over the ownership of the given data: if an identical
+ * body exists, the data is freed and the existing body is returned instead.
+ *
+ * @param table A body table
+ * @param data An array of bytes allocated with malloc()
+ * @param size Length of the bytes array
+ * @return Shared data containing the body with a reference that belongs to the caller, or NULL if the memory can't be allocated, in which case the data is not freed
+ */
+IFF_SharedData *IFF_internBody(IFF_BodyTable *table, IFF_UByte *data, const IFF_ULong size);
+
+/**
+ * Frees a body table. Bodies that are still referenced by chunks stay valid.
+ *
+ * @param table A body table
+ */
+void IFF_freeBodyTable(IFF_BodyTable *table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
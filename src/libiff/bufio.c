@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bufio.h"
+#include <stdlib.h>
+#include <string.h>
+
+int IFF_flushBufferedWriter(IFF_BufferedWriter *bufferedWriter)
+{
+    if(bufferedWriter->size > 0)
+    {
+	IFF_ULong size = bufferedWriter->size;
+	
+	bufferedWriter->size = 0;
+	return IFF_writeData(bufferedWriter->writer, bufferedWriter->buffer, size);
+    }
+    else
+	return TRUE;
+}
+
+static int IFF_bufferedWrite(IFF_Writer *writer, const void *data, IFF_ULong size)
+{
+    IFF_BufferedWriter *bufferedWriter = (IFF_BufferedWriter*)writer;
+    
+    if(size > bufferedWriter->capacity - bufferedWriter->size)
+    {
+	if(!IFF_flushBufferedWriter(bufferedWriter))
+	    return FALSE;
+	
+	/* Large blocks are not worth copying, so forward them directly */
+	if(size >= bufferedWriter->capacity)
+	    return IFF_writeData(bufferedWriter->writer, data, size);
+    }
+    
+    memcpy(bufferedWriter->buffer + bufferedWriter->size, data, size);
+    bufferedWriter->size += size;
+    
+    return TRUE;
+}
+
+static long IFF_bufferedTell(IFF_Writer *writer)
+{
+    IFF_BufferedWriter *bufferedWriter = (IFF_BufferedWriter*)writer;
+    long offset = IFF_tellWriter(bufferedWriter->writer);
+    
+    if(offset < 0)
+	return -1;
+    else
+	return offset + bufferedWriter->size;
+}
+
+static int IFF_bufferedSeek(IFF_Writer *writer, long offset)
+{
+    IFF_BufferedWriter *bufferedWriter = (IFF_BufferedWriter*)writer;
+    
+    if(!IFF_flushBufferedWriter(bufferedWriter))
+	return FALSE;
+    else
+	return IFF_seekWriter(bufferedWriter->writer, offset);
+}
+
+static int IFF_bufferedCopyFile(IFF_Writer *writer, FILE *source, long offset, IFF_ULong size)
+{
+    IFF_BufferedWriter *bufferedWriter = (IFF_BufferedWriter*)writer;
+    
+    if(!IFF_flushBufferedWriter(bufferedWriter))
+	return FALSE;
+    else
+	return IFF_writeFileData(bufferedWriter->writer, source, offset, size);
+}
+
+static const struct IFF_WriterCallbacks bufferedWriterCallbacks =
+{
+    &IFF_bufferedWrite,
+    &IFF_bufferedTell,
+    &IFF_bufferedSeek,
+    NULL,
+    NULL,
+    NULL,
+    &IFF_bufferedCopyFile
+};
+
+int IFF_initBufferedWriter(IFF_BufferedWriter *bufferedWriter, IFF_Writer *writer, const IFF_ULong capacity)
+{
+    bufferedWriter->base.callbacks = &bufferedWriterCallbacks;
+    bufferedWriter->writer = writer;
+    bufferedWriter->buffer = (IFF_UByte*)malloc(capacity);
+    bufferedWriter->size = 0;
+    bufferedWriter->capacity = capacity;
+    
+    return (bufferedWriter->buffer != NULL);
+}
+
+int IFF_cleanupBufferedWriter(IFF_BufferedWriter *bufferedWriter)
+{
+    int status = IFF_flushBufferedWriter(bufferedWriter);
+    
+    free(bufferedWriter->buffer);
+    bufferedWriter->buffer = NULL;
+    bufferedWriter->capacity = 0;
+    
+    return status;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_BUFIO_H
+#define __IFF_BUFIO_H
+
+#include "ifftypes.h"
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Default capacity of the buffer of a buffered writer in bytes */
+#define IFF_DEFAULT_BUFFER_CAPACITY 65536
+
+/**
+ * @brief A writer that collects small writes, such as chunk headers and padding
+ * bytes, in a buffer and forwards them to another writer in large blocks. Writes
+ * that do not fit in the buffer are forwarded directly without being copied.
+ */
+typedef struct
+{
+    /** Writer base, so that a buffered writer can be used as an IFF_Writer */
+    IFF_Writer base;
+    
+    /** Writer to which the buffered data is forwarded */
+    IFF_Writer *writer;
+    
+    /** Buffer in which the data is collected */
+    IFF_UByte *buffer;
+    
+    /** Amount of bytes that are currently in the buffer */
+    IFF_ULong size;
+    
+    /** Capacity of the buffer in bytes */
+    IFF_ULong capacity;
+}
+IFF_BufferedWriter;
+
+/**
+ * Initializes a buffered writer that forwards its data to the given writer.
+ * The buffered writer is seekable if the given writer is seekable.
+ *
+ * @param bufferedWriter A buffered writer instance
+ * @param writer Writer to which the buffered data is forwarded
+ * @param capacity Capacity of the buffer in bytes
+ * @return TRUE if the buffer has been successfully allocated, else FALSE
+ */
+int IFF_initBufferedWriter(IFF_BufferedWriter *bufferedWriter, IFF_Writer *writer, const IFF_ULong capacity);
+
+/**
+ * Forwards the data that is currently in the buffer to the underlying writer.
+ *
+ * @param bufferedWriter A buffered writer instance
+ * @return TRUE if the data has been successfully written, else FALSE
+ */
+int IFF_flushBufferedWriter(IFF_BufferedWriter *bufferedWriter);
+
+/**
+ * Flushes the remaining data of a buffered writer and frees its buffer.
+ *
+ * @param bufferedWriter A buffered writer instance
+ * @return TRUE if the remaining data has been successfully written, else FALSE
+ */
+int IFF_cleanupBufferedWriter(IFF_BufferedWriter *bufferedWriter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -38,9 +38,14 @@ void IFF_addToCAT(IFF_CAT *cat, IFF_Chunk *chunk)
     IFF_addToGroup((IFF_Group*)cat, chunk);
 }
 
+int IFF_removeFromCAT(IFF_CAT *cat, IFF_Chunk *chunk)
+{
+    return IFF_removeFromGroup((IFF_Group*)cat, chunk);
+}
+
 IFF_CAT *IFF_readCAT(IFF_Reader *file, const IFF_Long chunkSize, const IFF_Extension *extension, const unsigned int extensionLength)
 {
-    return (IFF_CAT*)IFF_readGroup(file, CAT_CHUNKID, chunkSize, CAT_GROUPTYPENAME, FALSE, extension, extensionLength);
+    return (IFF_CAT*)IFF_readCheckedGroup(file, CAT_CHUNKID, chunkSize, CAT_GROUPTYPENAME, FALSE, &IFF_checkId, &IFF_checkCATSubChunk, extension, extensionLength);
 }
 
 int IFF_writeCAT(IFF_Writer *file, const IFF_CAT *cat, const IFF_Extension *extension, const unsigned int extensionLength)
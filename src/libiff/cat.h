@@ -71,13 +71,23 @@ IFF_CAT *IFF_createCAT(const char *contentsType);
 
 /**
  * Adds a chunk to the body of the given CAT. This function also increments the
- * chunk size and chunk length counter.
+ * chunk size of the CAT and its ancestors and the chunk length counter.
  *
  * @param cat An instance of a CAT struct
  * @param chunk A FORM, CAT or LIST chunk
  */
 void IFF_addToCAT(IFF_CAT *cat, IFF_Chunk *chunk);
 
+/**
+ * Removes a chunk from the body of the given CAT, without freeing it. This function
+ * also decrements the chunk size and chunk length counter.
+ *
+ * @param cat An instance of a CAT struct
+ * @param chunk A sub chunk of the CAT
+ * @return TRUE if the chunk has been removed, FALSE if it is not a sub chunk of the CAT
+ */
+int IFF_removeFromCAT(IFF_CAT *cat, IFF_Chunk *chunk);
+
 /**
  * Reads a concatenation chunk and its sub chunks from a file. The resulting chunk must be
  * freed by using IFF_free().
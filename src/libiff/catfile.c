@@ -0,0 +1,715 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "catfile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "cat.h"
+#include "iff.h"
+#include "id.h"
+#include "io.h"
+#include "error.h"
+#include "fileio.h"
+#include "gatherio.h"
+#include "memio.h"
+
+#if HAVE_PTHREAD_H == 1
+#include <pthread.h>
+#endif
+
+#define HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long))
+#define CAT_HEADER_SIZE (HEADER_SIZE + IFF_ID_SIZE)
+
+/** Largest chunk size that can be stored in a chunk header */
+#define MAX_CHUNK_SIZE 0x7fffffffL
+
+/**
+ * Reads the header of the CAT chunk at the beginning of the given file.
+ */
+static int readCATHeader(FILE *file, IFF_CAT *cat)
+{
+    IFF_FileReader reader;
+    
+    IFF_initFileReader(&reader, file);
+    
+    if(!IFF_readId(&reader.base, cat->chunkId, "CAT ", "chunkId") ||
+	!IFF_readLong(&reader.base, &cat->chunkSize, cat->chunkId, "chunkSize"))
+	return FALSE;
+    
+    if(IFF_compareId(cat->chunkId, "CAT ") != 0)
+    {
+	IFF_error("ERROR: the main chunk is not a CAT chunk!\n");
+	return FALSE;
+    }
+    
+    if(cat->chunkSize < IFF_ID_SIZE)
+    {
+	IFF_error("Invalid chunk size: %d of chunk: 'CAT '\n", cat->chunkSize);
+	return FALSE;
+    }
+    
+    return IFF_readId(&reader.base, cat->contentsType, cat->chunkId, "contentsType");
+}
+
+/**
+ * Opens an existing CAT file for appending and reads the header of the CAT chunk.
+ * The file must end behind the last sub chunk of the CAT.
+ */
+static FILE *openCATFile(const char *filename, IFF_CAT *cat)
+{
+    FILE *file = fopen(filename, "r+b");
+    long fileSize, end;
+    
+    if(file == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	return NULL;
+    }
+    
+    if(!readCATHeader(file, cat))
+    {
+	fclose(file);
+	return NULL;
+    }
+    
+    if(fseek(file, 0, SEEK_END) != 0 || (fileSize = ftell(file)) < 0)
+    {
+	IFF_error("ERROR: cannot determine the size of file: %s\n", filename);
+	fclose(file);
+	return NULL;
+    }
+    
+    end = HEADER_SIZE + cat->chunkSize;
+    
+    if(fileSize != end && fileSize != end + cat->chunkSize % 2)
+    {
+	IFF_error("ERROR: the size of file: %s does not match the size of the CAT chunk!\n", filename);
+	fclose(file);
+	return NULL;
+    }
+    
+    return file;
+}
+
+int IFF_appendToCATFile(const char *filename, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    FILE *file;
+    IFF_CAT cat; /* Only the header members are used */
+    IFF_GatherWriter writer;
+    long chunkSize;
+    int status;
+    
+    if((file = openCATFile(filename, &cat)) == NULL)
+	return FALSE;
+    
+    if(!IFF_checkCATSubChunk((IFF_Group*)&cat, chunk))
+    {
+	fclose(file);
+	return FALSE;
+    }
+    
+    chunkSize = IFF_incrementChunkSize(cat.chunkSize + cat.chunkSize % 2, chunk);
+    
+    if(chunkSize > MAX_CHUNK_SIZE)
+    {
+	IFF_error("ERROR: the CAT chunk cannot grow any further!\n");
+	fclose(file);
+	return FALSE;
+    }
+    
+    if(!IFF_initGatherWriter(&writer, file))
+    {
+	IFF_error("ERROR: cannot write file: %s\n", filename);
+	fclose(file);
+	return FALSE;
+    }
+    
+    /* Write the chunk first and update the size afterwards, so that the CAT never includes bytes that have not been written yet */
+    status = IFF_seekWriter(&writer.base, HEADER_SIZE + cat.chunkSize) &&
+	IFF_writePaddingByte(&writer.base, cat.chunkSize, cat.chunkId) &&
+	IFF_writeChunk(&writer.base, chunk, NULL, extension, extensionLength) &&
+	IFF_writePaddingByte(&writer.base, chunk->chunkSize, chunk->chunkId) &&
+	IFF_seekWriter(&writer.base, IFF_ID_SIZE) &&
+	IFF_writeLong(&writer.base, chunkSize, cat.chunkId, "chunkSize");
+    
+    if(!IFF_cleanupGatherWriter(&writer))
+	status = FALSE;
+    
+    if(fclose(file) != 0)
+	status = FALSE;
+    
+    if(!status)
+	IFF_error("ERROR: cannot append to file: %s\n", filename);
+    
+    return status;
+}
+
+struct IFF_CATTail
+{
+    FILE *file;
+    const IFF_Extension *extension;
+    unsigned int extensionLength;
+    
+    /* Header of the CAT chunk, of which only the contents type is used */
+    IFF_CAT cat;
+    
+    /* Indicates whether the header of the CAT chunk has been read */
+    int headerRead;
+    
+    /* Offset of the next sub chunk to consume */
+    long offset;
+};
+
+IFF_CATTail *IFF_openCATTail(const char *filename, const long offset, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_CATTail *tail;
+    FILE *file = fopen(filename, "rb");
+    
+    if(file == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	return NULL;
+    }
+    
+    tail = (IFF_CATTail*)malloc(sizeof(IFF_CATTail));
+    
+    if(tail == NULL)
+    {
+	fclose(file);
+	return NULL;
+    }
+    
+    tail->file = file;
+    tail->extension = extension;
+    tail->extensionLength = extensionLength;
+    tail->headerRead = FALSE;
+    
+    if(offset < (long)CAT_HEADER_SIZE)
+	tail->offset = CAT_HEADER_SIZE;
+    else
+	tail->offset = offset;
+    
+    return tail;
+}
+
+int IFF_readCATTail(IFF_CATTail *tail, IFF_Chunk **chunk)
+{
+    IFF_UByte header[HEADER_SIZE];
+    IFF_ULong chunkSize;
+    long fileSize;
+    
+    *chunk = NULL;
+    
+    /* The amount of bytes that have been written so far determines what can be consumed */
+    if(fseek(tail->file, 0, SEEK_END) != 0 || (fileSize = ftell(tail->file)) < 0)
+	return FALSE;
+    
+    if(!tail->headerRead)
+    {
+	if(fileSize < (long)CAT_HEADER_SIZE)
+	    return TRUE;
+	
+	if(fseek(tail->file, 0, SEEK_SET) != 0 || !readCATHeader(tail->file, &tail->cat))
+	    return FALSE;
+	
+	tail->headerRead = TRUE;
+    }
+    
+    /* Check whether the header of the next sub chunk is complete */
+    if(fileSize - tail->offset < (long)HEADER_SIZE)
+	return TRUE;
+    
+    if(fseek(tail->file, tail->offset, SEEK_SET) != 0 ||
+	fread(header, sizeof(IFF_UByte), HEADER_SIZE, tail->file) != HEADER_SIZE)
+	return FALSE;
+    
+    chunkSize = (IFF_ULong)header[4] << 24 | (IFF_ULong)header[5] << 16 | (IFF_ULong)header[6] << 8 | (IFF_ULong)header[7];
+    
+    if((IFF_Long)chunkSize < 0)
+    {
+	IFF_error("Invalid chunk size: %d of a sub chunk of the CAT at offset: %ld\n", (IFF_Long)chunkSize, tail->offset);
+	return FALSE;
+    }
+    
+    /* Check whether the body, including the padding byte, is complete */
+    if((IFF_ULong)(fileSize - tail->offset - HEADER_SIZE) < chunkSize + chunkSize % 2)
+	return TRUE;
+    else
+    {
+	IFF_FileReader reader;
+	
+	if(fseek(tail->file, tail->offset, SEEK_SET) != 0)
+	    return FALSE;
+	
+	IFF_initFileReader(&reader, tail->file);
+	*chunk = IFF_readChunk(&reader.base, NULL, tail->extension, tail->extensionLength);
+	
+	if(*chunk == NULL)
+	    return FALSE;
+	
+	if(!IFF_checkCATSubChunk((IFF_Group*)&tail->cat, *chunk))
+	{
+	    IFF_free(*chunk, tail->extension, tail->extensionLength);
+	    *chunk = NULL;
+	    return FALSE;
+	}
+	
+	tail->offset += HEADER_SIZE + chunkSize + chunkSize % 2;
+	return TRUE;
+    }
+}
+
+long IFF_getCATTailOffset(const IFF_CATTail *tail)
+{
+    return tail->offset;
+}
+
+void IFF_closeCATTail(IFF_CATTail *tail)
+{
+    fclose(tail->file);
+    free(tail);
+}
+
+/**
+ * @brief A serialized chunk that waits in the queue of a CAT appender
+ */
+typedef struct IFF_CATAppenderNode
+{
+    struct IFF_CATAppenderNode *next;
+    
+    /* Serialized chunk, including its padding byte */
+    IFF_UByte *data;
+    IFF_ULong size;
+}
+IFF_CATAppenderNode;
+
+struct IFF_CATAppender
+{
+    FILE *file;
+    IFF_GatherWriter writer;
+    
+    /* Header of the CAT chunk. The chunk size includes all chunks that have been written so far */
+    IFF_CAT cat;
+    
+    /* Stack of submitted chunks in reverse order. Producers push onto it, while the writer takes all of them at once */
+    IFF_CATAppenderNode *volatile head;
+    
+    /* Becomes FALSE as soon as writing fails */
+    int status;
+    
+#if HAVE_PTHREAD_H == 1
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    
+    /* Signalled when there is work for the writer thread */
+    pthread_cond_t workCondition;
+    
+    /* Signalled when the writer thread has completed a flush */
+    pthread_cond_t flushCondition;
+    
+    unsigned long flushRequests;
+    unsigned long flushesDone;
+    int closing;
+#endif
+};
+
+/**
+ * Pushes a node onto the stack of submitted chunks.
+ *
+ * @return TRUE if the stack was empty, else FALSE
+ */
+static int pushNode(IFF_CATAppender *appender, IFF_CATAppenderNode *node)
+{
+    /* The node may be taken by the writer as soon as it has been pushed, so only the local copy of the previous head is used afterwards */
+    IFF_CATAppenderNode *head;
+    
+#if HAVE_SYNC_BUILTINS == 1
+    IFF_CATAppenderNode *expected = NULL;
+    
+    while(TRUE)
+    {
+	node->next = expected;
+	head = __sync_val_compare_and_swap(&appender->head, expected, node);
+	
+	if(head == expected)
+	    break;
+	else
+	    expected = head;
+    }
+#else
+#if HAVE_PTHREAD_H == 1
+    pthread_mutex_lock(&appender->mutex);
+#endif
+    head = appender->head;
+    node->next = head;
+    appender->head = node;
+#if HAVE_PTHREAD_H == 1
+    pthread_mutex_unlock(&appender->mutex);
+#endif
+#endif
+    return (head == NULL);
+}
+
+/**
+ * Takes all submitted chunks from the stack, in the order in which they have been submitted.
+ */
+static IFF_CATAppenderNode *takeNodes(IFF_CATAppender *appender)
+{
+    IFF_CATAppenderNode *node, *batch = NULL;
+    
+#if HAVE_SYNC_BUILTINS == 1
+    node = __sync_lock_test_and_set(&appender->head, NULL);
+#else
+#if HAVE_PTHREAD_H == 1
+    pthread_mutex_lock(&appender->mutex);
+#endif
+    node = appender->head;
+    appender->head = NULL;
+#if HAVE_PTHREAD_H == 1
+    pthread_mutex_unlock(&appender->mutex);
+#endif
+#endif
+    
+    /* Reverse the stack */
+    while(node != NULL)
+    {
+	IFF_CATAppenderNode *next = node->next;
+	node->next = batch;
+	batch = node;
+	node = next;
+    }
+    
+    return batch;
+}
+
+#if HAVE_PTHREAD_H == 1
+static int hasNodes(IFF_CATAppender *appender)
+{
+#if HAVE_SYNC_BUILTINS == 1
+    return (__sync_val_compare_and_swap(&appender->head, NULL, NULL) != NULL);
+#else
+    return (appender->head != NULL); /* The caller holds the mutex */
+#endif
+}
+#endif
+
+static void freeNodes(IFF_CATAppenderNode *node)
+{
+    while(node != NULL)
+    {
+	IFF_CATAppenderNode *next = node->next;
+	free(node->data);
+	free(node);
+	node = next;
+    }
+}
+
+/**
+ * Writes a batch of serialized chunks behind the last sub chunk of the CAT in as few system calls as possible.
+ */
+static int writeNodes(IFF_CATAppender *appender, IFF_CATAppenderNode *batch)
+{
+    IFF_CATAppenderNode *node;
+    int status = IFF_seekWriter(&appender->writer.base, HEADER_SIZE + appender->cat.chunkSize) &&
+	IFF_writePaddingByte(&appender->writer.base, appender->cat.chunkSize, appender->cat.chunkId);
+    
+    appender->cat.chunkSize += appender->cat.chunkSize % 2;
+    
+    for(node = batch; status && node != NULL; node = node->next)
+    {
+	if(appender->cat.chunkSize + (long)node->size > MAX_CHUNK_SIZE)
+	{
+	    IFF_error("ERROR: the CAT chunk cannot grow any further!\n");
+	    status = FALSE;
+	}
+	else
+	{
+	    status = IFF_writeDataRef(&appender->writer.base, node->data, node->size);
+	    appender->cat.chunkSize += node->size;
+	}
+    }
+    
+    /* The referenced data must be written before the nodes can be freed */
+    if(!IFF_flushGatherWriter(&appender->writer))
+	status = FALSE;
+    
+    freeNodes(batch);
+    
+    return status;
+}
+
+static int writeCATSize(IFF_CATAppender *appender)
+{
+    return (IFF_seekWriter(&appender->writer.base, IFF_ID_SIZE) &&
+	IFF_writeLong(&appender->writer.base, appender->cat.chunkSize, appender->cat.chunkId, "chunkSize") &&
+	IFF_flushGatherWriter(&appender->writer));
+}
+
+#if HAVE_PTHREAD_H == 1
+
+static void *runAppender(void *data)
+{
+    IFF_CATAppender *appender = (IFF_CATAppender*)data;
+    
+    pthread_mutex_lock(&appender->mutex);
+    
+    while(TRUE)
+    {
+	/* Chunks submitted before a flush request are guaranteed to be taken after reading the request */
+	unsigned long flushRequests = appender->flushRequests;
+	int closing = appender->closing;
+	IFF_CATAppenderNode *batch;
+	int status = TRUE;
+	
+	pthread_mutex_unlock(&appender->mutex);
+	
+	batch = takeNodes(appender);
+	
+	if(batch != NULL)
+	    status = writeNodes(appender, batch);
+	
+	if(flushRequests != appender->flushesDone)
+	    status = writeCATSize(appender) && status;
+	
+	pthread_mutex_lock(&appender->mutex);
+	
+	if(!status)
+	    appender->status = FALSE;
+	
+	if(flushRequests != appender->flushesDone)
+	{
+	    appender->flushesDone = flushRequests;
+	    pthread_cond_broadcast(&appender->flushCondition);
+	}
+	
+	if(batch == NULL)
+	{
+	    if(closing)
+		break;
+	    else if(!hasNodes(appender) && appender->flushRequests == flushRequests && !appender->closing)
+		pthread_cond_wait(&appender->workCondition, &appender->mutex);
+	}
+    }
+    
+    pthread_mutex_unlock(&appender->mutex);
+    
+    return NULL;
+}
+
+#endif
+
+/**
+ * Creates a file consisting of an empty CAT chunk.
+ */
+static FILE *createCATFile(const char *filename, IFF_CAT *cat, const char *contentsType)
+{
+    FILE *file = fopen(filename, "w+b");
+    IFF_FileWriter writer;
+    
+    if(file == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	return NULL;
+    }
+    
+    IFF_createId(cat->chunkId, "CAT ");
+    cat->chunkSize = IFF_ID_SIZE;
+    IFF_createId(cat->contentsType, contentsType);
+    
+    IFF_initFileWriter(&writer, file);
+    
+    if(!IFF_writeChunkHeader(&writer.base, cat->chunkId, cat->chunkSize) ||
+	!IFF_writeId(&writer.base, cat->contentsType, cat->chunkId, "contentsType"))
+    {
+	fclose(file);
+	return NULL;
+    }
+    
+    return file;
+}
+
+IFF_CATAppender *IFF_openCATAppender(const char *filename, const char *contentsType)
+{
+    IFF_CATAppender *appender = (IFF_CATAppender*)malloc(sizeof(IFF_CATAppender));
+    FILE *file;
+    
+    if(appender == NULL)
+	return NULL;
+    
+    /* Append to an existing file, or create a new one */
+    file = fopen(filename, "rb");
+    
+    if(file == NULL)
+	file = createCATFile(filename, &appender->cat, contentsType);
+    else
+    {
+	fclose(file);
+	file = openCATFile(filename, &appender->cat);
+    }
+    
+    if(file == NULL)
+    {
+	free(appender);
+	return NULL;
+    }
+    
+    if(!IFF_initGatherWriter(&appender->writer, file))
+    {
+	IFF_error("ERROR: cannot write file: %s\n", filename);
+	fclose(file);
+	free(appender);
+	return NULL;
+    }
+    
+    appender->file = file;
+    appender->head = NULL;
+    appender->status = TRUE;
+    
+#if HAVE_PTHREAD_H == 1
+    appender->flushRequests = 0;
+    appender->flushesDone = 0;
+    appender->closing = FALSE;
+    
+    pthread_mutex_init(&appender->mutex, NULL);
+    pthread_cond_init(&appender->workCondition, NULL);
+    pthread_cond_init(&appender->flushCondition, NULL);
+    
+    if(pthread_create(&appender->thread, NULL, &runAppender, appender) != 0)
+    {
+	IFF_error("ERROR: cannot create writer thread!\n");
+	pthread_cond_destroy(&appender->flushCondition);
+	pthread_cond_destroy(&appender->workCondition);
+	pthread_mutex_destroy(&appender->mutex);
+	IFF_cleanupGatherWriter(&appender->writer);
+	fclose(file);
+	free(appender);
+	return NULL;
+    }
+#endif
+    
+    return appender;
+}
+
+int IFF_submitToCATAppender(IFF_CATAppender *appender, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_MemoryWriter writer;
+    IFF_CATAppenderNode *node;
+    
+    if(!IFF_checkCATSubChunk((IFF_Group*)&appender->cat, chunk))
+	return FALSE;
+    
+    /* Serialize the chunk on the submitting thread, so that many chunks can be serialized at the same time */
+    IFF_initMemoryWriter(&writer);
+    
+    if(!IFF_writeChunk(&writer.base, chunk, NULL, extension, extensionLength) ||
+	!IFF_writePaddingByte(&writer.base, chunk->chunkSize, chunk->chunkId) ||
+	(node = (IFF_CATAppenderNode*)malloc(sizeof(IFF_CATAppenderNode))) == NULL)
+    {
+	IFF_cleanupMemoryWriter(&writer);
+	return FALSE;
+    }
+    
+    /* The node takes ownership of the serialized data */
+    node->data = writer.data;
+    node->size = writer.size;
+    
+#if HAVE_PTHREAD_H == 1
+    /* Only wake up the writer thread if it may be waiting for work */
+    if(pushNode(appender, node))
+    {
+	pthread_mutex_lock(&appender->mutex);
+	pthread_cond_signal(&appender->workCondition);
+	pthread_mutex_unlock(&appender->mutex);
+    }
+    
+    return TRUE;
+#else
+    pushNode(appender, node);
+    
+    if(!writeNodes(appender, takeNodes(appender)))
+	appender->status = FALSE;
+    
+    return appender->status;
+#endif
+}
+
+int IFF_flushCATAppender(IFF_CATAppender *appender)
+{
+    int status;
+    
+#if HAVE_PTHREAD_H == 1
+    unsigned long flushRequest;
+    
+    pthread_mutex_lock(&appender->mutex);
+    
+    flushRequest = ++appender->flushRequests;
+    pthread_cond_signal(&appender->workCondition);
+    
+    while(appender->flushesDone < flushRequest)
+	pthread_cond_wait(&appender->flushCondition, &appender->mutex);
+    
+    status = appender->status;
+    
+    pthread_mutex_unlock(&appender->mutex);
+#else
+    if(!writeCATSize(appender))
+	appender->status = FALSE;
+    
+    status = appender->status;
+#endif
+    
+    return status;
+}
+
+int IFF_closeCATAppender(IFF_CATAppender *appender)
+{
+    int status;
+    
+#if HAVE_PTHREAD_H == 1
+    /* Let the writer thread write the remaining chunks and the size, and wait until it has finished */
+    pthread_mutex_lock(&appender->mutex);
+    appender->flushRequests++;
+    appender->closing = TRUE;
+    pthread_cond_signal(&appender->workCondition);
+    pthread_mutex_unlock(&appender->mutex);
+    
+    pthread_join(appender->thread, NULL);
+    
+    pthread_cond_destroy(&appender->flushCondition);
+    pthread_cond_destroy(&appender->workCondition);
+    pthread_mutex_destroy(&appender->mutex);
+#else
+    if(!writeCATSize(appender))
+	appender->status = FALSE;
+#endif
+    
+    status = appender->status;
+    
+    if(!IFF_cleanupGatherWriter(&appender->writer))
+	status = FALSE;
+    
+    if(fclose(appender->file) != 0)
+	status = FALSE;
+    
+    free(appender);
+    
+    return status;
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_CATFILE_H
+#define __IFF_CATFILE_H
+
+typedef struct IFF_CATTail IFF_CATTail;
+typedef struct IFF_CATAppender IFF_CATAppender;
+
+#include "ifftypes.h"
+#include "chunk.h"
+#include "extension.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Appends a chunk to the CAT chunk that forms the given file, without reading
+ * the existing sub chunks. The chunk is written behind the last sub chunk,
+ * and only the size field of the CAT chunk is updated afterwards, so that the
+ * time it takes does not depend on the size of the file. A reader that
+ * examines the file in the meantime sees the CAT without the new chunk.
+ *
+ * The file must consist of exactly one CAT chunk, and the appended chunk must be
+ * allowed in it, i.e. it must be a FORM, LIST or CAT that matches the contents
+ * type of the CAT.
+ *
+ * @param filename Filename of an IFF file consisting of a CAT chunk
+ * @param chunk A FORM, LIST or CAT chunk hierarchy to append
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the chunk has been successfully appended, else FALSE
+ */
+int IFF_appendToCATFile(const char *filename, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Opens a CAT file that may still be growing, so that its sub chunks can be
+ * consumed as soon as they have been completely written, similar to tail -f.
+ * The resulting tail must be closed using IFF_closeCATTail().
+ *
+ * @param filename Filename of an IFF file consisting of a CAT chunk
+ * @param offset Offset of the first sub chunk to consume, which can be obtained with IFF_getCATTailOffset() to resume a previous session. Offsets inside the CAT header start at the first sub chunk.
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return A tail of the CAT file, or NULL if the file cannot be opened
+ */
+IFF_CATTail *IFF_openCATTail(const char *filename, const long offset, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Reads the next sub chunk of a growing CAT file, if it has been completely
+ * written. Sub chunks are recognised by the size of the file, so that the size
+ * of the CAT chunk itself may lag behind, for example if the writer only updates
+ * it now and then. If no new sub chunk is available, the function returns
+ * immediately and it can be invoked again later.
+ *
+ * @param tail A tail of a CAT file
+ * @param chunk Contains the next sub chunk, which must be freed using IFF_free(), or NULL if no new sub chunk is available yet
+ * @return TRUE if the file could be examined, else FALSE if it is not a valid CAT file or cannot be read
+ */
+int IFF_readCATTail(IFF_CATTail *tail, IFF_Chunk **chunk);
+
+/**
+ * Returns the offset in the file behind the last sub chunk that has been consumed.
+ *
+ * @param tail A tail of a CAT file
+ * @return The offset of the next sub chunk
+ */
+long IFF_getCATTailOffset(const IFF_CATTail *tail);
+
+/**
+ * Closes the file of the given tail and frees it from memory.
+ *
+ * @param tail A tail of a CAT file
+ */
+void IFF_closeCATTail(IFF_CATTail *tail);
+
+/**
+ * Opens a CAT file to which many threads can append sub chunks concurrently.
+ * Submitted chunks are serialized by the submitting thread and handed over to a
+ * single writer thread through a lock-free queue. The writer thread writes them
+ * to the file in batches. The size of the CAT chunk is only updated when the
+ * appender is flushed or closed. On systems without POSIX threads, submitted
+ * chunks are written immediately. The resulting appender must be closed using
+ * IFF_closeCATAppender().
+ *
+ * @param filename Filename of an IFF file consisting of a CAT chunk. If the file does not exist, it is created.
+ * @param contentsType Contents type of the CAT chunk, if the file is created
+ * @return A CAT appender, or NULL if the file cannot be opened
+ */
+IFF_CATAppender *IFF_openCATAppender(const char *filename, const char *contentsType);
+
+/**
+ * Submits a chunk that must be appended to the CAT file. This function may be
+ * invoked by many threads at the same time. The chunk is serialized before the
+ * function returns, so the caller may free or modify it afterwards.
+ *
+ * @param appender A CAT appender
+ * @param chunk A FORM, LIST or CAT chunk hierarchy to append
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the chunk has been successfully submitted, else FALSE
+ */
+int IFF_submitToCATAppender(IFF_CATAppender *appender, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Waits until all chunks that have been submitted before have been written and
+ * updates the size of the CAT chunk accordingly.
+ *
+ * @param appender A CAT appender
+ * @return TRUE if all chunks have been successfully written so far, else FALSE
+ */
+int IFF_flushCATAppender(IFF_CATAppender *appender);
+
+/**
+ * Writes all submitted chunks, updates the size of the CAT chunk, closes the
+ * file and frees the appender from memory. No chunks may be submitted while
+ * the appender is being closed.
+ *
+ * @param appender A CAT appender
+ * @return TRUE if all chunks have been successfully written, else FALSE
+ */
+int IFF_closeCATAppender(IFF_CATAppender *appender);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
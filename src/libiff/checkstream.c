@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "checkstream.h"
+#include <stdlib.h>
+#include <string.h>
+#include "id.h"
+#include "form.h"
+#include "chunk.h"
+#include "fileio.h"
+#include "memio.h"
+#include "error.h"
+#include "scanner.h"
+
+#define HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long))
+
+/**
+ * @brief Keeps track of the position and the extensions while a file is checked.
+ */
+typedef struct
+{
+    /** Scanner from which the file is read */
+    IFF_Scanner scanner;
+    
+    const IFF_Extension *extension;
+    unsigned int extensionLength;
+}
+StreamChecker;
+
+/**
+ * Reads the body of a data chunk into memory and lets the extension check it.
+ */
+static int checkExtensionChunk(StreamChecker *checker, const IFF_FormExtension *formExtension, const char *formType, const IFF_ID chunkId, const IFF_Long chunkSize)
+{
+    IFF_ULong paddedSize = chunkSize + (chunkSize % 2 != 0 ? 1 : 0);
+    IFF_UByte *body;
+    IFF_MemoryReader memoryReader;
+    IFF_Chunk *chunk;
+    int status;
+    
+    /* The chunk size comes from the file, so we don't allocate memory for a body that the file can't contain */
+    if(!IFF_scannerHasBytes(&checker->scanner, paddedSize))
+    {
+	IFF_error("Chunk size: %d of chunk: '", chunkSize);
+	IFF_errorId(chunkId);
+	IFF_error("' exceeds the remaining size of the file!\n");
+	return FALSE;
+    }
+    
+    if((body = (IFF_UByte*)malloc(paddedSize > 0 ? paddedSize : 1)) == NULL)
+    {
+	IFF_error("Cannot allocate memory for the body of chunk: '");
+	IFF_errorId(chunkId);
+	IFF_error("'\n");
+	return FALSE;
+    }
+    
+    if(!IFF_scanBytes(&checker->scanner, body, paddedSize))
+    {
+	IFF_readError(chunkId, "body");
+	free(body);
+	return FALSE;
+    }
+    
+    IFF_initMemoryReader(&memoryReader, body, paddedSize);
+    
+    if((chunk = IFF_readExtensionChunk(formExtension, &memoryReader.base, chunkSize)) == NULL)
+	status = FALSE;
+    else
+    {
+	status = IFF_checkExtensionChunk(formExtension, chunk);
+	IFF_freeChunk(chunk, formType, checker->extension, checker->extensionLength);
+    }
+    
+    free(body);
+    return status;
+}
+
+/**
+ * Checks a chunk and its sub chunks while they are read.
+ *
+ * @param checker The state of the check
+ * @param parentChunkId Chunk ID of the group in which the chunk is located, or NULL for the main chunk
+ * @param parentGroupType Group type of the group in which the chunk is located, or NULL for the main chunk
+ * @param size Is set to the amount of bytes that the chunk occupies in its group, including the header and padding byte
+ * @return TRUE if the chunk is valid, else FALSE
+ */
+static int checkChunk(StreamChecker *checker, const IFF_ID parentChunkId, const IFF_ID parentGroupType, IFF_Long *size)
+{
+    IFF_UByte header[HEADER_SIZE];
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+    
+    if(!IFF_scanBytes(&checker->scanner, header, HEADER_SIZE))
+    {
+	IFF_error("Error reading chunk header!\n");
+	return FALSE;
+    }
+    
+    memcpy(chunkId, header, IFF_ID_SIZE);
+    chunkSize = IFF_decodeLong(header + IFF_ID_SIZE);
+    
+    if(!IFF_checkId(chunkId) || !IFF_checkChunkPlacement(parentChunkId, chunkId))
+	return FALSE;
+    
+    if(chunkSize < 0)
+    {
+	IFF_error("Invalid chunk size: %d of chunk: '", chunkSize);
+	IFF_errorId(chunkId);
+	IFF_error("'\n");
+	return FALSE;
+    }
+    
+    if(IFF_isGroupChunkId(chunkId))
+    {
+	IFF_ID groupType;
+	IFF_Long readSize = IFF_ID_SIZE;
+	
+	if(!IFF_scanBytes(&checker->scanner, groupType, IFF_ID_SIZE))
+	{
+	    IFF_readError(chunkId, "groupType");
+	    return FALSE;
+	}
+	
+	/* FORMs and PROPs have a form type, CATs and LISTs a contents type */
+	if(IFF_compareId(chunkId, "FORM") == 0 || IFF_compareId(chunkId, "PROP") == 0)
+	{
+	    if(!IFF_checkFormType(groupType))
+		return FALSE;
+	}
+	else if(!IFF_checkId(groupType))
+	    return FALSE;
+	
+	if(!IFF_checkContentsType(parentChunkId, parentGroupType, chunkId, groupType))
+	    return FALSE;
+	
+	/* Keep checking sub chunks until we have read all bytes */
+	while(readSize < chunkSize)
+	{
+	    IFF_Long subChunkSize;
+	    
+	    if(!checkChunk(checker, chunkId, groupType, &subChunkSize))
+		return FALSE;
+	    
+	    readSize += subChunkSize;
+	}
+	
+	if(readSize != chunkSize)
+	{
+	    IFF_error("Chunk size mismatch! ");
+	    IFF_errorId(chunkId);
+	    IFF_error(" size: %d, while body has: %d\n", chunkSize, readSize);
+	    return FALSE;
+	}
+    }
+    else
+    {
+	/* Only FORMs and PROPs determine the form type of their data chunks */
+	const char *formType = (IFF_compareId(parentChunkId, "FORM") == 0 || IFF_compareId(parentChunkId, "PROP") == 0) ? parentGroupType : NULL;
+	const IFF_FormExtension *formExtension = IFF_findFormExtension(formType, chunkId, checker->extension, checker->extensionLength);
+	
+	if(formExtension != NULL)
+	{
+	    if(!checkExtensionChunk(checker, formExtension, formType, chunkId, chunkSize))
+		return FALSE;
+	}
+	else if(!IFF_skipBytes(&checker->scanner, chunkSize) || (chunkSize % 2 != 0 && !IFF_skipBytes(&checker->scanner, 1))) /* Skip the body and the padding byte, if the chunk size is odd */
+	{
+	    IFF_error("Error reading raw chunk body of chunk: '");
+	    IFF_errorId(chunkId);
+	    IFF_error("'\n");
+	    return FALSE;
+	}
+    }
+    
+    *size = HEADER_SIZE + chunkSize + (chunkSize % 2 != 0 ? 1 : 0);
+    return TRUE;
+}
+
+static int checkMainChunk(StreamChecker *checker, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_Long size;
+    IFF_UByte byte;
+    
+    checker->extension = extension;
+    checker->extensionLength = extensionLength;
+    
+    if(!checkChunk(checker, NULL, NULL, &size))
+	return FALSE;
+    
+    /* We should have reached the EOF now */
+    if(IFF_scanBytes(&checker->scanner, &byte, sizeof(IFF_UByte)))
+	IFF_error("WARNING: Trailing IFF contents found: %d!\n", byte);
+    
+    return TRUE;
+}
+
+int IFF_checkStream(IFF_Reader *reader, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    StreamChecker checker;
+    
+    IFF_initScanner(&checker.scanner, reader);
+    return checkMainChunk(&checker, extension, extensionLength);
+}
+
+int IFF_checkStreamFd(FILE *file, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    StreamChecker checker;
+    
+    /* If the stream is seekable, large bodies are skipped by seeking over them */
+    if(IFF_initSeekableScanner(&checker.scanner, file))
+	return checkMainChunk(&checker, extension, extensionLength);
+    else
+    {
+	IFF_FileReader reader;
+	IFF_initFileReader(&reader, file);
+	return IFF_checkStream(&reader.base, extension, extensionLength);
+    }
+}
+
+int IFF_checkFile(const char *filename, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    int status;
+    FILE *file = fopen(filename, "rb");
+    
+    if(file == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	return FALSE;
+    }
+    
+    status = IFF_checkStreamFd(file, extension, extensionLength);
+    fclose(file);
+    
+    return status;
+}
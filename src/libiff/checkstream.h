@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_CHECKSTREAM_H
+#define __IFF_CHECKSTREAM_H
+
+#include <stdio.h>
+#include "ifftypes.h"
+#include "io.h"
+#include "extension.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Checks whether an IFF file that is read from a reader conforms to the IFF
+ * specification, without building a chunk hierarchy. The same checks as
+ * IFF_check() are applied while the file is streamed. Only the chunks for which
+ * an extension exists are read into memory to be checked by the extension.
+ * Bodies of other data chunks are read and discarded, so that the amount of
+ * memory that is used only depends on the nesting depth.
+ *
+ * @param reader A reader instance
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the file conforms to the IFF specification, else FALSE
+ */
+int IFF_checkStream(IFF_Reader *reader, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Checks whether an IFF file that is read from a file stream conforms to the IFF
+ * specification, like IFF_checkStream(). If the stream is seekable, large bodies
+ * of data chunks without extension are skipped without being read.
+ *
+ * @param file File descriptor of the file
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the file conforms to the IFF specification, else FALSE
+ */
+int IFF_checkStreamFd(FILE *file, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Checks whether the IFF file with the given filename conforms to the IFF
+ * specification, like IFF_checkStreamFd().
+ *
+ * @param filename Filename of the IFF file
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the file conforms to the IFF specification, else FALSE
+ */
+int IFF_checkFile(const char *filename, const IFF_Extension *extension, const unsigned int extensionLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -33,20 +33,137 @@
 #include "rawchunk.h"
 #include "util.h"
 #include "error.h"
+#include "chunkpool.h"
+#include "digest.h"
 
-IFF_Chunk *IFF_allocateChunk(const char *chunkId, const size_t chunkSize)
+/**
+ * Initialises a chunk in the given memory, which starts with the header that contains the chunk's metadata.
+ */
+static IFF_Chunk *initChunk(void *memory, const char *chunkId, const unsigned int flags)
 {
-    IFF_Chunk *chunk = (IFF_Chunk*)malloc(chunkSize);
+    IFF_Chunk *chunk;
+    
+    if(memory == NULL)
+	return NULL;
+    
+    chunk = (IFF_Chunk*)((char*)memory + IFF_CHUNK_META_SIZE);
     
     chunk->parent = NULL;
     IFF_createId(chunk->chunkId, chunkId);
     chunk->chunkSize = 0;
     
+    /* A newly created chunk does not originate from a file */
+    IFF_CHUNK_META(chunk)->sourceOffset = -1;
+    IFF_CHUNK_META(chunk)->sourceSize = 0;
+    IFF_CHUNK_META(chunk)->sourceId = 0;
+    IFF_CHUNK_META(chunk)->flags = IFF_CHUNK_DIRTY | flags;
+    
+    return chunk;
+}
+
+IFF_Chunk *IFF_allocateChunk(const char *chunkId, const size_t chunkSize)
+{
+    return initChunk(malloc(IFF_CHUNK_META_SIZE + chunkSize), chunkId, 0);
+}
+
+/*
+ * Compile-time check that the pooled chunk structures, including their metadata
+ * header and a raw chunk with a full inline body, fit in the largest size class
+ * of the chunk pool. The array size becomes negative, and the compilation fails,
+ * if they don't.
+ */
+typedef char IFF_PooledChunkSizeCheck[(IFF_CHUNK_META_SIZE + sizeof(IFF_Group) <= IFF_POOL_MAX_OBJECT_SIZE && IFF_CHUNK_META_SIZE + sizeof(IFF_List) <= IFF_POOL_MAX_OBJECT_SIZE && IFF_CHUNK_META_SIZE + sizeof(IFF_RawChunk) + IFF_INLINE_BODY_SIZE <= IFF_POOL_MAX_OBJECT_SIZE) ? 1 : -1];
+
+IFF_Chunk *IFF_allocatePooledChunk(const char *chunkId, const size_t chunkSize, const unsigned int flags)
+{
+    size_t size = IFF_CHUNK_META_SIZE + chunkSize;
+    unsigned int granules;
+    
+    /* Objects that don't fit in a size class are allocated separately, which leaves the pool size bits zero */
+    if(size > IFF_POOL_MAX_OBJECT_SIZE)
+	return initChunk(malloc(size), chunkId, flags);
+    
+    /* Record the size, so that the memory can be returned to the right size class */
+    granules = (size + IFF_POOL_GRANULARITY - 1) / IFF_POOL_GRANULARITY;
+    
+    return initChunk(IFF_allocateFromPool(size), chunkId, (granules << IFF_CHUNK_POOL_SIZE_SHIFT) | flags);
+}
+
+/**
+ * Caches that a chunk has passed the check with the given extension array.
+ */
+static void setValidated(IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_CHUNK_META(chunk)->flags |= IFF_CHUNK_VALIDATED;
+    IFF_CHUNK_META(chunk)->validatedExtension = extension;
+    IFF_CHUNK_META(chunk)->validatedExtensionLength = extensionLength;
+}
+
+/**
+ * Checks whether a chunk has passed the check with the given extension array
+ * and has not been modified since.
+ */
+static int isValidated(const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    return ((IFF_CHUNK_META(chunk)->flags & IFF_CHUNK_VALIDATED) &&
+	IFF_CHUNK_META(chunk)->validatedExtension == extension &&
+	IFF_CHUNK_META(chunk)->validatedExtensionLength == extensionLength);
+}
+
+/**
+ * Marks a chunk that has been checked while it was read as validated. Attaching
+ * the sub chunks to a group chunk discards their validation outcome, so it is
+ * restored for the direct sub chunks, whose own sub chunks have been restored
+ * when the sub chunks were completed.
+ */
+static void markValidated(IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    setValidated(chunk, extension, extensionLength);
+    
+    if(IFF_compareId(chunk->chunkId, "FORM") == 0 || IFF_compareId(chunk->chunkId, "CAT ") == 0 || IFF_compareId(chunk->chunkId, "LIST") == 0 || IFF_compareId(chunk->chunkId, "PROP") == 0)
+    {
+	const IFF_Group *group = (const IFF_Group*)chunk;
+	unsigned int i;
+	
+	for(i = 0; i < group->chunkLength; i++)
+	    setValidated(group->chunk[i], extension, extensionLength);
+	
+	if(IFF_compareId(chunk->chunkId, "LIST") == 0)
+	{
+	    const IFF_List *list = (const IFF_List*)chunk;
+	    
+	    for(i = 0; i < list->propLength; i++)
+		setValidated((IFF_Chunk*)list->prop[i], extension, extensionLength);
+	}
+    }
+}
+
+/**
+ * Records the origin of a chunk that has been completely read. Attaching the
+ * sub chunks while reading marks a group chunk dirty, so it is made clean again.
+ * If the chunk has been checked while reading, it is marked as validated.
+ */
+static IFF_Chunk *recordSource(const IFF_Reader *file, IFF_Chunk *chunk, const long sourceOffset, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    if(chunk != NULL)
+    {
+	IFF_CHUNK_META(chunk)->sourceOffset = sourceOffset;
+	IFF_CHUNK_META(chunk)->sourceSize = chunk->chunkSize;
+	IFF_CHUNK_META(chunk)->sourceId = file->sourceId;
+	
+	if(sourceOffset >= 0)
+	    IFF_CHUNK_META(chunk)->flags &= ~IFF_CHUNK_DIRTY;
+	
+	if(file->options & IFF_READ_CHECK)
+	    markValidated(chunk, extension, extensionLength);
+    }
+    
     return chunk;
 }
 
 IFF_Chunk *IFF_readChunk(IFF_Reader *file, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength)
 {
+    long sourceOffset = IFF_tellReader(file);
     IFF_ID chunkId;
     IFF_Long chunkSize;
     
@@ -54,6 +171,9 @@ IFF_Chunk *IFF_readChunk(IFF_Reader *file, const char *formType, const IFF_Exten
     if(!IFF_readId(file, chunkId, "", chunkId))
 	return NULL;
     
+    if((file->options & IFF_READ_CHECK) && !IFF_checkId(chunkId))
+	return NULL;
+    
     /* Read chunk size */
     if(!IFF_readLong(file, &chunkSize, chunkId, "chunkSize"))
 	return NULL;
@@ -61,30 +181,42 @@ IFF_Chunk *IFF_readChunk(IFF_Reader *file, const char *formType, const IFF_Exten
     /* Read remaining bytes (procedure depends on chunk id type) */
     
     if(IFF_compareId(chunkId, "FORM") == 0)
-	return (IFF_Chunk*)IFF_readForm(file, chunkSize, extension, extensionLength);
+	return recordSource(file, (IFF_Chunk*)IFF_readForm(file, chunkSize, extension, extensionLength), sourceOffset, extension, extensionLength);
     else if(IFF_compareId(chunkId, "CAT ") == 0)
-	return (IFF_Chunk*)IFF_readCAT(file, chunkSize, extension, extensionLength);
+	return recordSource(file, (IFF_Chunk*)IFF_readCAT(file, chunkSize, extension, extensionLength), sourceOffset, extension, extensionLength);
     else if(IFF_compareId(chunkId, "LIST") == 0)
-	return (IFF_Chunk*)IFF_readList(file, chunkSize, extension, extensionLength);
+	return recordSource(file, (IFF_Chunk*)IFF_readList(file, chunkSize, extension, extensionLength), sourceOffset, extension, extensionLength);
     else if(IFF_compareId(chunkId, "PROP") == 0)
-	return (IFF_Chunk*)IFF_readProp(file, chunkSize, extension, extensionLength);
+	return recordSource(file, (IFF_Chunk*)IFF_readProp(file, chunkSize, extension, extensionLength), sourceOffset, extension, extensionLength);
     else
     {
 	const IFF_FormExtension *formExtension = IFF_findFormExtension(formType, chunkId, extension, extensionLength);
 	
 	if(formExtension == NULL)
-	    return (IFF_Chunk*)IFF_readRawChunk(file, chunkId, chunkSize);
+	    return recordSource(file, (IFF_Chunk*)IFF_readRawChunk(file, chunkId, chunkSize), sourceOffset, extension, extensionLength);
 	else
-	    return formExtension->readChunk(file, chunkSize);
+	{
+	    IFF_Chunk *chunk = IFF_readExtensionChunk(formExtension, file, chunkSize);
+	    
+	    if(chunk != NULL && (file->options & IFF_READ_CHECK) && !IFF_checkExtensionChunk(formExtension, chunk))
+	    {
+		IFF_freeChunk(chunk, formType, extension, extensionLength);
+		return NULL;
+	    }
+	    
+	    return recordSource(file, chunk, sourceOffset, extension, extensionLength);
+	}
     }
 }
 
 int IFF_writeChunk(IFF_Writer *file, const IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength)
 {
-    if(!IFF_writeId(file, chunk->chunkId, chunk->chunkId, "chunkId"))
-	return FALSE;
+    /* An unmodified chunk is identical to its bytes in the source file, so writers that have access to it can copy them */
+    if(file->callbacks->copyChunk != NULL && IFF_chunkIsClean(chunk) &&
+	(file->callbacks->hasChunk == NULL || file->callbacks->hasChunk(file, chunk)))
+	return file->callbacks->copyChunk(file, chunk);
     
-    if(!IFF_writeLong(file, chunk->chunkSize, chunk->chunkId, "chunkSize"))
+    if(!IFF_writeChunkHeader(file, chunk->chunkId, chunk->chunkSize))
 	return FALSE;
     
     if(IFF_compareId(chunk->chunkId, "FORM") == 0)
@@ -114,7 +246,7 @@ int IFF_writeChunk(IFF_Writer *file, const IFF_Chunk *chunk, const char *formTyp
 	if(formExtension == NULL)
 	    return IFF_writeRawChunk(file, (IFF_RawChunk*)chunk);
 	else
-	    return formExtension->writeChunk(file, chunk);
+	    return IFF_writeExtensionChunk(formExtension, file, chunk);
     }
     
     return TRUE;
@@ -141,11 +273,37 @@ int IFF_checkChunk(const IFF_Chunk *chunk, const char *formType, const IFF_Exten
 	    if(formExtension == NULL)
 		return TRUE;
 	    else
-	        return formExtension->checkChunk(chunk);
+	        return IFF_checkExtensionChunk(formExtension, chunk);
 	}
     }
 }
 
+int IFF_checkChunkCached(IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    int status;
+    
+    if(isValidated(chunk, extension, extensionLength))
+	return TRUE;
+    
+    /* While the chunk is checked, its sub chunks are checked with this function as well, see IFF_checkSubChunk() */
+    IFF_CHUNK_META(chunk)->flags |= IFF_CHUNK_CHECKING_CACHED;
+    status = IFF_checkChunk(chunk, formType, extension, extensionLength);
+    IFF_CHUNK_META(chunk)->flags &= ~IFF_CHUNK_CHECKING_CACHED;
+    
+    if(status)
+	setValidated(chunk, extension, extensionLength);
+    
+    return status;
+}
+
+int IFF_checkSubChunk(const IFF_Chunk *parent, IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    if(IFF_CHUNK_META(parent)->flags & IFF_CHUNK_CHECKING_CACHED)
+	return IFF_checkChunkCached(chunk, formType, extension, extensionLength);
+    else
+	return IFF_checkChunk(chunk, formType, extension, extensionLength);
+}
+
 void IFF_freeChunk(IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength)
 {
     /* Free nested sub chunks */
@@ -164,11 +322,14 @@ void IFF_freeChunk(IFF_Chunk *chunk, const char *formType, const IFF_Extension *
 	if(formExtension == NULL)
 	    IFF_freeRawChunk((IFF_RawChunk*)chunk);
 	else
-	    formExtension->freeChunk(chunk);
+	    IFF_freeExtensionChunk(formExtension, chunk);
     }
     
-    /* Free the chunk itself */
-    free(chunk);
+    /* Free the chunk itself, together with the metadata header in front of it */
+    if(IFF_CHUNK_META(chunk)->flags & IFF_CHUNK_POOL_SIZE_MASK)
+	IFF_releaseToPool(IFF_CHUNK_META(chunk), ((IFF_CHUNK_META(chunk)->flags & IFF_CHUNK_POOL_SIZE_MASK) >> IFF_CHUNK_POOL_SIZE_SHIFT) * IFF_POOL_GRANULARITY);
+    else
+	free(IFF_CHUNK_META(chunk));
 }
 
 void IFF_printChunk(const IFF_Chunk *chunk, const unsigned int indentLevel, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength)
@@ -194,7 +355,7 @@ void IFF_printChunk(const IFF_Chunk *chunk, const unsigned int indentLevel, cons
 	if(formExtension == NULL)
 	    IFF_printRawChunk((IFF_RawChunk*)chunk, indentLevel + 1);
 	else
-	    formExtension->printChunk(chunk, indentLevel + 1);
+	    IFF_printExtensionChunk(formExtension, chunk, indentLevel + 1);
     }
     
     IFF_printIndent(stdout, indentLevel, "}\n\n");
@@ -202,6 +363,11 @@ void IFF_printChunk(const IFF_Chunk *chunk, const unsigned int indentLevel, cons
 
 int IFF_compareChunk(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength)
 {
+    /* If the digests of both chunks are known and differ, the chunks differ. Equal digests may collide, so the contents still decide */
+    if((IFF_CHUNK_META(chunk1)->flags & IFF_CHUNK_DIGEST_VALID) && (IFF_CHUNK_META(chunk2)->flags & IFF_CHUNK_DIGEST_VALID) &&
+	!IFF_compareDigest(&IFF_CHUNK_META(chunk1)->digest, &IFF_CHUNK_META(chunk2)->digest))
+	return FALSE;
+    
     if(IFF_compareId(chunk1->chunkId, chunk2->chunkId) == 0)
     {
 	if(chunk1->chunkSize == chunk2->chunkSize)
@@ -221,7 +387,7 @@ int IFF_compareChunk(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const cha
 		if(formExtension == NULL)
 		    return IFF_compareRawChunk((const IFF_RawChunk*)chunk1, (const IFF_RawChunk*)chunk2);
 		else
-		    return formExtension->compareChunk(chunk1, chunk2);
+		    return IFF_compareExtensionChunk(formExtension, chunk1, chunk2);
 	    }
 	}
 	else
@@ -264,6 +430,11 @@ IFF_Long IFF_incrementChunkSize(const IFF_Long chunkSize, const IFF_Chunk *chunk
     return returnValue;
 }
 
+IFF_Long IFF_decrementChunkSize(const IFF_Long chunkSize, const IFF_Chunk *chunk)
+{
+    return chunkSize - (IFF_incrementChunkSize(0, chunk));
+}
+
 void IFF_updateChunkSizes(IFF_Chunk *chunk)
 {
     /* Check whether the given chunk is a group chunk and update the sizes */
@@ -276,7 +447,62 @@ void IFF_updateChunkSizes(IFF_Chunk *chunk)
     else if(IFF_compareId(chunk->chunkId, "LIST") == 0)
 	IFF_updateListChunkSizes((IFF_List*)chunk);
     
+    IFF_markChunkDirty(chunk);
+    
     /* If the given type has a parent, recursively update these as well */
     if(chunk->parent != NULL)
 	IFF_updateChunkSizes((IFF_Chunk*)chunk->parent);
 }
+
+/**
+ * Returns the amount of bytes that a chunk body of the given size occupies, including the padding byte.
+ */
+static IFF_Long paddedChunkSize(const IFF_Long chunkSize)
+{
+    if(chunkSize % 2 != 0)
+	return chunkSize + 1;
+    else
+	return chunkSize;
+}
+
+void IFF_setChunkSize(IFF_Chunk *chunk, const IFF_Long chunkSize)
+{
+    IFF_Long newChunkSize = chunkSize;
+    
+    IFF_markChunkDirty(chunk);
+    
+    while(chunk != NULL)
+    {
+	IFF_Long delta = paddedChunkSize(newChunkSize) - paddedChunkSize(chunk->chunkSize);
+	
+	chunk->chunkSize = newChunkSize;
+	
+	/* If the space occupied by the chunk remains the same, the ancestors do not change */
+	if(delta == 0)
+	    break;
+	
+	chunk = (IFF_Chunk*)chunk->parent;
+	
+	if(chunk != NULL)
+	    newChunkSize = chunk->chunkSize + delta;
+    }
+}
+
+void IFF_markChunkDirty(IFF_Chunk *chunk)
+{
+    /*
+     * A dirty chunk always has dirty ancestors and a chunk without a valid digest or validation outcome never has ancestors
+     * with one, so we can stop at the first one that is already dirty and has neither
+     */
+    while(chunk != NULL && (!(IFF_CHUNK_META(chunk)->flags & IFF_CHUNK_DIRTY) || (IFF_CHUNK_META(chunk)->flags & (IFF_CHUNK_DIGEST_VALID | IFF_CHUNK_VALIDATED))))
+    {
+	IFF_CHUNK_META(chunk)->flags |= IFF_CHUNK_DIRTY;
+	IFF_CHUNK_META(chunk)->flags &= ~(IFF_CHUNK_DIGEST_VALID | IFF_CHUNK_VALIDATED);
+	chunk = (IFF_Chunk*)chunk->parent;
+    }
+}
+
+int IFF_chunkIsClean(const IFF_Chunk *chunk)
+{
+    return (IFF_CHUNK_META(chunk)->sourceOffset >= 0 && !(IFF_CHUNK_META(chunk)->flags & IFF_CHUNK_DIRTY) && IFF_CHUNK_META(chunk)->sourceSize == chunk->chunkSize);
+}
@@ -26,6 +26,81 @@ typedef struct IFF_Chunk IFF_Chunk;
 
 #include <stdlib.h>
 #include "ifftypes.h"
+
+/** Flag indicating that a chunk has been modified since it was read from its source file */
+#define IFF_CHUNK_DIRTY 0x1
+
+/** Flag indicating that the body of a raw chunk is stored behind the chunk, in the same allocation */
+#define IFF_CHUNK_INLINE_STORAGE 0x2
+
+/** Flag indicating that the chunk data of a raw chunk belongs to the caller and is not freed together with the chunk */
+#define IFF_CHUNK_BORROWED_DATA 0x4
+
+/** Flag indicating that the cached digest of a chunk is valid, because the chunk has not been modified since it was computed */
+#define IFF_CHUNK_DIGEST_VALID 0x8
+
+/** Flag indicating that the chunk hierarchy has been found to conform to the IFF specification and has not been modified since */
+#define IFF_CHUNK_VALIDATED 0x10
+
+/** Flag indicating that the chunk is being checked by IFF_checkChunkCached(), so that its sub chunks are checked in the same way */
+#define IFF_CHUNK_CHECKING_CACHED 0x20
+
+/**
+ * Bits of the flags that record how much memory has been allocated for the chunk
+ * from the chunk pool, in units of IFF_POOL_GRANULARITY bytes. They are 0 if the
+ * chunk has been allocated with malloc().
+ */
+#define IFF_CHUNK_POOL_SIZE_MASK 0xff00
+#define IFF_CHUNK_POOL_SIZE_SHIFT 8
+
+/**
+ * @brief A 64-bit digest of a chunk hierarchy, consisting of two independently computed 32-bit hashes.
+ */
+typedef struct
+{
+    IFF_ULong hash[2];
+}
+IFF_Digest;
+
+/**
+ * @brief Describes where a chunk originates from and whether it has been modified since.
+ *
+ * The metadata is not a member of the chunk structures, so that the layout of
+ * extension chunks stays the same. Instead, IFF_allocateChunk() reserves a
+ * header in front of every chunk in which it is stored. It can be accessed with
+ * IFF_CHUNK_META().
+ */
+typedef struct
+{
+    /** Offset of the chunk header in the file from which the chunk was read, or -1 if it has not been read from a file */
+    long sourceOffset;
+    
+    /** Size of the chunk data as it was stored in the source file */
+    IFF_Long sourceSize;
+    
+    /** Identity of the source from which the chunk was read, or 0 if it has not been read, so that chunks moved between hierarchies of different files are told apart. See IFF_createSourceId() */
+    unsigned long sourceId;
+    
+    /** Modification state and allocation properties of the chunk, such as IFF_CHUNK_DIRTY */
+    unsigned int flags;
+    
+    /** Cached digest of the chunk hierarchy, which is only valid if IFF_CHUNK_DIGEST_VALID is set, see IFF_computeChunkDigest() */
+    IFF_Digest digest;
+    
+    /** Extension array with which the chunk hierarchy has passed the check, which is only valid if IFF_CHUNK_VALIDATED is set */
+    const struct IFF_Extension *validatedExtension;
+    
+    /** Length of the extension array with which the chunk hierarchy has passed the check */
+    unsigned int validatedExtensionLength;
+}
+IFF_ChunkMeta;
+
+/** Size of the header in front of every chunk that contains its metadata, rounded up to a multiple of 16 bytes, so that the chunk itself stays properly aligned */
+#define IFF_CHUNK_META_SIZE ((sizeof(IFF_ChunkMeta) + 15) / 16 * 16)
+
+/** Returns a pointer to the metadata of a chunk that has been allocated with IFF_allocateChunk() */
+#define IFF_CHUNK_META(chunk) ((IFF_ChunkMeta*)((char*)(chunk) - IFF_CHUNK_META_SIZE))
+
 #include "extension.h"
 #include "group.h"
 #include "form.h"
@@ -51,7 +126,8 @@ struct IFF_Chunk
 
 /**
  * Allocates memory for a chunk with the given chunk ID and chunk size.
- * The resulting chunk must be freed using IFF_free()
+ * The resulting chunk must be freed using IFF_free(), and not with free(),
+ * because its metadata is stored in front of it in the same allocation.
  *
  * @param chunkId A 4 character id
  * @param chunkSize Size of the chunk in bytes
@@ -59,6 +135,18 @@ struct IFF_Chunk
  */
 IFF_Chunk *IFF_allocateChunk(const char *chunkId, const size_t chunkSize);
 
+/**
+ * Allocates memory for a chunk of one of the fixed-size chunk types of this
+ * library from the chunk pool, so that many small chunks do not each require a
+ * separate heap allocation. The resulting chunk must be freed using IFF_free().
+ *
+ * @param chunkId A 4 character id
+ * @param chunkSize Size of the chunk in bytes. Chunks that don't fit in the chunk pool are allocated with malloc().
+ * @param flags Additional flags of the chunk, such as IFF_CHUNK_INLINE_STORAGE
+ * @return A generic chunk with the given chunk Id and size, or NULL if the memory can't be allocated.
+ */
+IFF_Chunk *IFF_allocatePooledChunk(const char *chunkId, const size_t chunkSize, const unsigned int flags);
+
 /**
  * Reads a chunk hierarchy from a given file descriptor. The resulting chunk must be freed using IFF_free()
  *
@@ -85,6 +173,10 @@ int IFF_writeChunk(IFF_Writer *file, const IFF_Chunk *chunk, const char *formTyp
 /**
  * Checks whether a chunk hierarchy conforms to the IFF specification.
  *
+ * Every chunk is checked, regardless of any cached validation outcome. This
+ * function does not modify the hierarchy, so it may be invoked concurrently on
+ * the same hierarchy.
+ *
  * @param chunk A chunk hierarchy representing an IFF file
  * @param formType Form type id describing in which FORM the sub chunk is located. NULL is used for sub chunks in other group chunks.
  * @param extension Extension array which specifies how application file format chunks can be handled
@@ -93,6 +185,40 @@ int IFF_writeChunk(IFF_Writer *file, const IFF_Chunk *chunk, const char *formTyp
  */
 int IFF_checkChunk(const IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength);
 
+/**
+ * Checks a chunk hierarchy like IFF_checkChunk() and caches the outcome, if it
+ * passes, by setting IFF_CHUNK_VALIDATED in every chunk of the hierarchy.
+ * Sub trees that have passed this check or have been checked while they were
+ * read are skipped. Modifying a chunk clears the flag up the parent chain, so a
+ * repeated check only visits the modified chunks, their ancestors and the
+ * direct sub chunks of these ancestors. The outcome is only reused by checks
+ * with the same extension array; a different one checks the chunks again.
+ *
+ * As the hierarchy is modified, it must not be accessed by other threads while
+ * this function runs.
+ *
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param formType Form type id describing in which FORM the sub chunk is located. NULL is used for sub chunks in other group chunks.
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the IFF file conforms to the IFF specification, else FALSE
+ */
+int IFF_checkChunkCached(IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Checks a sub chunk of a group chunk that is being checked. If the group chunk
+ * is checked by IFF_checkChunkCached(), the sub chunk is checked in the same way,
+ * otherwise with IFF_checkChunk().
+ *
+ * @param parent The group chunk that is being checked
+ * @param chunk A sub chunk of the group chunk
+ * @param formType Form type id describing in which FORM the sub chunk is located. NULL is used for sub chunks in other group chunks.
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the sub chunk conforms to the IFF specification, else FALSE
+ */
+int IFF_checkSubChunk(const IFF_Chunk *parent, IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength);
+
 /**
  * Frees an IFF chunk hierarchy from memory.
  *
@@ -115,7 +241,10 @@ void IFF_freeChunk(IFF_Chunk *chunk, const char *formType, const IFF_Extension *
 void IFF_printChunk(const IFF_Chunk *chunk, const unsigned int indentLevel, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength);
 
 /**
- * Checks whether two given chunk hierarchies are equal.
+ * Checks whether two given chunk hierarchies are equal. Chunks of which both
+ * digests have been cached by IFF_cacheChunkDigest() and differ are considered
+ * different, without descending into them. Chunks with equal digests are still
+ * compared by their contents, because different chunks may have equal digests.
  *
  * @param chunk1 Chunk hierarchy to compare
  * @param chunk2 Chunk hierarchy to compare
@@ -158,6 +287,16 @@ IFF_Form **IFF_searchForms(IFF_Chunk *chunk, const char *formType, unsigned int
  */
 IFF_Long IFF_incrementChunkSize(const IFF_Long chunkSize, const IFF_Chunk *chunk);
 
+/**
+ * Decrements the given chunk size by the size of the given chunk.
+ * Additionally, it takes the padding byte into account if the chunk size is odd.
+ *
+ * @param chunkSize Chunk size of a group chunk
+ * @param chunk A sub chunk
+ * @return The decremented chunk size
+ */
+IFF_Long IFF_decrementChunkSize(const IFF_Long chunkSize, const IFF_Chunk *chunk);
+
 /**
  * Recalculates the chunk size of the given chunk and recursively updates the chunk sizes of the parent group chunks.
  *
@@ -165,6 +304,37 @@ IFF_Long IFF_incrementChunkSize(const IFF_Long chunkSize, const IFF_Chunk *chunk
  */
 void IFF_updateChunkSizes(IFF_Chunk *chunk);
 
+/**
+ * Changes the chunk size of the given chunk and adjusts the chunk sizes of all
+ * its ancestors by the difference, including changes in padding. This takes time
+ * proportional to the depth of the chunk, in contrast to IFF_updateChunkSizes(),
+ * which recalculates the sizes from all sub chunks.
+ *
+ * @param chunk An arbitrary chunk
+ * @param chunkSize New size of the chunk data in bytes
+ */
+void IFF_setChunkSize(IFF_Chunk *chunk, const IFF_Long chunkSize);
+
+/**
+ * Marks the given chunk and all its ancestors as modified, so that they are
+ * no longer considered identical to the bytes in the source file and their
+ * cached digests and validation outcomes are no longer used. Operations that
+ * change chunk sizes or group memberships do this automatically. Applications
+ * that modify the members of a chunk directly must call this function afterwards.
+ *
+ * @param chunk An arbitrary chunk
+ */
+void IFF_markChunkDirty(IFF_Chunk *chunk);
+
+/**
+ * Checks whether the given chunk is unmodified since it was read from a file,
+ * i.e. whether its source bytes can be used instead of serializing it.
+ *
+ * @param chunk An arbitrary chunk
+ * @return TRUE if the chunk has been read from a file and has not been modified since, else FALSE
+ */
+int IFF_chunkIsClean(const IFF_Chunk *chunk);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "chunkpool.h"
+#include <stdlib.h>
+
+#if HAVE_PTHREAD_H == 1
+#include <pthread.h>
+#endif
+
+#define POOL_CLASSES (IFF_POOL_MAX_OBJECT_SIZE / IFF_POOL_GRANULARITY)
+
+/** Size of the blocks of memory from which objects are carved out */
+#define SLAB_SIZE 65536
+
+/**
+ * A slab is a block of memory starting with a header that links it to the
+ * other slabs of its size class. The objects follow the header.
+ */
+typedef struct Slab
+{
+    struct Slab *next;
+}
+Slab;
+
+/**
+ * An object that has been returned to the pool, linking to the next free object of its size class.
+ */
+typedef struct FreeObject
+{
+    struct FreeObject *next;
+}
+FreeObject;
+
+typedef struct
+{
+    /** All slabs of the size class */
+    Slab *slabs;
+    
+    /** Objects that have been returned to the pool and can be reused */
+    FreeObject *freeObjects;
+    
+    /** Start of the part of the most recent slab that has never been handed out */
+    char *unused;
+    
+    /** End of the most recent slab */
+    char *end;
+    
+    /** Number of objects that have been handed out and not been returned */
+    unsigned long liveObjects;
+}
+SizeClass;
+
+static SizeClass sizeClass[POOL_CLASSES];
+
+#if HAVE_PTHREAD_H == 1
+/* Chunks may be created and freed by multiple threads, e.g. while appending to a CAT file */
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void lockPool(void)
+{
+#if HAVE_PTHREAD_H == 1
+    pthread_mutex_lock(&poolMutex);
+#endif
+}
+
+static void unlockPool(void)
+{
+#if HAVE_PTHREAD_H == 1
+    pthread_mutex_unlock(&poolMutex);
+#endif
+}
+
+static void *allocateFromSizeClass(SizeClass *pool, const size_t objectSize)
+{
+    void *object;
+    
+    if(pool->freeObjects != NULL)
+    {
+	object = pool->freeObjects;
+	pool->freeObjects = pool->freeObjects->next;
+    }
+    else
+    {
+	if(pool->unused == NULL || pool->unused + objectSize > pool->end)
+	{
+	    Slab *slab = (Slab*)malloc(SLAB_SIZE);
+	    
+	    if(slab == NULL)
+		return NULL;
+	    
+	    slab->next = pool->slabs;
+	    pool->slabs = slab;
+	    
+	    /* The header occupies the first granule, so that the objects stay aligned */
+	    pool->unused = (char*)slab + IFF_POOL_GRANULARITY;
+	    pool->end = (char*)slab + SLAB_SIZE;
+	}
+	
+	object = pool->unused;
+	pool->unused += objectSize;
+    }
+    
+    pool->liveObjects++;
+    return object;
+}
+
+static void releaseToSizeClass(SizeClass *pool, void *object)
+{
+    FreeObject *freeObject = (FreeObject*)object;
+    
+    freeObject->next = pool->freeObjects;
+    pool->freeObjects = freeObject;
+    pool->liveObjects--;
+    
+    /* Give the memory back once the size class is no longer in use */
+    if(pool->liveObjects == 0)
+    {
+	Slab *slab = pool->slabs;
+	
+	while(slab != NULL)
+	{
+	    Slab *next = slab->next;
+	    free(slab);
+	    slab = next;
+	}
+	
+	pool->slabs = NULL;
+	pool->freeObjects = NULL;
+	pool->unused = NULL;
+	pool->end = NULL;
+    }
+}
+
+void *IFF_allocateFromPool(const size_t size)
+{
+    unsigned int index;
+    void *object;
+    
+    /* Sizes outside the range of the size classes can't be served from the pool */
+    if(size == 0 || size > IFF_POOL_MAX_OBJECT_SIZE)
+	return NULL;
+    
+    index = (size + IFF_POOL_GRANULARITY - 1) / IFF_POOL_GRANULARITY - 1;
+    
+    lockPool();
+    object = allocateFromSizeClass(&sizeClass[index], (index + 1) * IFF_POOL_GRANULARITY);
+    unlockPool();
+    
+    return object;
+}
+
+void IFF_releaseToPool(void *object, const size_t size)
+{
+    unsigned int index;
+    
+    if(object == NULL || size == 0 || size > IFF_POOL_MAX_OBJECT_SIZE)
+	return;
+    
+    index = (size + IFF_POOL_GRANULARITY - 1) / IFF_POOL_GRANULARITY - 1;
+    
+    lockPool();
+    releaseToSizeClass(&sizeClass[index], object);
+    unlockPool();
+}
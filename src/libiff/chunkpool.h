@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_CHUNKPOOL_H
+#define __IFF_CHUNKPOOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Object sizes are rounded up to a multiple of this value, which also keeps them properly aligned */
+#define IFF_POOL_GRANULARITY 16
+
+/** Size of the largest object that can be allocated from the chunk pool */
+#define IFF_POOL_MAX_OBJECT_SIZE 256
+
+/**
+ * Allocates memory for a small, fixed-size object from the chunk pool. Objects
+ * of the same size class are carved out of shared slabs, which avoids the
+ * bookkeeping overhead of a separate malloc() for every chunk of a hierarchy.
+ *
+ * @param size Size of the object in bytes, which must not exceed IFF_POOL_MAX_OBJECT_SIZE
+ * @return A pointer to the allocated memory, or NULL if the memory can't be allocated or the size is zero or exceeds IFF_POOL_MAX_OBJECT_SIZE
+ */
+void *IFF_allocateFromPool(const size_t size);
+
+/**
+ * Returns memory that has been allocated with IFF_allocateFromPool() to the
+ * chunk pool. The slabs of a size class are freed once all of its objects have
+ * been returned.
+ *
+ * @param object Pointer to the object
+ * @param size Size of the object in bytes, which must be equal to the size with which it has been allocated
+ */
+void IFF_releaseToPool(void *object, const size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
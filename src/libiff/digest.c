@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "digest.h"
+#include "id.h"
+#include "io.h"
+#include "group.h"
+#include "list.h"
+#include "rawchunk.h"
+
+/**
+ * @brief A writer that adds everything that is written to a digest, so that
+ * the digest of a data chunk covers exactly the bytes that are written to a file.
+ */
+typedef struct
+{
+    IFF_Writer base;
+    IFF_Digest *digest;
+}
+DigestWriter;
+
+static int digestWrite(IFF_Writer *file, const void *data, IFF_ULong size)
+{
+    IFF_updateDigest(((DigestWriter*)file)->digest, data, size);
+    return TRUE;
+}
+
+static const struct IFF_WriterCallbacks digestWriterCallbacks =
+{
+    &digestWrite,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+void IFF_initDigest(IFF_Digest *digest)
+{
+    digest->hash[0] = 2166136261U;
+    digest->hash[1] = 0x9747b28cU;
+}
+
+/**
+ * Adds a 32-bit word to both hashes. The first hash is FNV-1a applied to whole
+ * words, the second one mixes the words in the same way as MurmurHash2.
+ */
+static void addWord(IFF_ULong *hash0, IFF_ULong *hash1, IFF_ULong word)
+{
+    *hash0 = (*hash0 ^ word) * 16777619U;
+    
+    word *= 0x5bd1e995U;
+    word ^= word >> 24;
+    word *= 0x5bd1e995U;
+    *hash1 = (*hash1 * 0x5bd1e995U) ^ word;
+}
+
+void IFF_updateDigest(IFF_Digest *digest, const void *data, const IFF_ULong size)
+{
+    const IFF_UByte *bytes = (const IFF_UByte*)data;
+    IFF_ULong hash0 = digest->hash[0];
+    IFF_ULong hash1 = digest->hash[1];
+    IFF_ULong i;
+    
+    /* Compose the words byte by byte, so that the digest does not depend on the byte order or alignment */
+    for(i = 0; i + 4 <= size; i += 4)
+	addWord(&hash0, &hash1, (IFF_ULong)bytes[i] | (IFF_ULong)bytes[i + 1] << 8 | (IFF_ULong)bytes[i + 2] << 16 | (IFF_ULong)bytes[i + 3] << 24);
+    
+    for(; i < size; i++)
+	addWord(&hash0, &hash1, bytes[i]);
+    
+    digest->hash[0] = hash0;
+    digest->hash[1] = hash1;
+}
+
+int IFF_compareDigest(const IFF_Digest *digest1, const IFF_Digest *digest2)
+{
+    return (digest1->hash[0] == digest2->hash[0] && digest1->hash[1] == digest2->hash[1]);
+}
+
+static void addChunkHeader(IFF_Digest *digest, const IFF_Chunk *chunk)
+{
+    IFF_UByte size[sizeof(IFF_Long)];
+    IFF_ULong chunkSize = chunk->chunkSize;
+    
+    /* Use a fixed byte order, so that the digest does not depend on the platform */
+    size[0] = (chunkSize >> 24) & 0xff;
+    size[1] = (chunkSize >> 16) & 0xff;
+    size[2] = (chunkSize >> 8) & 0xff;
+    size[3] = chunkSize & 0xff;
+    
+    IFF_updateDigest(digest, chunk->chunkId, IFF_ID_SIZE);
+    IFF_updateDigest(digest, size, sizeof(size));
+}
+
+static int computeDigest(const IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength, const int cache, IFF_Digest *digest);
+
+static int addSubChunk(IFF_Digest *digest, const IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength, const int cache)
+{
+    IFF_Digest subDigest;
+    
+    if(!computeDigest(chunk, formType, extension, extensionLength, cache, &subDigest))
+	return FALSE;
+    
+    IFF_updateDigest(digest, subDigest.hash, sizeof(subDigest.hash));
+    return TRUE;
+}
+
+static int addGroup(IFF_Digest *digest, const IFF_Group *group, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength, const int cache)
+{
+    unsigned int i;
+    int status = TRUE;
+    
+    IFF_updateDigest(digest, group->groupType, IFF_ID_SIZE);
+    
+    /* Continue after a failure, so that the digests of the other sub chunks are cached nonetheless */
+    for(i = 0; i < group->chunkLength; i++)
+	status = addSubChunk(digest, group->chunk[i], formType, extension, extensionLength, cache) && status;
+    
+    return status;
+}
+
+static int addList(IFF_Digest *digest, const IFF_List *list, const IFF_Extension *extension, const unsigned int extensionLength, const int cache)
+{
+    unsigned int i;
+    int status = TRUE;
+    
+    for(i = 0; i < list->propLength; i++)
+	status = addSubChunk(digest, (const IFF_Chunk*)list->prop[i], NULL, extension, extensionLength, cache) && status;
+    
+    return addGroup(digest, (const IFF_Group*)list, NULL, extension, extensionLength, cache) && status;
+}
+
+static int addDataChunk(IFF_Digest *digest, const IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    const IFF_FormExtension *formExtension = IFF_findFormExtension(formType, chunk->chunkId, extension, extensionLength);
+    DigestWriter writer;
+    
+    writer.base.callbacks = &digestWriterCallbacks;
+    writer.digest = digest;
+    
+    if(formExtension == NULL)
+    {
+	const IFF_RawChunk *rawChunk = (const IFF_RawChunk*)chunk;
+	
+	/* A body that has been passed to a body sink is gone */
+	if(rawChunk->chunkData == NULL && rawChunk->dataFile == NULL && rawChunk->chunkSize > 0)
+	    return FALSE;
+	
+	return IFF_writeRawChunk(&writer.base, rawChunk);
+    }
+    else
+	return IFF_writeExtensionChunk(formExtension, &writer.base, chunk);
+}
+
+/**
+ * Computes the digest of a chunk hierarchy, reusing the cached digests of
+ * unmodified sub trees. If cache is TRUE, the computed digests are cached in the
+ * chunks as well.
+ */
+static int computeDigest(const IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength, const int cache, IFF_Digest *digest)
+{
+    int status;
+    
+    if(IFF_CHUNK_META(chunk)->flags & IFF_CHUNK_DIGEST_VALID)
+    {
+	*digest = IFF_CHUNK_META(chunk)->digest;
+	return TRUE;
+    }
+    
+    IFF_initDigest(digest);
+    addChunkHeader(digest, chunk);
+    
+    if(IFF_compareId(chunk->chunkId, "FORM") == 0 || IFF_compareId(chunk->chunkId, "PROP") == 0)
+	status = addGroup(digest, (const IFF_Group*)chunk, ((const IFF_Group*)chunk)->groupType, extension, extensionLength, cache);
+    else if(IFF_compareId(chunk->chunkId, "CAT ") == 0)
+	status = addGroup(digest, (const IFF_Group*)chunk, NULL, extension, extensionLength, cache);
+    else if(IFF_compareId(chunk->chunkId, "LIST") == 0)
+	status = addList(digest, (const IFF_List*)chunk, extension, extensionLength, cache);
+    else
+	status = addDataChunk(digest, chunk, formType, extension, extensionLength);
+    
+    /* The digest is a cache, which does not change the contents of the chunk */
+    if(status && cache)
+    {
+	IFF_CHUNK_META(chunk)->digest = *digest;
+	IFF_CHUNK_META(chunk)->flags |= IFF_CHUNK_DIGEST_VALID;
+    }
+    
+    return status;
+}
+
+int IFF_computeChunkDigest(const IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength, IFF_Digest *digest)
+{
+    return computeDigest(chunk, formType, extension, extensionLength, FALSE, digest);
+}
+
+int IFF_cacheChunkDigest(IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength, IFF_Digest *digest)
+{
+    return computeDigest(chunk, formType, extension, extensionLength, TRUE, digest);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_DIGEST_H
+#define __IFF_DIGEST_H
+
+#include "ifftypes.h"
+#include "chunk.h"
+#include "extension.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initialises a digest to which no data has been added yet.
+ *
+ * @param digest A digest
+ */
+void IFF_initDigest(IFF_Digest *digest);
+
+/**
+ * Adds the given bytes to a digest.
+ *
+ * @param digest A digest
+ * @param data An array of bytes
+ * @param size Length of the bytes array
+ */
+void IFF_updateDigest(IFF_Digest *digest, const void *data, const IFF_ULong size);
+
+/**
+ * Checks whether two digests are equal.
+ *
+ * @param digest1 Digest to compare
+ * @param digest2 Digest to compare
+ * @return TRUE if the digests are equal, else FALSE
+ */
+int IFF_compareDigest(const IFF_Digest *digest1, const IFF_Digest *digest2);
+
+/**
+ * Computes the digest of a chunk hierarchy. The digest of a data chunk covers
+ * its chunk ID, chunk size and its body as it is written to a file. The digest
+ * of a group chunk covers its chunk ID, chunk size, group type and the digests
+ * of its sub chunks, so that identical hierarchies have identical digests.
+ *
+ * Digests that have been cached by IFF_cacheChunkDigest() are reused, but the
+ * hierarchy is not modified, so it may be invoked concurrently on the same
+ * hierarchy.
+ *
+ * @param chunk A chunk hierarchy
+ * @param formType Form type id describing in which FORM the sub chunk is located. NULL is used for sub chunks in other group chunks.
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @param digest Digest of the chunk hierarchy
+ * @return TRUE if the digest has been computed, or FALSE if the body of a data chunk in the hierarchy is not available
+ */
+int IFF_computeChunkDigest(const IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength, IFF_Digest *digest);
+
+/**
+ * Computes the digest of a chunk hierarchy like IFF_computeChunkDigest() and
+ * caches the digests of all chunks in the hierarchy. They are reused until a
+ * chunk is marked as modified by IFF_markChunkDirty(), which happens
+ * automatically when chunk sizes or group memberships change. Applications that
+ * modify the chunk data of a raw chunk or the members of an extension chunk
+ * directly must call IFF_markChunkDirty() afterwards.
+ *
+ * As the hierarchy is modified, it must not be accessed by other threads while
+ * this function runs.
+ *
+ * @param chunk A chunk hierarchy
+ * @param formType Form type id describing in which FORM the sub chunk is located. NULL is used for sub chunks in other group chunks.
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @param digest Digest of the chunk hierarchy
+ * @return TRUE if the digest has been computed, or FALSE if the body of a data chunk in the hierarchy is not available
+ */
+int IFF_cacheChunkDigest(IFF_Chunk *chunk, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength, IFF_Digest *digest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -86,3 +86,49 @@ const IFF_FormExtension *IFF_findFormExtension(const char *formType, const char
 	return formExtension;
     }
 }
+
+IFF_Chunk *IFF_readExtensionChunk(const IFF_FormExtension *formExtension, IFF_Reader *file, const IFF_Long chunkSize)
+{
+    if(formExtension->readChunk == NULL)
+	return IFF_readLayoutChunk(file, formExtension->chunkId, chunkSize, formExtension->layout);
+    else
+	return formExtension->readChunk(file, chunkSize);
+}
+
+int IFF_writeExtensionChunk(const IFF_FormExtension *formExtension, IFF_Writer *file, const IFF_Chunk *chunk)
+{
+    if(formExtension->writeChunk == NULL)
+	return IFF_writeLayoutChunk(file, chunk, formExtension->layout);
+    else
+	return formExtension->writeChunk(file, chunk);
+}
+
+int IFF_checkExtensionChunk(const IFF_FormExtension *formExtension, const IFF_Chunk *chunk)
+{
+    if(formExtension->checkChunk == NULL)
+	return TRUE;
+    else
+	return formExtension->checkChunk(chunk);
+}
+
+void IFF_freeExtensionChunk(const IFF_FormExtension *formExtension, IFF_Chunk *chunk)
+{
+    if(formExtension->freeChunk != NULL)
+	formExtension->freeChunk(chunk);
+}
+
+void IFF_printExtensionChunk(const IFF_FormExtension *formExtension, const IFF_Chunk *chunk, const unsigned int indentLevel)
+{
+    if(formExtension->printChunk == NULL)
+	IFF_printLayoutChunk(chunk, indentLevel, formExtension->layout);
+    else
+	formExtension->printChunk(chunk, indentLevel);
+}
+
+int IFF_compareExtensionChunk(const IFF_FormExtension *formExtension, const IFF_Chunk *chunk1, const IFF_Chunk *chunk2)
+{
+    if(formExtension->compareChunk == NULL)
+	return IFF_compareLayoutChunk(chunk1, chunk2, formExtension->layout);
+    else
+	return formExtension->compareChunk(chunk1, chunk2);
+}
@@ -27,6 +27,7 @@ typedef struct IFF_Extension IFF_Extension;
 
 #include "ifftypes.h"
 #include "chunk.h"
+#include "layout.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -40,23 +41,26 @@ struct IFF_FormExtension
     /** A 4 character chunk id */
     const char *chunkId;
     
-    /** Function resposible for reading the given chunk */
+    /** Function resposible for reading the given chunk, or NULL to read it according to the layout */
     IFF_Chunk* (*readChunk) (IFF_Reader *file, const IFF_Long chunkSize);
     
-    /** Function resposible for writing the given chunk */
+    /** Function resposible for writing the given chunk, or NULL to write it according to the layout */
     int (*writeChunk) (IFF_Writer *file, const IFF_Chunk *chunk);
     
-    /** Function resposible for checking the given chunk */
+    /** Function resposible for checking the given chunk, or NULL if every chunk is valid */
     int (*checkChunk) (const IFF_Chunk *chunk);
     
-    /** Function resposible for freeing the given chunk */
+    /** Function resposible for freeing the given chunk, or NULL if the chunk does not own any memory */
     void (*freeChunk) (IFF_Chunk *chunk);
     
-    /** Function responsible for printing the given chunk */
+    /** Function responsible for printing the given chunk, or NULL to print it according to the layout */
     void (*printChunk) (const IFF_Chunk *chunk, const unsigned int indentLevel);
     
-    /** Function responsible for comparing the given chunk */
+    /** Function responsible for comparing the given chunk, or NULL to compare it according to the layout */
     int (*compareChunk) (const IFF_Chunk *chunk1, const IFF_Chunk *chunk2);
+    
+    /** Describes the fields of the chunk body for the functions that are NULL, or NULL if all functions are implemented */
+    const IFF_ChunkLayout *layout;
 };
 
 /**
@@ -85,6 +89,62 @@ struct IFF_Extension
  */
 const IFF_FormExtension *IFF_findFormExtension(const char *formType, const char *chunkId, const IFF_Extension *extension, const unsigned int extensionLength);
 
+/**
+ * Reads a chunk that is handled by the given form extension, using its layout if it has no read function.
+ *
+ * @param formExtension A form extension
+ * @param file File descriptor of the file
+ * @param chunkSize Size of the chunk data
+ * @return The chunk that has been read, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readExtensionChunk(const IFF_FormExtension *formExtension, IFF_Reader *file, const IFF_Long chunkSize);
+
+/**
+ * Writes the body of a chunk that is handled by the given form extension, using its layout if it has no write function.
+ *
+ * @param formExtension A form extension
+ * @param file File descriptor of the file
+ * @param chunk A chunk handled by the form extension
+ * @return TRUE if the body has been successfully written, else FALSE
+ */
+int IFF_writeExtensionChunk(const IFF_FormExtension *formExtension, IFF_Writer *file, const IFF_Chunk *chunk);
+
+/**
+ * Checks a chunk that is handled by the given form extension. A chunk is valid if the extension has no check function.
+ *
+ * @param formExtension A form extension
+ * @param chunk A chunk handled by the form extension
+ * @return TRUE if the chunk is valid, else FALSE
+ */
+int IFF_checkExtensionChunk(const IFF_FormExtension *formExtension, const IFF_Chunk *chunk);
+
+/**
+ * Frees the members of a chunk that is handled by the given form extension, if it has a free function.
+ *
+ * @param formExtension A form extension
+ * @param chunk A chunk handled by the form extension
+ */
+void IFF_freeExtensionChunk(const IFF_FormExtension *formExtension, IFF_Chunk *chunk);
+
+/**
+ * Prints a chunk that is handled by the given form extension, using its layout if it has no print function.
+ *
+ * @param formExtension A form extension
+ * @param chunk A chunk handled by the form extension
+ * @param indentLevel Indent level of the textual representation
+ */
+void IFF_printExtensionChunk(const IFF_FormExtension *formExtension, const IFF_Chunk *chunk, const unsigned int indentLevel);
+
+/**
+ * Compares two chunks that are handled by the given form extension, using its layout if it has no compare function.
+ *
+ * @param formExtension A form extension
+ * @param chunk1 Chunk to compare
+ * @param chunk2 Chunk to compare
+ * @return TRUE if the chunks are equal, else FALSE
+ */
+int IFF_compareExtensionChunk(const IFF_FormExtension *formExtension, const IFF_Chunk *chunk1, const IFF_Chunk *chunk2);
+
 #ifdef __cplusplus
 }
 #endif
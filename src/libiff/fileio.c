@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#if HAVE_COPY_FILE_RANGE == 1
+/* copy_file_range() is a GNU extension */
+#define _GNU_SOURCE
+#endif
+
+#include "fileio.h"
+
+#if HAVE_UNISTD_H == 1
+#include <errno.h>
+#include <sys/types.h>
+#include <unistd.h>
+#define IFF_FILEIO_FD 1
+#endif
+
+#if HAVE_SYS_SENDFILE_H == 1 && HAVE_UNISTD_H == 1
+#include <sys/sendfile.h>
+#endif
+
+/** Size of the blocks in which a file range is copied, if the kernel cannot copy it */
+#define COPY_BLOCK_SIZE 65536
+
+static int IFF_fileRead(IFF_Reader *reader, void *data, IFF_ULong size)
+{
+    IFF_FileReader *fileReader = (IFF_FileReader*)reader;
+    
+    if(fread(data, sizeof(IFF_UByte), size, fileReader->file) == size)
+    {
+	/* Keep track of the position ourselves, as querying the stream for every chunk is expensive */
+	if(fileReader->position >= 0)
+	    fileReader->position += size;
+	
+	return TRUE;
+    }
+    else
+	return FALSE;
+}
+
+static long IFF_fileReaderTell(IFF_Reader *reader)
+{
+    IFF_FileReader *fileReader = (IFF_FileReader*)reader;
+    return fileReader->position;
+}
+
+static const struct IFF_ReaderCallbacks fileReaderCallbacks =
+{
+    &IFF_fileRead,
+    &IFF_fileReaderTell
+};
+
+void IFF_initFileReader(IFF_FileReader *reader, FILE *file)
+{
+    IFF_initReader(&reader->base, &fileReaderCallbacks);
+    reader->file = file;
+    reader->position = ftell(file);
+}
+
+static int IFF_fileWrite(IFF_Writer *writer, const void *data, IFF_ULong size)
+{
+    IFF_FileWriter *fileWriter = (IFF_FileWriter*)writer;
+    return (fwrite(data, sizeof(IFF_UByte), size, fileWriter->file) == size);
+}
+
+static long IFF_fileTell(IFF_Writer *writer)
+{
+    IFF_FileWriter *fileWriter = (IFF_FileWriter*)writer;
+    return ftell(fileWriter->file);
+}
+
+static int IFF_fileSeek(IFF_Writer *writer, long offset)
+{
+    IFF_FileWriter *fileWriter = (IFF_FileWriter*)writer;
+    return (fseek(fileWriter->file, offset, SEEK_SET) == 0);
+}
+
+static int IFF_fileCopyFile(IFF_Writer *writer, FILE *source, long offset, IFF_ULong size)
+{
+    IFF_FileWriter *fileWriter = (IFF_FileWriter*)writer;
+    return IFF_copyFileRange(fileWriter->file, source, offset, size);
+}
+
+static const struct IFF_WriterCallbacks fileWriterCallbacks =
+{
+    &IFF_fileWrite,
+    &IFF_fileTell,
+    &IFF_fileSeek,
+    NULL,
+    NULL,
+    NULL,
+    &IFF_fileCopyFile
+};
+
+void IFF_initFileWriter(IFF_FileWriter *writer, FILE *file)
+{
+    writer->base.callbacks = &fileWriterCallbacks;
+    writer->file = file;
+}
+
+int IFF_readFileRange(FILE *file, long offset, void *data, const IFF_ULong size)
+{
+#ifdef IFF_FILEIO_FD
+    int fd = fileno(file);
+    IFF_ULong done = 0;
+    
+    /* pread() does not change the position of the file, so concurrent readers do not interfere */
+    while(done < size)
+    {
+	ssize_t count = pread(fd, (IFF_UByte*)data + done, size - done, offset + done);
+	
+	if(count < 0)
+	{
+	    if(errno == EINTR)
+		continue;
+	    else
+		return FALSE;
+	}
+	else if(count == 0)
+	    return FALSE; /* The file is shorter than expected */
+	
+	done += count;
+    }
+    
+    return TRUE;
+#else
+    return (fseek(file, offset, SEEK_SET) == 0 && fread(data, sizeof(IFF_UByte), size, file) == size);
+#endif
+}
+
+#ifdef IFF_FILEIO_FD
+
+/**
+ * Lets the kernel copy as many bytes as possible to the current position of the
+ * destination. If the kernel cannot copy between the given files, it stops
+ * without an error, so that the caller can copy the remaining bytes itself.
+ */
+static int copyInKernel(int destination, int source, long *offset, IFF_ULong *size)
+{
+#if HAVE_COPY_FILE_RANGE == 1
+    while(*size > 0)
+    {
+	loff_t sourceOffset = *offset;
+	ssize_t count = copy_file_range(source, &sourceOffset, destination, NULL, *size, 0);
+	
+	if(count < 0)
+	{
+	    if(errno == EINTR)
+		continue;
+	    else
+		break; /* For example, when the files reside on different file systems */
+	}
+	else if(count == 0)
+	    return FALSE; /* The source file is shorter than expected */
+	
+	*offset += count;
+	*size -= count;
+    }
+#endif
+#if HAVE_SYS_SENDFILE_H == 1
+    while(*size > 0)
+    {
+	off_t sourceOffset = *offset;
+	ssize_t count = sendfile(destination, source, &sourceOffset, *size);
+	
+	if(count < 0)
+	{
+	    if(errno == EINTR)
+		continue;
+	    else
+		break;
+	}
+	else if(count == 0)
+	    return FALSE;
+	
+	*offset += count;
+	*size -= count;
+    }
+#endif
+    return TRUE;
+}
+
+static int writeBlock(FILE *destination, const IFF_UByte *block, IFF_ULong size)
+{
+    int fd = fileno(destination);
+    
+    while(size > 0)
+    {
+	ssize_t count = write(fd, block, size);
+	
+	if(count < 0)
+	{
+	    if(errno == EINTR)
+		continue;
+	    else
+		return FALSE;
+	}
+	
+	block += count;
+	size -= count;
+    }
+    
+    return TRUE;
+}
+
+#else
+
+static int writeBlock(FILE *destination, const IFF_UByte *block, IFF_ULong size)
+{
+    return (fwrite(block, sizeof(IFF_UByte), size, destination) == size);
+}
+
+#endif
+
+int IFF_copyFileRange(FILE *destination, FILE *source, long offset, const IFF_ULong size)
+{
+    IFF_UByte block[COPY_BLOCK_SIZE];
+    IFF_ULong remaining = size;
+    int status = TRUE;
+#ifdef IFF_FILEIO_FD
+    off_t position;
+    
+    /* The bytes are written to the file descriptor, so anything that is buffered by the stream must be written first */
+    if(fflush(destination) != 0)
+	return FALSE;
+    
+    status = copyInKernel(fileno(destination), fileno(source), &offset, &remaining);
+#endif
+    
+    while(status && remaining > 0)
+    {
+	IFF_ULong blockSize = remaining < COPY_BLOCK_SIZE ? remaining : COPY_BLOCK_SIZE;
+	
+	status = IFF_readFileRange(source, offset, block, blockSize) && writeBlock(destination, block, blockSize);
+	
+	offset += blockSize;
+	remaining -= blockSize;
+    }
+    
+#ifdef IFF_FILEIO_FD
+    /* Let the stream continue at the position of the file descriptor. Streams that are not seekable have no position. */
+    position = lseek(fileno(destination), 0, SEEK_CUR);
+    
+    if(position >= 0 && fseek(destination, position, SEEK_SET) != 0)
+	status = FALSE;
+#endif
+    
+    return status;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_FILEIO_H
+#define __IFF_FILEIO_H
+
+#include <stdio.h>
+#include "ifftypes.h"
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A reader that reads its data from a standard C file stream.
+ */
+typedef struct
+{
+    /** Reader base, so that a file reader can be used as an IFF_Reader */
+    IFF_Reader base;
+    
+    /** File stream from which the data is read */
+    FILE *file;
+    
+    /** Offset of the next byte to read, or -1 if the stream is not seekable */
+    long position;
+}
+IFF_FileReader;
+
+/**
+ * @brief A writer that writes its data to a standard C file stream.
+ */
+typedef struct
+{
+    /** Writer base, so that a file writer can be used as an IFF_Writer */
+    IFF_Writer base;
+    
+    /** File stream to which the data is written */
+    FILE *file;
+}
+IFF_FileWriter;
+
+/**
+ * Initializes a file reader that reads from the given file stream.
+ *
+ * @param reader A file reader instance
+ * @param file File descriptor of the file
+ */
+void IFF_initFileReader(IFF_FileReader *reader, FILE *file);
+
+/**
+ * Initializes a file writer that writes to the given file stream. If the stream
+ * refers to a regular file, the writer is seekable.
+ *
+ * @param writer A file writer instance
+ * @param file File descriptor of the file
+ */
+void IFF_initFileWriter(IFF_FileWriter *writer, FILE *file);
+
+/**
+ * Reads a range of bytes from the given offset of a file. If possible, the
+ * position of the file stream is not changed, so that the same file can be
+ * read by multiple threads at the same time.
+ *
+ * @param file File descriptor of the file
+ * @param offset Offset of the first byte to read
+ * @param data Memory block in which the bytes are stored
+ * @param size Amount of bytes to read
+ * @return TRUE if all bytes have been read, else FALSE
+ */
+int IFF_readFileRange(FILE *file, long offset, void *data, const IFF_ULong size);
+
+/**
+ * Copies a range of bytes from a source file to the current position of a
+ * destination file. On systems that support it, the kernel transfers the bytes
+ * with copy_file_range() or sendfile(), so that they do not pass through a user
+ * space buffer. The position of the source file stream is not changed.
+ *
+ * @param destination File descriptor of the file to which the bytes are written
+ * @param source File descriptor of the file from which the bytes are read
+ * @param offset Offset of the first byte to copy in the source file
+ * @param size Amount of bytes to copy
+ * @return TRUE if all bytes have been copied, else FALSE
+ */
+int IFF_copyFileRange(FILE *destination, FILE *source, long offset, const IFF_ULong size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
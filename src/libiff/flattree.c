@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "flattree.h"
+#include <stdlib.h>
+#include <string.h>
+#include "id.h"
+#include "form.h"
+#include "fileio.h"
+#include "error.h"
+#include "scanner.h"
+
+#define HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long))
+
+/**
+ * @brief Keeps track of the position while the chunk structure is read.
+ */
+typedef struct
+{
+    /** Scanner from which the structure is read */
+    IFF_Scanner scanner;
+    
+    /** Tree to which the nodes are added */
+    IFF_FlatTree *tree;
+}
+FlatParser;
+
+static int growTree(IFF_FlatTree *tree)
+{
+    unsigned int capacity = tree->nodeCapacity == 0 ? 64 : tree->nodeCapacity * 2;
+    IFF_ID *chunkId = (IFF_ID*)realloc(tree->chunkId, capacity * sizeof(IFF_ID));
+    IFF_Long *chunkSize;
+    long *offset;
+    IFF_ID *groupType;
+    unsigned int *parent, *firstChild, *nextSibling;
+    
+    /* Each successfully reallocated array replaces the old one, so that nothing leaks if a subsequent one fails */
+    if(chunkId == NULL)
+	return FALSE;
+    tree->chunkId = chunkId;
+    
+    if((chunkSize = (IFF_Long*)realloc(tree->chunkSize, capacity * sizeof(IFF_Long))) == NULL)
+	return FALSE;
+    tree->chunkSize = chunkSize;
+    
+    if((offset = (long*)realloc(tree->offset, capacity * sizeof(long))) == NULL)
+	return FALSE;
+    tree->offset = offset;
+    
+    if((groupType = (IFF_ID*)realloc(tree->groupType, capacity * sizeof(IFF_ID))) == NULL)
+	return FALSE;
+    tree->groupType = groupType;
+    
+    if((parent = (unsigned int*)realloc(tree->parent, capacity * sizeof(unsigned int))) == NULL)
+	return FALSE;
+    tree->parent = parent;
+    
+    if((firstChild = (unsigned int*)realloc(tree->firstChild, capacity * sizeof(unsigned int))) == NULL)
+	return FALSE;
+    tree->firstChild = firstChild;
+    
+    if((nextSibling = (unsigned int*)realloc(tree->nextSibling, capacity * sizeof(unsigned int))) == NULL)
+	return FALSE;
+    tree->nextSibling = nextSibling;
+    
+    tree->nodeCapacity = capacity;
+    return TRUE;
+}
+
+static unsigned int addNode(IFF_FlatTree *tree, const IFF_UByte *header, const long offset, const unsigned int parent, const unsigned int previousSibling)
+{
+    unsigned int node = tree->nodeLength;
+    
+    if(node == tree->nodeCapacity && !growTree(tree))
+    {
+	IFF_error("Cannot allocate memory for the flat tree!\n");
+	return IFF_FLAT_NO_NODE;
+    }
+    
+    memcpy(tree->chunkId[node], header, IFF_ID_SIZE);
+    tree->chunkSize[node] = IFF_decodeLong(header + IFF_ID_SIZE);
+    tree->offset[node] = offset;
+    memset(tree->groupType[node], '\0', IFF_ID_SIZE);
+    tree->parent[node] = parent;
+    tree->firstChild[node] = IFF_FLAT_NO_NODE;
+    tree->nextSibling[node] = IFF_FLAT_NO_NODE;
+    
+    if(previousSibling != IFF_FLAT_NO_NODE)
+	tree->nextSibling[previousSibling] = node;
+    else if(parent != IFF_FLAT_NO_NODE)
+	tree->firstChild[parent] = node;
+    
+    tree->nodeLength++;
+    return node;
+}
+
+/**
+ * Reads a chunk and its sub chunks, in the same way as IFF_readChunk() does.
+ */
+static unsigned int readNode(FlatParser *parser, const unsigned int parent, const unsigned int previousSibling)
+{
+    IFF_FlatTree *tree = parser->tree;
+    IFF_UByte header[HEADER_SIZE];
+    long offset = parser->scanner.position;
+    IFF_Long chunkSize;
+    unsigned int node;
+    
+    if(!IFF_scanBytes(&parser->scanner, header, HEADER_SIZE))
+    {
+	IFF_error("Error reading chunk header!\n");
+	return IFF_FLAT_NO_NODE;
+    }
+    
+    if((node = addNode(tree, header, offset, parent, previousSibling)) == IFF_FLAT_NO_NODE)
+	return IFF_FLAT_NO_NODE;
+    
+    chunkSize = tree->chunkSize[node];
+    
+    if(IFF_isGroupChunkId(tree->chunkId[node]))
+    {
+	IFF_ID groupType;
+	IFF_Long readSize = IFF_ID_SIZE;
+	unsigned int child = IFF_FLAT_NO_NODE;
+	
+	if(!IFF_scanBytes(&parser->scanner, groupType, IFF_ID_SIZE))
+	{
+	    IFF_readError(tree->chunkId[node], "groupType");
+	    return IFF_FLAT_NO_NODE;
+	}
+	
+	memcpy(tree->groupType[node], groupType, IFF_ID_SIZE);
+	
+	/* Keep parsing sub chunks until we have read all bytes */
+	while(readSize < chunkSize)
+	{
+	    IFF_Long childSize;
+	    
+	    if((child = readNode(parser, node, child)) == IFF_FLAT_NO_NODE)
+	    {
+		IFF_error("Error while reading chunk!\n");
+		return IFF_FLAT_NO_NODE;
+	    }
+	    
+	    childSize = tree->chunkSize[child];
+	    readSize += HEADER_SIZE + childSize + (childSize % 2 != 0 ? 1 : 0);
+	}
+    }
+    else
+    {
+	/* Skip the body and the padding byte, if the chunk size is odd */
+	if(chunkSize < 0 || !IFF_skipBytes(&parser->scanner, chunkSize) || (chunkSize % 2 != 0 && !IFF_skipBytes(&parser->scanner, 1)))
+	{
+	    IFF_error("Error reading raw chunk body of chunk: '");
+	    IFF_errorId(tree->chunkId[node]);
+	    IFF_error("'\n");
+	    return IFF_FLAT_NO_NODE;
+	}
+    }
+    
+    return node;
+}
+
+static IFF_FlatTree *readFlatTree(FlatParser *parser)
+{
+    IFF_FlatTree *tree = (IFF_FlatTree*)calloc(1, sizeof(IFF_FlatTree));
+    IFF_UByte byte;
+    
+    if(tree == NULL)
+	return NULL;
+    
+    parser->tree = tree;
+    
+    if(readNode(parser, IFF_FLAT_NO_NODE, IFF_FLAT_NO_NODE) == IFF_FLAT_NO_NODE)
+    {
+	IFF_error("ERROR: cannot open main chunk!\n");
+	IFF_freeFlatTree(tree);
+	return NULL;
+    }
+    
+    /* We should have reached the EOF now */
+    if(IFF_scanBytes(&parser->scanner, &byte, sizeof(IFF_UByte)))
+	IFF_error("WARNING: Trailing IFF contents found: %d!\n", byte);
+    
+    return tree;
+}
+
+IFF_FlatTree *IFF_readFlatTreeReader(IFF_Reader *file)
+{
+    FlatParser parser;
+    
+    IFF_initScanner(&parser.scanner, file);
+    return readFlatTree(&parser);
+}
+
+IFF_FlatTree *IFF_readFlatTreeFd(FILE *file)
+{
+    FlatParser parser;
+    
+    /* If the stream is seekable, large bodies are skipped by seeking over them */
+    if(IFF_initSeekableScanner(&parser.scanner, file))
+	return readFlatTree(&parser);
+    else
+    {
+	IFF_FileReader reader;
+	IFF_initFileReader(&reader, file);
+	return IFF_readFlatTreeReader(&reader.base);
+    }
+}
+
+IFF_FlatTree *IFF_readFlatTree(const char *filename)
+{
+    IFF_FlatTree *tree;
+    FILE *file = fopen(filename, "rb");
+    
+    if(file == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	return NULL;
+    }
+    
+    tree = IFF_readFlatTreeFd(file);
+    fclose(file);
+    
+    return tree;
+}
+
+void IFF_freeFlatTree(IFF_FlatTree *tree)
+{
+    free(tree->chunkId);
+    free(tree->chunkSize);
+    free(tree->offset);
+    free(tree->groupType);
+    free(tree->parent);
+    free(tree->firstChild);
+    free(tree->nextSibling);
+    free(tree);
+}
+
+int IFF_flatNodeIsGroup(const IFF_FlatTree *tree, const unsigned int node)
+{
+    return IFF_isGroupChunkId(tree->chunkId[node]);
+}
+
+/**
+ * Checks whether a node is allowed in its parent, using the same rules as the sub chunk checks of the group chunks.
+ */
+static int checkSubNode(const IFF_FlatTree *tree, const unsigned int parent, const unsigned int node)
+{
+    return IFF_checkChunkPlacement(tree->chunkId[parent], tree->chunkId[node]) &&
+	(!IFF_isGroupChunkId(tree->chunkId[node]) || IFF_checkContentsType(tree->chunkId[parent], tree->groupType[parent], tree->chunkId[node], tree->groupType[node]));
+}
+
+int IFF_checkFlatTree(const IFF_FlatTree *tree)
+{
+    unsigned int node;
+    
+    /* The main chunk must be of ID: FORM, CAT or LIST */
+    if(tree->nodeLength == 0 ||
+       (IFF_compareId(tree->chunkId[0], "FORM") != 0 &&
+	IFF_compareId(tree->chunkId[0], "CAT ") != 0 &&
+	IFF_compareId(tree->chunkId[0], "LIST") != 0))
+    {
+	IFF_error("Not a valid IFF-85 file: First bytes should start with either: 'FORM', 'CAT ' or 'LIST'\n");
+	return FALSE;
+    }
+    
+    for(node = 0; node < tree->nodeLength; node++)
+    {
+	if(!IFF_checkId(tree->chunkId[node]))
+	    return FALSE;
+	
+	if(tree->parent[node] != IFF_FLAT_NO_NODE && !checkSubNode(tree, tree->parent[node], node))
+	    return FALSE;
+	
+	if(IFF_isGroupChunkId(tree->chunkId[node]))
+	{
+	    IFF_Long chunkSize = IFF_ID_SIZE;
+	    unsigned int child;
+	    
+	    /* FORMs and PROPs have a form type, CATs and LISTs a contents type */
+	    if(IFF_compareId(tree->chunkId[node], "FORM") == 0 || IFF_compareId(tree->chunkId[node], "PROP") == 0)
+	    {
+		if(!IFF_checkFormType(tree->groupType[node]))
+		    return FALSE;
+	    }
+	    else if(!IFF_checkId(tree->groupType[node]))
+		return FALSE;
+	    
+	    for(child = tree->firstChild[node]; child != IFF_FLAT_NO_NODE; child = tree->nextSibling[child])
+		chunkSize += HEADER_SIZE + tree->chunkSize[child] + (tree->chunkSize[child] % 2 != 0 ? 1 : 0);
+	    
+	    if(chunkSize != tree->chunkSize[node])
+	    {
+		IFF_error("Chunk size mismatch! ");
+		IFF_errorId(tree->chunkId[node]);
+		IFF_error(" size: %d, while body has: %d\n", tree->chunkSize[node], chunkSize);
+		return FALSE;
+	    }
+	}
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Returns the index of the first node that follows the subtree of the given node.
+ */
+static unsigned int skipSubtree(const IFF_FlatTree *tree, unsigned int node)
+{
+    while(node != IFF_FLAT_NO_NODE && tree->nextSibling[node] == IFF_FLAT_NO_NODE)
+	node = tree->parent[node];
+    
+    if(node == IFF_FLAT_NO_NODE)
+	return tree->nodeLength;
+    else
+	return tree->nextSibling[node];
+}
+
+unsigned int *IFF_searchFlatFormsFromArray(const IFF_FlatTree *tree, const char **formTypes, const unsigned int formTypesLength, unsigned int *formsLength)
+{
+    unsigned int *forms = NULL;
+    unsigned int formsCapacity = 0;
+    unsigned int node = 0;
+    
+    *formsLength = 0;
+    
+    while(node < tree->nodeLength)
+    {
+	int found = FALSE;
+	
+	if(IFF_compareId(tree->chunkId[node], "FORM") == 0)
+	{
+	    unsigned int i;
+	    
+	    for(i = 0; i < formTypesLength; i++)
+	    {
+		if(IFF_compareId(tree->groupType[node], formTypes[i]) == 0)
+		{
+		    found = TRUE;
+		    break;
+		}
+	    }
+	}
+	
+	if(found)
+	{
+	    if(*formsLength == formsCapacity)
+	    {
+		unsigned int *newForms;
+		
+		formsCapacity = formsCapacity == 0 ? 16 : formsCapacity * 2;
+		newForms = (unsigned int*)realloc(forms, formsCapacity * sizeof(unsigned int));
+		
+		if(newForms == NULL)
+		{
+		    free(forms);
+		    *formsLength = 0;
+		    return NULL;
+		}
+		
+		forms = newForms;
+	    }
+	    
+	    forms[*formsLength] = node;
+	    (*formsLength)++;
+	    
+	    /* The forms nested in a matching form are not included */
+	    node = skipSubtree(tree, node);
+	}
+	else
+	    node++;
+    }
+    
+    return forms;
+}
+
+unsigned int *IFF_searchFlatForms(const IFF_FlatTree *tree, const char *formType, unsigned int *formsLength)
+{
+    const char *formTypes[1];
+    formTypes[0] = formType;
+    return IFF_searchFlatFormsFromArray(tree, formTypes, 1, formsLength);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_FLATTREE_H
+#define __IFF_FLATTREE_H
+
+#include <stdio.h>
+#include "ifftypes.h"
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Index that indicates that a node has no parent, child or sibling */
+#define IFF_FLAT_NO_NODE ((unsigned int)-1)
+
+/**
+ * @brief A read-only representation of the chunk structure of an IFF file, in
+ * which the properties of all chunks are stored in contiguous arrays instead of
+ * separately allocated chunks. The bodies of data chunks are not kept in memory.
+ *
+ * Each chunk is a node that is identified by its index in the arrays. The nodes
+ * appear in the same order as the chunks in the file, so that node 0 is the main
+ * chunk and the descendants of a group chunk directly follow it.
+ */
+typedef struct
+{
+    /** Number of nodes in the tree */
+    unsigned int nodeLength;
+    
+    /** Number of nodes for which memory has been allocated */
+    unsigned int nodeCapacity;
+    
+    /** Contains the 4 character chunk ID of each node */
+    IFF_ID *chunkId;
+    
+    /** Contains the size of the chunk data of each node in bytes */
+    IFF_Long *chunkSize;
+    
+    /** Contains the offset of the chunk header of each node in the file */
+    long *offset;
+    
+    /** Contains the group type of each group chunk. The group type of a data chunk consists of zero bytes. */
+    IFF_ID *groupType;
+    
+    /** Contains the index of the group chunk in which each node is located, or IFF_FLAT_NO_NODE for the main chunk */
+    unsigned int *parent;
+    
+    /** Contains the index of the first sub chunk of each node, or IFF_FLAT_NO_NODE if it has none */
+    unsigned int *firstChild;
+    
+    /** Contains the index of the next chunk in the same group of each node, or IFF_FLAT_NO_NODE if it is the last one */
+    unsigned int *nextSibling;
+}
+IFF_FlatTree;
+
+/**
+ * Reads the chunk structure of an IFF file from a reader into a flat tree. The
+ * bodies of data chunks are read, but not kept. The resulting tree must be
+ * freed using IFF_freeFlatTree().
+ *
+ * @param file File descriptor of the file
+ * @return A flat tree derived from the IFF file, or NULL if an error occurs
+ */
+IFF_FlatTree *IFF_readFlatTreeReader(IFF_Reader *file);
+
+/**
+ * Reads the chunk structure of an IFF file from a file stream into a flat tree.
+ * If the stream is seekable, large bodies of data chunks are skipped without
+ * being read. The resulting tree must be freed using IFF_freeFlatTree().
+ *
+ * @param file File descriptor of the file
+ * @return A flat tree derived from the IFF file, or NULL if an error occurs
+ */
+IFF_FlatTree *IFF_readFlatTreeFd(FILE *file);
+
+/**
+ * Reads the chunk structure of an IFF file with the given filename into a flat
+ * tree. The resulting tree must be freed using IFF_freeFlatTree().
+ *
+ * @param filename Filename of the IFF file
+ * @return A flat tree derived from the IFF file, or NULL if an error occurs
+ */
+IFF_FlatTree *IFF_readFlatTree(const char *filename);
+
+/**
+ * Frees a flat tree from memory.
+ *
+ * @param tree A flat tree
+ */
+void IFF_freeFlatTree(IFF_FlatTree *tree);
+
+/**
+ * Checks whether the given node of a flat tree is a group chunk.
+ *
+ * @param tree A flat tree
+ * @param node Index of a node
+ * @return TRUE if the node is a FORM, CAT, LIST or PROP chunk, else FALSE
+ */
+int IFF_flatNodeIsGroup(const IFF_FlatTree *tree, const unsigned int node);
+
+/**
+ * Checks whether the chunk structure in a flat tree conforms to the IFF
+ * specification. As the bodies of data chunks are not available, application
+ * chunks are not checked by extensions.
+ *
+ * @param tree A flat tree
+ * @return TRUE if the chunk structure conforms to the IFF specification, else FALSE
+ */
+int IFF_checkFlatTree(const IFF_FlatTree *tree);
+
+/**
+ * Searches for all FORMs with the given form types in a flat tree. Like
+ * IFF_searchFormsFromArray(), the FORMs nested in a matching FORM are not
+ * included.
+ *
+ * @param tree A flat tree
+ * @param formTypes An array of 4 character form identifiers
+ * @param formTypesLength Length of the form types array
+ * @param formsLength An integer in which the length of the resulting array is stored
+ * @return An array of node indices of the forms having one of the given form types, which must be freed using free()
+ */
+unsigned int *IFF_searchFlatFormsFromArray(const IFF_FlatTree *tree, const char **formTypes, const unsigned int formTypesLength, unsigned int *formsLength);
+
+/**
+ * Searches for all FORMs with the given form type in a flat tree.
+ *
+ * @param tree A flat tree
+ * @param formType A 4 character form identifier
+ * @param formsLength An integer in which the length of the resulting array is stored
+ * @return An array of node indices of the forms having the given form type, which must be freed using free()
+ */
+unsigned int *IFF_searchFlatForms(const IFF_FlatTree *tree, const char *formType, unsigned int *formsLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
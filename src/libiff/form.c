@@ -40,9 +40,28 @@ void IFF_addToForm(IFF_Form *form, IFF_Chunk *chunk)
     IFF_addToGroup((IFF_Group*)form, chunk);
 }
 
+int IFF_removeFromForm(IFF_Form *form, IFF_Chunk *chunk)
+{
+    return IFF_removeFromGroup((IFF_Group*)form, chunk);
+}
+
+static int subChunkCheck(const IFF_Group *group, const IFF_Chunk *subChunk)
+{
+    if(IFF_compareId(subChunk->chunkId, "PROP") == 0)
+    {
+        IFF_error("ERROR: Element with chunk Id: '");
+        IFF_errorId(subChunk->chunkId);
+        IFF_error("' not allowed in FORM chunk!\n");
+	
+        return FALSE;
+    }
+    else
+	return TRUE;
+}
+
 IFF_Form *IFF_readForm(IFF_Reader *file, const IFF_Long chunkSize, const IFF_Extension *extension, const unsigned int extensionLength)
 {
-    return (IFF_Form*)IFF_readGroup(file, FORM_CHUNKID, chunkSize, FORM_GROUPTYPENAME, TRUE, extension, extensionLength);
+    return (IFF_Form*)IFF_readCheckedGroup(file, FORM_CHUNKID, chunkSize, FORM_GROUPTYPENAME, TRUE, &IFF_checkFormType, &subChunkCheck, extension, extensionLength);
 }
 
 int IFF_writeForm(IFF_Writer *file, const IFF_Form *form, const IFF_Extension *extension, const unsigned int extensionLength)
@@ -50,11 +69,31 @@ int IFF_writeForm(IFF_Writer *file, const IFF_Form *form, const IFF_Extension *e
     return IFF_writeGroup(file, (IFF_Group*)form, form->formType, FORM_GROUPTYPENAME, extension, extensionLength);
 }
 
+int IFF_formTypeIsValid(const IFF_ID formType)
+{
+    unsigned int i, invalid = FALSE;
+    
+    if(!IFF_idIsValid(formType) || IFF_idIsReserved(formType))
+	return FALSE;
+    
+    /* A form type is not allowed to have lowercase or puntuaction marks */
+    for(i = 0; i < IFF_ID_SIZE; i++)
+    {
+	IFF_UByte character = formType[i];
+	invalid |= (character - 0x61U < 26U) | (character == '.');
+    }
+    
+    return !invalid;
+}
+
 int IFF_checkFormType(const IFF_ID formType)
 {
     unsigned int i;
     
-    /* A form type must be a valid ID */
+    if(IFF_formTypeIsValid(formType))
+	return TRUE;
+    
+    /* The form type is invalid, find out why. A form type must be a valid ID */
     if(!IFF_checkId(formType))
 	return FALSE;
 
@@ -69,63 +108,11 @@ int IFF_checkFormType(const IFF_ID formType)
     }
     
     /* A form ID is not allowed to be equal to a group chunk ID */
+    IFF_error("Form type: '");
+    IFF_errorId(formType);
+    IFF_error("' not allowed!\n");
     
-    if(IFF_compareId(formType, "LIST") == 0 ||
-       IFF_compareId(formType, "FORM") == 0 ||
-       IFF_compareId(formType, "PROP") == 0 ||
-       IFF_compareId(formType, "CAT ") == 0 ||
-       IFF_compareId(formType, "JJJJ") == 0 ||
-       IFF_compareId(formType, "LIS1") == 0 ||
-       IFF_compareId(formType, "LIS2") == 0 ||
-       IFF_compareId(formType, "LIS3") == 0 ||
-       IFF_compareId(formType, "LIS4") == 0 ||
-       IFF_compareId(formType, "LIS5") == 0 ||
-       IFF_compareId(formType, "LIS6") == 0 ||
-       IFF_compareId(formType, "LIS7") == 0 ||
-       IFF_compareId(formType, "LIS8") == 0 ||
-       IFF_compareId(formType, "LIS9") == 0 ||
-       IFF_compareId(formType, "FOR1") == 0 ||
-       IFF_compareId(formType, "FOR1") == 0 ||
-       IFF_compareId(formType, "FOR2") == 0 ||
-       IFF_compareId(formType, "FOR3") == 0 ||
-       IFF_compareId(formType, "FOR4") == 0 ||
-       IFF_compareId(formType, "FOR5") == 0 ||
-       IFF_compareId(formType, "FOR6") == 0 ||
-       IFF_compareId(formType, "FOR7") == 0 ||
-       IFF_compareId(formType, "FOR8") == 0 ||
-       IFF_compareId(formType, "FOR9") == 0 ||
-       IFF_compareId(formType, "CAT1") == 0 ||
-       IFF_compareId(formType, "CAT2") == 0 ||
-       IFF_compareId(formType, "CAT3") == 0 ||
-       IFF_compareId(formType, "CAT4") == 0 ||
-       IFF_compareId(formType, "CAT5") == 0 ||
-       IFF_compareId(formType, "CAT6") == 0 ||
-       IFF_compareId(formType, "CAT7") == 0 ||
-       IFF_compareId(formType, "CAT8") == 0 ||
-       IFF_compareId(formType, "CAT9") == 0)
-    {
-	IFF_error("Form type: '");
-	IFF_errorId(formType);
-	IFF_error("' not allowed!\n");
-	
-	return FALSE;
-    }
-    
-    return TRUE;
-}
-
-static int subChunkCheck(const IFF_Group *group, const IFF_Chunk *subChunk)
-{
-    if(IFF_compareId(subChunk->chunkId, "PROP") == 0)
-    {
-        IFF_error("ERROR: Element with chunk Id: '");
-        IFF_errorId(subChunk->chunkId);
-        IFF_error("' not allowed in FORM chunk!\n");
-	
-        return FALSE;
-    }
-    else
-	return TRUE;
+    return FALSE;
 }
 
 int IFF_checkForm(const IFF_Form *form, const IFF_Extension *extension, const unsigned int extensionLength)
@@ -69,13 +69,23 @@ IFF_Form *IFF_createForm(const char *formType);
 
 /**
  * Adds a chunk to the body of the given FORM. This function also increments the
- * chunk size and chunk length counter.
+ * chunk size of the FORM and its ancestors and the chunk length counter.
  *
  * @param form An instance of a FORM chunk
  * @param chunk An arbitrary group or data chunk
  */
 void IFF_addToForm(IFF_Form *form, IFF_Chunk *chunk);
 
+/**
+ * Removes a chunk from the body of the given FORM, without freeing it. This function
+ * also decrements the chunk size and chunk length counter.
+ *
+ * @param form An instance of a FORM chunk
+ * @param chunk A sub chunk of the FORM
+ * @return TRUE if the chunk has been removed, FALSE if it is not a sub chunk of the FORM
+ */
+int IFF_removeFromForm(IFF_Form *form, IFF_Chunk *chunk);
+
 /**
  * Reads a form chunk and its sub chunks from a file. The resulting chunk must be
  * freed by using IFF_free().
@@ -107,6 +117,15 @@ int IFF_writeForm(IFF_Writer *file, const IFF_Form *form, const IFF_Extension *e
  */
 int IFF_checkFormType(const IFF_ID formType);
 
+/**
+ * Checks whether the given form type conforms to the IFF specification, like
+ * IFF_checkFormType(), without reporting the reason why it is invalid.
+ *
+ * @param formType A 4 character form identifier
+ * @return TRUE if the form type is valid, else FALSE
+ */
+int IFF_formTypeIsValid(const IFF_ID formType);
+
 /**
  * Checks whether the form chunk and its sub chunks conform to the IFF specification.
  *
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "gatherio.h"
+#include <stdlib.h>
+#include <string.h>
+#include "fileio.h"
+
+#if HAVE_SYS_UIO_H == 1 && HAVE_UNISTD_H == 1
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define IFF_GATHER_WRITEV 1
+#endif
+
+#ifdef IFF_GATHER_WRITEV
+
+static int writeSegments(IFF_GatherWriter *writer)
+{
+    struct iovec iov[IFF_GATHER_MAX_SEGMENTS];
+    int fd = fileno(writer->file);
+    unsigned int first = 0;
+    unsigned int i;
+    
+    for(i = 0; i < writer->segmentLength; i++)
+    {
+	iov[i].iov_base = (void*)writer->segment[i].data;
+	iov[i].iov_len = writer->segment[i].size;
+    }
+    
+    /* writev() may write less than requested, so continue at the first segment that is not completely written */
+    while(first < writer->segmentLength)
+    {
+	ssize_t written = writev(fd, iov + first, writer->segmentLength - first);
+	
+	if(written < 0)
+	{
+	    if(errno == EINTR)
+		continue;
+	    else
+		return FALSE;
+	}
+	
+	while(first < writer->segmentLength && (size_t)written >= iov[first].iov_len)
+	{
+	    written -= iov[first].iov_len;
+	    first++;
+	}
+	
+	if(first < writer->segmentLength)
+	{
+	    iov[first].iov_base = (char*)iov[first].iov_base + written;
+	    iov[first].iov_len -= written;
+	}
+    }
+    
+    return TRUE;
+}
+
+#else
+
+static int writeSegments(IFF_GatherWriter *writer)
+{
+    unsigned int i;
+    
+    for(i = 0; i < writer->segmentLength; i++)
+    {
+	if(fwrite(writer->segment[i].data, sizeof(IFF_UByte), writer->segment[i].size, writer->file) != writer->segment[i].size)
+	    return FALSE;
+    }
+    
+    return TRUE;
+}
+
+#endif
+
+/**
+ * Appends the buffered data that has been written since the last segment as a new segment.
+ */
+static void sealBuffer(IFF_GatherWriter *writer)
+{
+    if(writer->bufferSize > writer->bufferStart)
+    {
+	writer->segment[writer->segmentLength].data = writer->buffer + writer->bufferStart;
+	writer->segment[writer->segmentLength].size = writer->bufferSize - writer->bufferStart;
+	writer->segmentLength++;
+	writer->bufferStart = writer->bufferSize;
+    }
+}
+
+int IFF_flushGatherWriter(IFF_GatherWriter *writer)
+{
+    int status;
+    
+    sealBuffer(writer);
+    status = writeSegments(writer);
+    
+    writer->segmentLength = 0;
+    writer->bufferSize = 0;
+    writer->bufferStart = 0;
+    
+    return status;
+}
+
+static int IFF_gatherWrite(IFF_Writer *file, const void *data, IFF_ULong size)
+{
+    IFF_GatherWriter *writer = (IFF_GatherWriter*)file;
+    
+    if(size > IFF_GATHER_BUFFER_CAPACITY - writer->bufferSize)
+    {
+	if(!IFF_flushGatherWriter(writer))
+	    return FALSE;
+	
+	/* The data does not fit in the buffer at all, so it must be written right away */
+	if(size > IFF_GATHER_BUFFER_CAPACITY)
+	{
+	    writer->segment[0].data = (const IFF_UByte*)data;
+	    writer->segment[0].size = size;
+	    writer->segmentLength = 1;
+	    return IFF_flushGatherWriter(writer);
+	}
+    }
+    
+    memcpy(writer->buffer + writer->bufferSize, data, size);
+    writer->bufferSize += size;
+    
+    return TRUE;
+}
+
+static int IFF_gatherWriteRef(IFF_Writer *file, const void *data, IFF_ULong size)
+{
+    IFF_GatherWriter *writer = (IFF_GatherWriter*)file;
+    
+    if(size < IFF_GATHER_COPY_THRESHOLD)
+	return IFF_gatherWrite(file, data, size);
+    
+    /* We need room for the buffered data in front of it and for the data that is buffered afterwards */
+    if(writer->segmentLength + 3 > IFF_GATHER_MAX_SEGMENTS && !IFF_flushGatherWriter(writer))
+	return FALSE;
+    
+    sealBuffer(writer);
+    writer->segment[writer->segmentLength].data = (const IFF_UByte*)data;
+    writer->segment[writer->segmentLength].size = size;
+    writer->segmentLength++;
+    
+    return TRUE;
+}
+
+/**
+ * Returns the total amount of bytes that are waiting to be written.
+ */
+static IFF_ULong getPendingSize(const IFF_GatherWriter *writer)
+{
+    IFF_ULong pendingSize = writer->bufferSize - writer->bufferStart;
+    unsigned int i;
+    
+    for(i = 0; i < writer->segmentLength; i++)
+	pendingSize += writer->segment[i].size;
+    
+    return pendingSize;
+}
+
+static long IFF_gatherTell(IFF_Writer *file)
+{
+    IFF_GatherWriter *writer = (IFF_GatherWriter*)file;
+#ifdef IFF_GATHER_WRITEV
+    long offset = lseek(fileno(writer->file), 0, SEEK_CUR);
+#else
+    long offset = ftell(writer->file);
+#endif
+    
+    if(offset < 0)
+	return -1;
+    else
+	return offset + getPendingSize(writer);
+}
+
+static int IFF_gatherSeek(IFF_Writer *file, long offset)
+{
+    IFF_GatherWriter *writer = (IFF_GatherWriter*)file;
+    
+    if(!IFF_flushGatherWriter(writer))
+	return FALSE;
+    
+#ifdef IFF_GATHER_WRITEV
+    return (lseek(fileno(writer->file), offset, SEEK_SET) >= 0);
+#else
+    return (fseek(writer->file, offset, SEEK_SET) == 0);
+#endif
+}
+
+static int IFF_gatherCopyFile(IFF_Writer *file, FILE *source, long offset, IFF_ULong size)
+{
+    IFF_GatherWriter *writer = (IFF_GatherWriter*)file;
+    
+    /* The pending data precedes the copied range */
+    if(!IFF_flushGatherWriter(writer))
+	return FALSE;
+    else
+	return IFF_copyFileRange(writer->file, source, offset, size);
+}
+
+static const struct IFF_WriterCallbacks gatherWriterCallbacks =
+{
+    &IFF_gatherWrite,
+    &IFF_gatherTell,
+    &IFF_gatherSeek,
+    &IFF_gatherWriteRef,
+    NULL,
+    NULL,
+    &IFF_gatherCopyFile
+};
+
+int IFF_initGatherWriter(IFF_GatherWriter *writer, FILE *file)
+{
+#ifdef IFF_GATHER_WRITEV
+    /* Streams without a file descriptor, such as memory streams, can only be written through the stream itself */
+    if(fileno(file) < 0)
+	return FALSE;
+#endif
+    
+    writer->base.callbacks = &gatherWriterCallbacks;
+    writer->file = file;
+    writer->segment = (IFF_GatherSegment*)malloc(IFF_GATHER_MAX_SEGMENTS * sizeof(IFF_GatherSegment));
+    writer->segmentLength = 0;
+    writer->buffer = (IFF_UByte*)malloc(IFF_GATHER_BUFFER_CAPACITY);
+    writer->bufferSize = 0;
+    writer->bufferStart = 0;
+    
+    if(writer->segment == NULL || writer->buffer == NULL)
+    {
+	free(writer->segment);
+	free(writer->buffer);
+	return FALSE;
+    }
+    
+#ifdef IFF_GATHER_WRITEV
+    /* We bypass the stream's buffer, so anything that is still in there must be written first */
+    if(fflush(file) != 0)
+    {
+	free(writer->segment);
+	free(writer->buffer);
+	return FALSE;
+    }
+#endif
+    
+    return TRUE;
+}
+
+int IFF_cleanupGatherWriter(IFF_GatherWriter *writer)
+{
+    int status = IFF_flushGatherWriter(writer);
+    
+    free(writer->segment);
+    free(writer->buffer);
+    writer->segment = NULL;
+    writer->buffer = NULL;
+    
+    return status;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_GATHERIO_H
+#define __IFF_GATHERIO_H
+
+#include <stdio.h>
+#include "ifftypes.h"
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum number of segments that a gather writer collects before it flushes them */
+#define IFF_GATHER_MAX_SEGMENTS 1024
+
+/** Capacity of the buffer in which a gather writer collects copied data */
+#define IFF_GATHER_BUFFER_CAPACITY 65536
+
+/** Referenced data smaller than this amount of bytes is copied, as it is cheaper than a separate segment */
+#define IFF_GATHER_COPY_THRESHOLD 512
+
+/**
+ * @brief A contiguous block of data that is waiting to be written
+ */
+typedef struct
+{
+    /** Start of the block */
+    const IFF_UByte *data;
+    
+    /** Size of the block in bytes */
+    IFF_ULong size;
+}
+IFF_GatherSegment;
+
+/**
+ * @brief A writer that writes to a standard C file stream with as few system calls
+ * as possible. Small writes, such as chunk headers, are copied into a buffer, while
+ * data written with IFF_writeDataRef(), such as raw chunk bodies, is referenced
+ * in place. The collected segments are written in one batch using writev() on
+ * systems that provide it, so that chunk bodies are never copied.
+ */
+typedef struct
+{
+    /** Writer base, so that a gather writer can be used as an IFF_Writer */
+    IFF_Writer base;
+    
+    /** File stream to which the data is written */
+    FILE *file;
+    
+    /** Segments that are waiting to be written */
+    IFF_GatherSegment *segment;
+    
+    /** Number of segments that are waiting to be written */
+    unsigned int segmentLength;
+    
+    /** Buffer that contains copies of the data that was written with IFF_writeData() */
+    IFF_UByte *buffer;
+    
+    /** Amount of bytes that are in use in the buffer */
+    IFF_ULong bufferSize;
+    
+    /** Offset of the buffered data that has not been appended as a segment yet */
+    IFF_ULong bufferStart;
+}
+IFF_GatherWriter;
+
+/**
+ * Initializes a gather writer that writes to the given file stream. Data that
+ * has been written to the stream before is flushed first. Streams that are not
+ * backed by a file descriptor, such as memory streams, are not supported.
+ *
+ * @param writer A gather writer instance
+ * @param file File descriptor of the file
+ * @return TRUE if the writer has been successfully initialized, FALSE if the stream is not supported or memory can't be allocated
+ */
+int IFF_initGatherWriter(IFF_GatherWriter *writer, FILE *file);
+
+/**
+ * Writes all segments that are waiting to the file. Afterwards, the data that
+ * was written with IFF_writeDataRef() is no longer referenced.
+ *
+ * @param writer A gather writer instance
+ * @return TRUE if the data has been successfully written, else FALSE
+ */
+int IFF_flushGatherWriter(IFF_GatherWriter *writer);
+
+/**
+ * Flushes the remaining segments of a gather writer and frees its resources.
+ * The file stream is not closed.
+ *
+ * @param writer A gather writer instance
+ * @return TRUE if the remaining data has been successfully written, else FALSE
+ */
+int IFF_cleanupGatherWriter(IFF_GatherWriter *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
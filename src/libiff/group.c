@@ -21,9 +21,11 @@
 
 #include "group.h"
 #include <stdlib.h>
+#include <string.h>
 #include "id.h"
 #include "error.h"
 #include "util.h"
+#include "io.h"
 
 void IFF_initGroup(IFF_Group *group, const char *groupType)
 {
@@ -35,7 +37,7 @@ void IFF_initGroup(IFF_Group *group, const char *groupType)
 
 IFF_Group *IFF_createGroup(const char *chunkId, const char *groupType)
 {
-    IFF_Group *group = (IFF_Group*)IFF_allocateChunk(chunkId, sizeof(IFF_Group));
+    IFF_Group *group = (IFF_Group*)IFF_allocatePooledChunk(chunkId, sizeof(IFF_Group), 0);
     
     if(group != NULL)
 	IFF_initGroup(group, groupType);
@@ -48,21 +50,56 @@ void IFF_addToGroup(IFF_Group *group, IFF_Chunk *chunk)
     group->chunk = (IFF_Chunk**)realloc(group->chunk, (group->chunkLength + 1) * sizeof(IFF_Chunk*));
     group->chunk[group->chunkLength] = chunk;
     group->chunkLength++;
-    group->chunkSize = IFF_incrementChunkSize(group->chunkSize, chunk);
+    IFF_setChunkSize((IFF_Chunk*)group, IFF_incrementChunkSize(group->chunkSize, chunk));
     
+    /* The check of a data chunk depends on the form in which it is located */
     chunk->parent = group;
+    IFF_CHUNK_META(chunk)->flags &= ~IFF_CHUNK_VALIDATED;
 }
 
-IFF_Group *IFF_readGroup(IFF_Reader *file, const char *chunkId, const IFF_Long chunkSize, const char *groupTypeName, const int groupTypeIsFormType, const IFF_Extension *extension, const unsigned int extensionLength)
+int IFF_removeChunkFromArray(IFF_Chunk **chunk, unsigned int *chunkLength, const IFF_Chunk *member)
+{
+    unsigned int i;
+    
+    for(i = 0; i < *chunkLength; i++)
+    {
+	if(chunk[i] == member)
+	{
+	    memmove(chunk + i, chunk + i + 1, (*chunkLength - i - 1) * sizeof(IFF_Chunk*));
+	    (*chunkLength)--;
+	    return TRUE;
+	}
+    }
+    
+    return FALSE;
+}
+
+int IFF_removeFromGroup(IFF_Group *group, IFF_Chunk *chunk)
+{
+    if(IFF_removeChunkFromArray(group->chunk, &group->chunkLength, chunk))
+    {
+	IFF_setChunkSize((IFF_Chunk*)group, IFF_decrementChunkSize(group->chunkSize, chunk));
+	chunk->parent = NULL;
+	return TRUE;
+    }
+    else
+	return FALSE;
+}
+
+IFF_Group *IFF_readCheckedGroup(IFF_Reader *file, const char *chunkId, const IFF_Long chunkSize, const char *groupTypeName, const int groupTypeIsFormType, int (*groupTypeCheck) (const char *groupType), int (*subChunkCheck) (const IFF_Group *group, const IFF_Chunk *subChunk), const IFF_Extension *extension, const unsigned int extensionLength)
 {
     IFF_ID groupType;
     IFF_Group *group;
     char *formType;
+    int check = (file->options & IFF_READ_CHECK) != 0;
     
     /* Read group type */
     if(!IFF_readId(file, groupType, chunkId, groupTypeName))
 	return NULL;
-
+    
+    if(check && groupTypeCheck != NULL && !groupTypeCheck(groupType))
+	return NULL;
+    
     /* Create new group */
     group = IFF_createGroup(chunkId, groupType);
 
@@ -88,6 +125,24 @@ IFF_Group *IFF_readGroup(IFF_Reader *file, const char *chunkId, const IFF_Long c
 	
 	/* Add chunk to the group */
 	IFF_addToGroup(group, chunk);
+	
+	/* The sub chunk itself has already been checked while it was read, only its placement remains */
+	if(check && subChunkCheck != NULL && !subChunkCheck(group, chunk))
+	{
+	    IFF_freeChunk((IFF_Chunk*)group, formType, extension, extensionLength);
+	    return NULL;
+	}
+    }
+    
+    /* The sub chunks may exceed the chunk size */
+    if(check && group->chunkSize != chunkSize)
+    {
+	IFF_Long subChunksSize = group->chunkSize;
+	
+	group->chunkSize = chunkSize;
+	IFF_checkGroupChunkSize(group, subChunksSize);
+	IFF_freeChunk((IFF_Chunk*)group, formType, extension, extensionLength);
+	return NULL;
     }
     
     /*
@@ -101,6 +156,11 @@ IFF_Group *IFF_readGroup(IFF_Reader *file, const char *chunkId, const IFF_Long c
     return group;
 }
 
+IFF_Group *IFF_readGroup(IFF_Reader *file, const char *chunkId, const IFF_Long chunkSize, const char *groupTypeName, const int groupTypeIsFormType, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    return IFF_readCheckedGroup(file, chunkId, chunkSize, groupTypeName, groupTypeIsFormType, NULL, NULL, extension, extensionLength);
+}
+
 int IFF_writeGroupSubChunks(IFF_Writer *file, const IFF_Group *group, const char *formType, const IFF_Extension *extension, const unsigned int extensionLength)
 {
     unsigned int i;
@@ -154,7 +214,7 @@ IFF_Long IFF_checkGroupSubChunks(const IFF_Group *group, int (*subChunkCheck) (c
 	    return -1;
 	
 	/* Check validity of the sub chunk */
-	if(!IFF_checkChunk(subChunk, formType, extension, extensionLength))
+	if(!IFF_checkSubChunk((const IFF_Chunk*)group, subChunk, formType, extension, extensionLength))
 	    return -1;
 	
 	chunkSize = IFF_incrementChunkSize(chunkSize, subChunk);
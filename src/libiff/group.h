@@ -76,13 +76,33 @@ IFF_Group *IFF_createGroup(const char *chunkId, const char *groupType);
 
 /**
  * Adds a chunk to the body of the given group. This function also increments the
- * chunk size and chunk length counter.
+ * chunk size of the group and its ancestors and the chunk length counter.
  *
  * @param group An instance of a group chunk
  * @param chunk An arbitrary group or data chunk
  */
 void IFF_addToGroup(IFF_Group *group, IFF_Chunk *chunk);
 
+/**
+ * Removes a chunk from the body of the given group, without freeing it. This
+ * function also decrements the chunk size and chunk length counter.
+ *
+ * @param group An instance of a group chunk
+ * @param chunk A sub chunk of the group
+ * @return TRUE if the chunk has been removed, FALSE if it is not a sub chunk of the group
+ */
+int IFF_removeFromGroup(IFF_Group *group, IFF_Chunk *chunk);
+
+/**
+ * Removes a chunk pointer from an array of chunk pointers, preserving the order of the remaining elements.
+ *
+ * @param chunk An array of chunk pointers
+ * @param chunkLength Length of the array, which is decremented if the chunk is removed
+ * @param member The chunk to remove
+ * @return TRUE if the chunk has been removed, FALSE if it is not in the array
+ */
+int IFF_removeChunkFromArray(IFF_Chunk **chunk, unsigned int *chunkLength, const IFF_Chunk *member);
+
 /**
  * Reads a group chunk and its sub chunks from a file. The resulting chunk must be
  * freed by using IFF_free().
@@ -98,6 +118,25 @@ void IFF_addToGroup(IFF_Group *group, IFF_Chunk *chunk);
  */
 IFF_Group *IFF_readGroup(IFF_Reader *file, const char *chunkId, const IFF_Long chunkSize, const char *groupTypeName, const int groupTypeIsFormType, const IFF_Extension *extension, const unsigned int extensionLength);
 
+/**
+ * Reads a group chunk and its sub chunks from a file, like IFF_readGroup(). If
+ * the reader has the IFF_READ_CHECK option set, the group type and each sub
+ * chunk are checked as soon as they have been read, and the sizes of the sub
+ * chunks must add up to the given chunk size.
+ *
+ * @param file File descriptor of the file
+ * @param chunkId A 4 character chunk id
+ * @param chunkSize Size of the chunk data
+ * @param groupTypeName Specifies what the group type is called. Could be 'formType' or 'contentsType'
+ * @param groupTypeIsFormType Indicates whether the groupType represents a formType
+ * @param groupTypeCheck Pointer to a function, which checks the groupType for its validity, or NULL
+ * @param subChunkCheck Pointer to a function, which checks an individual sub chunk for its validity, or NULL
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return The group struct derived from the file, or NULL if an error has occured or a check has failed
+ */
+IFF_Group *IFF_readCheckedGroup(IFF_Reader *file, const char *chunkId, const IFF_Long chunkSize, const char *groupTypeName, const int groupTypeIsFormType, int (*groupTypeCheck) (const char *groupType), int (*subChunkCheck) (const IFF_Group *group, const IFF_Chunk *subChunk), const IFF_Extension *extension, const unsigned int extensionLength);
+
 /**
  * Writes all sub chunks inside a group to a file.
  *
@@ -25,6 +25,26 @@
 #include "error.h"
 #include "io.h"
 
+/** Packed values of the group chunk IDs and IDs that are reserved for group chunks, in ascending order */
+static const IFF_ULong reservedIds[] = {
+    IFF_MAKE_ID('C', 'A', 'T', ' '),
+    IFF_MAKE_ID('C', 'A', 'T', '1'), IFF_MAKE_ID('C', 'A', 'T', '2'), IFF_MAKE_ID('C', 'A', 'T', '3'),
+    IFF_MAKE_ID('C', 'A', 'T', '4'), IFF_MAKE_ID('C', 'A', 'T', '5'), IFF_MAKE_ID('C', 'A', 'T', '6'),
+    IFF_MAKE_ID('C', 'A', 'T', '7'), IFF_MAKE_ID('C', 'A', 'T', '8'), IFF_MAKE_ID('C', 'A', 'T', '9'),
+    IFF_MAKE_ID('F', 'O', 'R', '1'), IFF_MAKE_ID('F', 'O', 'R', '2'), IFF_MAKE_ID('F', 'O', 'R', '3'),
+    IFF_MAKE_ID('F', 'O', 'R', '4'), IFF_MAKE_ID('F', 'O', 'R', '5'), IFF_MAKE_ID('F', 'O', 'R', '6'),
+    IFF_MAKE_ID('F', 'O', 'R', '7'), IFF_MAKE_ID('F', 'O', 'R', '8'), IFF_MAKE_ID('F', 'O', 'R', '9'),
+    IFF_MAKE_ID('F', 'O', 'R', 'M'),
+    IFF_MAKE_ID('J', 'J', 'J', 'J'),
+    IFF_MAKE_ID('L', 'I', 'S', '1'), IFF_MAKE_ID('L', 'I', 'S', '2'), IFF_MAKE_ID('L', 'I', 'S', '3'),
+    IFF_MAKE_ID('L', 'I', 'S', '4'), IFF_MAKE_ID('L', 'I', 'S', '5'), IFF_MAKE_ID('L', 'I', 'S', '6'),
+    IFF_MAKE_ID('L', 'I', 'S', '7'), IFF_MAKE_ID('L', 'I', 'S', '8'), IFF_MAKE_ID('L', 'I', 'S', '9'),
+    IFF_MAKE_ID('L', 'I', 'S', 'T'),
+    IFF_MAKE_ID('P', 'R', 'O', 'P')
+};
+
+#define RESERVED_IDS_LENGTH (sizeof(reservedIds) / sizeof(IFF_ULong))
+
 void IFF_createId(IFF_ID id, const char *idString)
 {
     strncpy(id, idString, IFF_ID_SIZE);
@@ -61,7 +81,10 @@ int IFF_checkId(const IFF_ID id)
 {
     unsigned int i;
     
-    /* ID characters must be between 0x20 and 0x7e */
+    if(IFF_idIsValid(id))
+	return TRUE;
+    
+    /* The ID is invalid, find out why. ID characters must be between 0x20 and 0x7e */
     
     for(i = 0; i < IFF_ID_SIZE; i++)
     {
@@ -83,6 +106,42 @@ int IFF_checkId(const IFF_ID id)
     return TRUE;
 }
 
+IFF_ULong IFF_packId(const IFF_ID id)
+{
+    return IFF_MAKE_ID(id[0], id[1], id[2], id[3]);
+}
+
+int IFF_idIsValid(const IFF_ID id)
+{
+    /* Spaces may not precede an ID */
+    unsigned int i, invalid = (id[0] == ' ');
+    
+    /* ID characters must be between 0x20 and 0x7e. Smaller characters wrap around in the unsigned subtraction. */
+    for(i = 0; i < IFF_ID_SIZE; i++)
+	invalid |= ((IFF_UByte)id[i] - 0x20U > 0x7eU - 0x20U);
+    
+    return !invalid;
+}
+
+int IFF_idIsReserved(const IFF_ID id)
+{
+    IFF_ULong packedId = IFF_packId(id);
+    unsigned int low = 0, high = RESERVED_IDS_LENGTH;
+    
+    /* Binary search for the packed ID in the sorted table */
+    while(low < high)
+    {
+	unsigned int middle = (low + high) / 2;
+	
+	if(reservedIds[middle] < packedId)
+	    low = middle + 1;
+	else
+	    high = middle;
+    }
+    
+    return (low < RESERVED_IDS_LENGTH && reservedIds[low] == packedId);
+}
+
 void IFF_printId(const IFF_ID id)
 {
     unsigned int i;
@@ -28,6 +28,9 @@
 extern "C" {
 #endif
 
+/** Packs four characters into the 32-bit value of an ID, in which the first character is the most significant byte */
+#define IFF_MAKE_ID(a, b, c, d) (((IFF_ULong)(IFF_UByte)(a) << 24) | ((IFF_ULong)(IFF_UByte)(b) << 16) | ((IFF_ULong)(IFF_UByte)(c) << 8) | (IFF_ULong)(IFF_UByte)(d))
+
 /**
  * Creates a 4 character ID from a string.
  *
@@ -75,6 +78,35 @@ int IFF_writeId(IFF_Writer *file, const IFF_ID id, const IFF_ID chunkId, const c
  */
 int IFF_checkId(const IFF_ID id);
 
+/**
+ * Packs an IFF id into a 32-bit value, so that it can be compared or looked up
+ * as a single number. The values of packed IDs are ordered in the same way as
+ * IFF_compareId() orders the IDs.
+ *
+ * @param id A 4 character IFF id
+ * @return The 32-bit value of the ID, see IFF_MAKE_ID()
+ */
+IFF_ULong IFF_packId(const IFF_ID id);
+
+/**
+ * Checks whether an IFF id is valid, like IFF_checkId(), without reporting
+ * the reason why it is invalid.
+ *
+ * @param id A 4 character IFF id
+ * @return TRUE if the IFF id is valid, else FALSE
+ */
+int IFF_idIsValid(const IFF_ID id);
+
+/**
+ * Checks whether an IFF id is the ID of a group chunk or is reserved for
+ * future group chunks, such as 'JJJJ' or 'FOR1' to 'FOR9'. Reserved IDs may
+ * not be used as form types.
+ *
+ * @param id A 4 character IFF id
+ * @return TRUE if the IFF id is reserved, else FALSE
+ */
+int IFF_idIsReserved(const IFF_ID id);
+
 /**
  * Prints an IFF id
  *
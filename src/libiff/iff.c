@@ -26,39 +26,24 @@
 #include "util.h"
 #include "error.h"
 #include "io.h"
+#include "fileio.h"
+#include "gatherio.h"
+#include "bodytable.h"
+#include "digest.h"
 
-struct IFF_FileReader {
-    IFF_Reader base;
-    FILE *file;
-};
-
-struct IFF_FileWriter {
-    IFF_Writer base;
-    FILE *file;
-};
-
-static int IFF_fileRead(IFF_Reader *reader, void *data, IFF_ULong size)
+static int checkMainChunkId(const IFF_Chunk *chunk)
 {
-    struct IFF_FileReader *fileReader = (struct IFF_FileReader *)reader;
-    if(fread(data, sizeof(IFF_UByte), size, fileReader->file) == size)
-    {
-        return TRUE;
-    }
-    else
+    /* The main chunk must be of ID: FORM, CAT or LIST */
+    
+    if(IFF_compareId(chunk->chunkId, "FORM") != 0 &&
+       IFF_compareId(chunk->chunkId, "CAT ") != 0 &&
+       IFF_compareId(chunk->chunkId, "LIST") != 0)
     {
+        IFF_error("Not a valid IFF-85 file: First bytes should start with either: 'FORM', 'CAT ' or 'LIST'\n");
         return FALSE;
     }
-}
-
-static const struct IFF_ReaderCallbacks s_readerCallbacks =
-{
-    &IFF_fileRead,
-};
-
-static void IFF_initFileReader(struct IFF_FileReader *fileReader, FILE *file)
-{
-    fileReader->base.callbacks = &s_readerCallbacks;
-    fileReader->file = file;
+    else
+	return TRUE;
 }
 
 IFF_Chunk *IFF_readReader(IFF_Reader *file, const IFF_Extension *extension, const unsigned int extensionLength)
@@ -66,15 +51,37 @@ IFF_Chunk *IFF_readReader(IFF_Reader *file, const IFF_Extension *extension, cons
     IFF_Chunk *chunk;
     IFF_UByte byte;
     
+    /* Identical bodies can only be recognised while the whole file is read */
+    if(file->options & IFF_READ_SHARE_BODIES)
+    {
+	if((file->bodyTable = IFF_createBodyTable()) == NULL)
+	    return NULL;
+    }
+    else
+	file->bodyTable = NULL;
+    
     /* Read the chunk */
     chunk = IFF_readChunk(file, NULL, extension, extensionLength);
     
+    if(file->bodyTable != NULL)
+    {
+	IFF_freeBodyTable(file->bodyTable);
+	file->bodyTable = NULL;
+    }
+    
     if(chunk == NULL)
     {
         IFF_error("ERROR: cannot open main chunk!\n");
         return NULL;
     }
     
+    /* The other checks of IFF_check() have already been done while reading the chunk */
+    if((file->options & IFF_READ_CHECK) && !checkMainChunkId(chunk))
+    {
+	IFF_freeChunk(chunk, NULL, extension, extensionLength);
+	return NULL;
+    }
+    
     /* We should have reached the EOF now */
 
     if (IFF_readData(file, &byte, sizeof(IFF_UByte)) != FALSE)
@@ -86,9 +93,9 @@ IFF_Chunk *IFF_readReader(IFF_Reader *file, const IFF_Extension *extension, cons
 
 IFF_Chunk *IFF_readFd(FILE *file, const IFF_Extension *extension, const unsigned int extensionLength)
 {
-  struct IFF_FileReader fileReader;
-  IFF_initFileReader(&fileReader, file);
-  return IFF_readReader(&fileReader.base, extension, extensionLength);
+    IFF_FileReader fileReader;
+    IFF_initFileReader(&fileReader, file);
+    return IFF_readReader(&fileReader.base, extension, extensionLength);
 }
 
 IFF_Chunk *IFF_read(const char *filename, const IFF_Extension *extension, const unsigned int extensionLength)
@@ -113,28 +120,28 @@ IFF_Chunk *IFF_read(const char *filename, const IFF_Extension *extension, const
     return chunk;
 }
 
-static int IFF_fileWrite(IFF_Writer *writer, const void *data, IFF_ULong size)
+IFF_Chunk *IFF_readFdChecked(FILE *file, const IFF_Extension *extension, const unsigned int extensionLength)
 {
-    struct IFF_FileWriter *fileWriter = (struct IFF_FileWriter *)writer;
-    if(fwrite(data, sizeof(IFF_UByte), size, fileWriter->file) == size)
-    {
-        return TRUE;
-    }
-    else
-    {
-        return FALSE;
-    }
+    IFF_FileReader fileReader;
+    IFF_initFileReader(&fileReader, file);
+    IFF_setReaderOptions(&fileReader.base, IFF_READ_CHECK);
+    return IFF_readReader(&fileReader.base, extension, extensionLength);
 }
 
-static const struct IFF_WriterCallbacks s_writerCallbacks =
+IFF_Chunk *IFF_readChecked(const char *filename, const IFF_Extension *extension, const unsigned int extensionLength)
 {
-    &IFF_fileWrite,
-};
-
-static void IFF_initFileWriter(struct IFF_FileWriter *fileWriter, FILE *file)
-{
-    fileWriter->base.callbacks = &s_writerCallbacks;
-    fileWriter->file = file;
+    IFF_Chunk *chunk;
+    FILE *file = fopen(filename, "rb");
+    
+    if(file == NULL)
+    {
+        IFF_error("ERROR: cannot open file: %s\n", filename);
+        return NULL;
+    }
+    
+    chunk = IFF_readFdChecked(file, extension, extensionLength);
+    fclose(file);
+    return chunk;
 }
 
 int IFF_writeWriter(IFF_Writer *file, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
@@ -144,9 +151,26 @@ int IFF_writeWriter(IFF_Writer *file, const IFF_Chunk *chunk, const IFF_Extensio
 
 int IFF_writeFd(FILE *file, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
 {
-    struct IFF_FileWriter fileWriter;
-    IFF_initFileWriter(&fileWriter, file);
-    return IFF_writeWriter(&fileWriter.base, chunk, extension, extensionLength);
+    IFF_GatherWriter gatherWriter;
+    int status;
+    
+    /* Collect the many small headers in a buffer and refer to the chunk bodies in place, so that they are written in large batches */
+    if(!IFF_initGatherWriter(&gatherWriter, file))
+    {
+	IFF_FileWriter fileWriter;
+	IFF_initFileWriter(&fileWriter, file);
+	return IFF_writeWriter(&fileWriter.base, chunk, extension, extensionLength);
+    }
+    
+    status = IFF_writeWriter(&gatherWriter.base, chunk, extension, extensionLength);
+    
+    if(!IFF_cleanupGatherWriter(&gatherWriter))
+    {
+	IFF_error("ERROR: cannot write buffered data!\n");
+	status = FALSE;
+    }
+    
+    return status;
 }
 
 int IFF_write(const char *filename, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
@@ -172,17 +196,12 @@ void IFF_free(IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned i
 
 int IFF_check(const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
 {
-    /* The main chunk must be of ID: FORM, CAT or LIST */
-    
-    if(IFF_compareId(chunk->chunkId, "FORM") != 0 &&
-       IFF_compareId(chunk->chunkId, "CAT ") != 0 &&
-       IFF_compareId(chunk->chunkId, "LIST") != 0)
-    {
-        IFF_error("Not a valid IFF-85 file: First bytes should start with either: 'FORM', 'CAT ' or 'LIST'\n");
-        return FALSE;
-    }
-    else
-        return IFF_checkChunk(chunk, NULL, extension, extensionLength);
+    return checkMainChunkId(chunk) && IFF_checkChunk(chunk, NULL, extension, extensionLength);
+}
+
+int IFF_checkCached(IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    return checkMainChunkId(chunk) && IFF_checkChunkCached(chunk, NULL, extension, extensionLength);
 }
 
 void IFF_print(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_Extension *extension, const unsigned int extensionLength)
@@ -194,3 +213,14 @@ int IFF_compare(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_Exte
 {
     return IFF_compareChunk(chunk1, chunk2, NULL, extension, extensionLength);
 }
+
+int IFF_compareCached(IFF_Chunk *chunk1, IFF_Chunk *chunk2, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_Digest digest;
+    
+    /* Chunks of which the digest cannot be computed, because their bodies are not in memory, are compared directly */
+    IFF_cacheChunkDigest(chunk1, NULL, extension, extensionLength, &digest);
+    IFF_cacheChunkDigest(chunk2, NULL, extension, extensionLength, &digest);
+    
+    return IFF_compareChunk(chunk1, chunk2, NULL, extension, extensionLength);
+}
@@ -60,6 +60,31 @@ IFF_Chunk *IFF_readFd(FILE *file, const IFF_Extension *extension, const unsigned
  */
 IFF_Chunk *IFF_read(const char *filename, const IFF_Extension *extension, const unsigned int extensionLength);
 
+/**
+ * Reads an IFF file from a given file descriptor and checks whether it conforms
+ * to the IFF specification while it is read, so that it does not have to be
+ * traversed again by IFF_check(). Reading stops at the first violation. The
+ * resulting chunk must be freed using IFF_free().
+ *
+ * @param file File descriptor of the file
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return A valid chunk hierarchy derived from the IFF file, or NULL if an error occurs or the file is invalid
+ */
+IFF_Chunk *IFF_readFdChecked(FILE *file, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Reads an IFF file with the given filename and checks whether it conforms to
+ * the IFF specification while it is read, like IFF_readFdChecked(). The
+ * resulting chunk must be freed using IFF_free().
+ *
+ * @param filename Filename of the file
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return A valid chunk hierarchy derived from the IFF file, or NULL if an error occurs or the file is invalid
+ */
+IFF_Chunk *IFF_readChecked(const char *filename, const IFF_Extension *extension, const unsigned int extensionLength);
+
 /**
  * Writes an IFF file to a given file writer.
  *
@@ -103,7 +128,8 @@ int IFF_write(const char *filename, const IFF_Chunk *chunk, const IFF_Extension
 void IFF_free(IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength);
 
 /**
- * Checks whether an IFF file conforms to the IFF specification.
+ * Checks whether an IFF file conforms to the IFF specification. The hierarchy is
+ * not modified, so it may be checked by multiple threads at the same time.
  *
  * @param chunk A chunk hierarchy representing an IFF file
  * @param extension Extension array which specifies how application file format chunks can be handled
@@ -112,6 +138,19 @@ void IFF_free(IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned i
  */
 int IFF_check(const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength);
 
+/**
+ * Checks whether an IFF file conforms to the IFF specification, like
+ * IFF_check(), and caches the outcome in the chunks, so that checking the
+ * hierarchy again after it has been modified only revisits the modified parts.
+ * The hierarchy must not be accessed by other threads while it is checked.
+ *
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the IFF file conforms to the IFF specification, else FALSE
+ */
+int IFF_checkCached(IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength);
+
 /**
  * Displays a textual representation of an IFF file on the standard output.
  *
@@ -123,7 +162,10 @@ int IFF_check(const IFF_Chunk *chunk, const IFF_Extension *extension, const unsi
 void IFF_print(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_Extension *extension, const unsigned int extensionLength);
 
 /**
- * Checks whether two given IFF files are equal.
+ * Checks whether two given IFF files are equal. Sub trees of which both digests
+ * have been cached by IFF_compareCached() or IFF_cacheChunkDigest() and differ
+ * are considered different without comparing their contents. The hierarchies are
+ * not modified, so they may be compared by multiple threads at the same time.
  *
  * @param chunk1 Chunk hierarchy to compare
  * @param chunk2 Chunk hierarchy to compare
@@ -133,6 +175,22 @@ void IFF_print(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF
  */
 int IFF_compare(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_Extension *extension, const unsigned int extensionLength);
 
+/**
+ * Checks whether two given IFF files are equal, like IFF_compare(). The digests
+ * of both hierarchies are computed and cached first, so that hierarchies that
+ * differ are usually told apart by their digests, and comparing a hierarchy
+ * again after it has been modified only has to rehash the modified chunks and
+ * their ancestors. The hierarchies must not be accessed by other threads while
+ * they are compared.
+ *
+ * @param chunk1 Chunk hierarchy to compare
+ * @param chunk2 Chunk hierarchy to compare
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the given chunk hierarchies are equal, else FALSE
+ */
+int IFF_compareCached(IFF_Chunk *chunk1, IFF_Chunk *chunk2, const IFF_Extension *extension, const unsigned int extensionLength);
+
 #ifdef __cplusplus
 }
 #endif
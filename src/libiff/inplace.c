@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "inplace.h"
+#include <stdio.h>
+#include <string.h>
+#include "iff.h"
+#include "id.h"
+#include "io.h"
+#include "error.h"
+#include "fileio.h"
+#include "bufio.h"
+#include "group.h"
+#include "list.h"
+
+#if HAVE_UNISTD_H == 1
+#include <unistd.h>
+#endif
+
+#define HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long))
+#define GROUP_HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long) + IFF_ID_SIZE)
+
+/**
+ * @brief A writer that discards the given amount of leading bytes and passes the remaining bytes to another writer
+ */
+typedef struct
+{
+    IFF_Writer base;
+    IFF_Writer *writer;
+    long skip;
+}
+IFF_SkipWriter;
+
+static int IFF_skipWrite(IFF_Writer *writer, const void *data, IFF_ULong size)
+{
+    IFF_SkipWriter *skipWriter = (IFF_SkipWriter*)writer;
+    
+    if(skipWriter->skip >= (long)size)
+    {
+	skipWriter->skip -= size;
+	return TRUE;
+    }
+    else
+    {
+	const IFF_UByte *bytes = (const IFF_UByte*)data + skipWriter->skip;
+	IFF_ULong remaining = size - skipWriter->skip;
+	
+	skipWriter->skip = 0;
+	return IFF_writeData(skipWriter->writer, bytes, remaining);
+    }
+}
+
+static const struct IFF_WriterCallbacks skipWriterCallbacks =
+{
+    &IFF_skipWrite,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+static int isGroupChunk(const IFF_Chunk *chunk)
+{
+    return (IFF_compareId(chunk->chunkId, "FORM") == 0 ||
+	IFF_compareId(chunk->chunkId, "CAT ") == 0 ||
+	IFF_compareId(chunk->chunkId, "LIST") == 0 ||
+	IFF_compareId(chunk->chunkId, "PROP") == 0);
+}
+
+static int patchChunk(IFF_Writer *writer, const IFF_Chunk *chunk, const char *formType, const long offset, const unsigned long sourceId, const IFF_Extension *extension, const unsigned int extensionLength, long *rewriteOffset);
+
+static int patchSubChunks(IFF_Writer *writer, IFF_Chunk **subChunk, const unsigned int subChunkLength, const char *formType, long *offset, const unsigned long sourceId, const IFF_Extension *extension, const unsigned int extensionLength, long *rewriteOffset)
+{
+    unsigned int i;
+    
+    for(i = 0; i < subChunkLength; i++)
+    {
+	if(!patchChunk(writer, subChunk[i], formType, *offset, sourceId, extension, extensionLength, rewriteOffset))
+	    return FALSE;
+	
+	if(*rewriteOffset >= 0)
+	    break;
+	
+	*offset += IFF_incrementChunkSize(0, subChunk[i]);
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Patches the given chunk at the given offset in the file, in which it must have
+ * been stored before. Stops at the first chunk that has been moved, added,
+ * resized or read from another source and stores its offset in rewriteOffset.
+ */
+static int patchChunk(IFF_Writer *writer, const IFF_Chunk *chunk, const char *formType, const long offset, const unsigned long sourceId, const IFF_Extension *extension, const unsigned int extensionLength, long *rewriteOffset)
+{
+    if(IFF_CHUNK_META(chunk)->sourceId != sourceId || IFF_CHUNK_META(chunk)->sourceOffset != offset)
+    {
+	/* The chunk has been moved or does not originate from the file, so everything from here must be rewritten */
+	*rewriteOffset = offset;
+	return TRUE;
+    }
+    else if(IFF_chunkIsClean(chunk))
+	return TRUE; /* The file already contains exactly these bytes */
+    else if(isGroupChunk(chunk))
+    {
+	const IFF_Group *group = (const IFF_Group*)chunk;
+	const char *subFormType;
+	long subOffset = offset + GROUP_HEADER_SIZE;
+	
+	if(IFF_compareId(chunk->chunkId, "FORM") == 0 || IFF_compareId(chunk->chunkId, "PROP") == 0)
+	    subFormType = group->groupType;
+	else
+	    subFormType = NULL;
+	
+	/* The size or group type may have changed, which is cheap to rewrite */
+	if(!IFF_seekWriter(writer, offset) ||
+	    !IFF_writeChunkHeader(writer, chunk->chunkId, chunk->chunkSize) ||
+	    !IFF_writeId(writer, group->groupType, chunk->chunkId, "groupType"))
+	    return FALSE;
+	
+	/* The PROP chunks of a LIST precede the other sub chunks */
+	if(IFF_compareId(chunk->chunkId, "LIST") == 0)
+	{
+	    const IFF_List *list = (const IFF_List*)chunk;
+	    
+	    if(!patchSubChunks(writer, (IFF_Chunk**)list->prop, list->propLength, NULL, &subOffset, sourceId, extension, extensionLength, rewriteOffset))
+		return FALSE;
+	    
+	    if(*rewriteOffset >= 0)
+		return TRUE;
+	}
+	
+	return patchSubChunks(writer, group->chunk, group->chunkLength, subFormType, &subOffset, sourceId, extension, extensionLength, rewriteOffset);
+    }
+    else if(chunk->chunkSize != IFF_CHUNK_META(chunk)->sourceSize)
+    {
+	/* A data chunk that has been resized shifts everything behind it */
+	*rewriteOffset = offset;
+	return TRUE;
+    }
+    else
+    {
+	/* A modified data chunk of the same size can be overwritten */
+	return (IFF_seekWriter(writer, offset) &&
+	    IFF_writeChunk(writer, chunk, formType, extension, extensionLength));
+    }
+}
+
+/**
+ * Serializes the entire chunk hierarchy, but only writes the bytes from the given offset onwards.
+ */
+static int rewriteFrom(IFF_Writer *writer, const IFF_Chunk *chunk, const long offset, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_BufferedWriter bufferedWriter;
+    IFF_SkipWriter skipWriter;
+    int status;
+    
+    if(!IFF_seekWriter(writer, offset))
+	return FALSE;
+    
+    if(!IFF_initBufferedWriter(&bufferedWriter, writer, IFF_DEFAULT_BUFFER_CAPACITY))
+	return FALSE;
+    
+    skipWriter.base.callbacks = &skipWriterCallbacks;
+    skipWriter.writer = &bufferedWriter.base;
+    skipWriter.skip = offset;
+    
+    status = IFF_writeChunk(&skipWriter.base, chunk, NULL, extension, extensionLength);
+    
+    if(!IFF_cleanupBufferedWriter(&bufferedWriter))
+	status = FALSE;
+    
+    return status;
+}
+
+/**
+ * Records that the given chunk hierarchy is stored at the given offset in the file with the given identity and is identical to it.
+ */
+static void recordLayout(IFF_Chunk *chunk, const long offset, const unsigned long sourceId)
+{
+    if(isGroupChunk(chunk))
+    {
+	IFF_Group *group = (IFF_Group*)chunk;
+	long subOffset = offset + GROUP_HEADER_SIZE;
+	unsigned int i;
+	
+	if(IFF_compareId(chunk->chunkId, "LIST") == 0)
+	{
+	    IFF_List *list = (IFF_List*)chunk;
+	    
+	    for(i = 0; i < list->propLength; i++)
+	    {
+		recordLayout((IFF_Chunk*)list->prop[i], subOffset, sourceId);
+		subOffset = IFF_incrementChunkSize(subOffset, (IFF_Chunk*)list->prop[i]);
+	    }
+	}
+	
+	for(i = 0; i < group->chunkLength; i++)
+	{
+	    recordLayout(group->chunk[i], subOffset, sourceId);
+	    subOffset = IFF_incrementChunkSize(subOffset, group->chunk[i]);
+	}
+    }
+    
+    IFF_CHUNK_META(chunk)->sourceOffset = offset;
+    IFF_CHUNK_META(chunk)->sourceSize = chunk->chunkSize;
+    IFF_CHUNK_META(chunk)->sourceId = sourceId;
+    IFF_CHUNK_META(chunk)->flags &= ~IFF_CHUNK_DIRTY;
+}
+
+/**
+ * Checks whether the file starts with the header of the given root chunk, as it
+ * was read, and has the corresponding size. Otherwise, the hierarchy has not been
+ * read from this file and its offsets are meaningless.
+ */
+static int checkRootHeader(FILE *file, const IFF_Chunk *chunk, const long fileSize)
+{
+    IFF_Long sourceSize = IFF_CHUNK_META(chunk)->sourceSize;
+    IFF_UByte header[HEADER_SIZE];
+    IFF_ULong chunkSize;
+    
+    if(fileSize != (long)HEADER_SIZE + sourceSize + (sourceSize % 2) ||
+	fseek(file, 0, SEEK_SET) != 0 ||
+	fread(header, sizeof(IFF_UByte), HEADER_SIZE, file) != HEADER_SIZE)
+	return FALSE;
+    
+    chunkSize = (IFF_ULong)header[4] << 24 | (IFF_ULong)header[5] << 16 | (IFF_ULong)header[6] << 8 | (IFF_ULong)header[7];
+    
+    return (memcmp(header, chunk->chunkId, IFF_ID_SIZE) == 0 && (IFF_Long)chunkSize == sourceSize);
+}
+
+/**
+ * Writes the complete file and records the resulting layout.
+ */
+static int writeCompletely(const char *filename, IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    if(IFF_write(filename, chunk, extension, extensionLength))
+    {
+	recordLayout(chunk, 0, IFF_createSourceId());
+	return TRUE;
+    }
+    else
+	return FALSE;
+}
+
+int IFF_writeInPlace(const char *filename, IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    FILE *file;
+    IFF_FileWriter fileWriter;
+    long fileSize;
+    long newFileSize = IFF_incrementChunkSize(0, chunk);
+    long rewriteOffset = -1;
+    int status;
+    
+    /* If the hierarchy has not been read from a file, there is nothing to reuse */
+    if(IFF_CHUNK_META(chunk)->sourceOffset != 0)
+	return writeCompletely(filename, chunk, extension, extensionLength);
+    
+    file = fopen(filename, "r+b");
+    
+    if(file == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	return FALSE;
+    }
+    
+    if(fseek(file, 0, SEEK_END) != 0 || (fileSize = ftell(file)) < 0)
+    {
+	IFF_error("ERROR: cannot determine the size of file: %s\n", filename);
+	fclose(file);
+	return FALSE;
+    }
+    
+    /* The hierarchy may have been read from another file */
+    if(!checkRootHeader(file, chunk, fileSize))
+    {
+	fclose(file);
+	return writeCompletely(filename, chunk, extension, extensionLength);
+    }
+    
+#if HAVE_UNISTD_H != 1
+    /* Without a way to truncate the file, a file that shrinks must be written completely */
+    if(newFileSize < fileSize)
+    {
+	fclose(file);
+	return writeCompletely(filename, chunk, extension, extensionLength);
+    }
+#endif
+    
+    IFF_initFileWriter(&fileWriter, file);
+    
+    status = patchChunk(&fileWriter.base, chunk, NULL, 0, IFF_CHUNK_META(chunk)->sourceId, extension, extensionLength, &rewriteOffset);
+    
+    if(status && rewriteOffset >= 0)
+	status = rewriteFrom(&fileWriter.base, chunk, rewriteOffset, extension, extensionLength);
+    
+#if HAVE_UNISTD_H == 1
+    if(status && newFileSize < fileSize)
+	status = (fflush(file) == 0 && ftruncate(fileno(file), newFileSize) == 0);
+#endif
+    
+    if(fclose(file) != 0)
+	status = FALSE;
+    
+    if(status)
+	recordLayout(chunk, 0, IFF_createSourceId());
+    else
+	IFF_error("ERROR: cannot write file in place: %s\n", filename);
+    
+    return status;
+}
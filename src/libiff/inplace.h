@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_INPLACE_H
+#define __IFF_INPLACE_H
+
+#include "ifftypes.h"
+#include "chunk.h"
+#include "extension.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Writes a modified chunk hierarchy back to the file from which it has been read,
+ * only touching the regions that have changed. Chunks that are still at the
+ * position and have the size they had in the file are patched in place, and
+ * unmodified chunks are skipped entirely. From the first chunk whose position or
+ * size has changed onwards, the remainder of the file is rewritten. If the file
+ * becomes smaller, it is truncated.
+ *
+ * The chunk hierarchy must have been read from the same file, and modifications
+ * that do not go through the library functions must be reported with
+ * IFF_markChunkDirty(). Chunks that have been moved into the hierarchy from a
+ * hierarchy that has been read separately are rewritten. If the hierarchy does
+ * not originate from a file, or the file does not start with the header of its
+ * root chunk, the file is written completely. Afterwards, the hierarchy refers to the new layout
+ * of the file and is considered unmodified again.
+ *
+ * @param filename Filename of the file from which the chunk hierarchy has been read
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the file has been successfully written, else FALSE
+ */
+int IFF_writeInPlace(const char *filename, IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -21,6 +21,38 @@
 
 #include "io.h"
 #include "error.h"
+#include "fileio.h"
+
+/** Size of the blocks in which file data is written, if the writer cannot copy it by itself */
+#define FILE_DATA_BLOCK_SIZE 65536
+
+/** The most recently created source identity */
+static unsigned long lastSourceId = 0;
+
+unsigned long IFF_createSourceId(void)
+{
+    /* Readers may be initialised by different threads */
+#if HAVE_SYNC_BUILTINS == 1
+    return __sync_add_and_fetch(&lastSourceId, 1);
+#else
+    return ++lastSourceId;
+#endif
+}
+
+void IFF_initReader(IFF_Reader *reader, const struct IFF_ReaderCallbacks *callbacks)
+{
+    reader->callbacks = callbacks;
+    reader->bodySinks = NULL;
+    reader->bodySinksLength = 0;
+    reader->options = 0;
+    reader->bodyTable = NULL;
+    reader->sourceId = IFF_createSourceId();
+}
+
+void IFF_setReaderOptions(IFF_Reader *reader, const unsigned int options)
+{
+    reader->options = options;
+}
 
 int IFF_readUByte(IFF_Reader *file, IFF_UByte *value, const IFF_ID chunkId, const char *attributeName)
 {
@@ -204,6 +236,52 @@ int IFF_writeLong(IFF_Writer *file, const IFF_Long value, const IFF_ID chunkId,
     }
 }
 
+int IFF_writeChunkHeader(IFF_Writer *file, const IFF_ID chunkId, const IFF_Long chunkSize)
+{
+    IFF_UByte header[IFF_ID_SIZE + sizeof(IFF_Long)];
+    IFF_ULong size = chunkSize;
+    unsigned int i;
+    
+    for(i = 0; i < IFF_ID_SIZE; i++)
+	header[i] = chunkId[i];
+    
+    /* Store the size in big endian byte order */
+    header[4] = (size >> 24) & 0xff;
+    header[5] = (size >> 16) & 0xff;
+    header[6] = (size >> 8) & 0xff;
+    header[7] = size & 0xff;
+    
+    if(IFF_writeData(file, header, sizeof(header)) == TRUE)
+	return TRUE;
+    else
+    {
+	IFF_writeError(chunkId, "chunkHeader");
+	return FALSE;
+    }
+}
+
+int IFF_writeFileData(IFF_Writer *file, FILE *source, long offset, const IFF_ULong size)
+{
+    IFF_UByte block[FILE_DATA_BLOCK_SIZE];
+    IFF_ULong remaining = size;
+    
+    if(file->callbacks->copyFile != NULL)
+	return file->callbacks->copyFile(file, source, offset, size);
+    
+    while(remaining > 0)
+    {
+	IFF_ULong blockSize = remaining < FILE_DATA_BLOCK_SIZE ? remaining : FILE_DATA_BLOCK_SIZE;
+	
+	if(!IFF_readFileRange(source, offset, block, blockSize) || IFF_writeData(file, block, blockSize) != TRUE)
+	    return FALSE;
+	
+	offset += blockSize;
+	remaining -= blockSize;
+    }
+    
+    return TRUE;
+}
+
 int IFF_readPaddingByte(IFF_Reader *file, const IFF_Long chunkSize, const IFF_ID chunkId)
 {
     if(chunkSize % 2 != 0) /* Check whether the chunk size is an odd number */
@@ -22,30 +22,132 @@
 #ifndef __IFF_IO_H
 #define __IFF_IO_H
 
+#include <stdio.h>
 #include "ifftypes.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Declared in chunk.h, which depends on this header */
+struct IFF_Chunk;
+
+/* Declared in bodysink.h, which depends on this header */
+struct IFF_BodySink;
+
+/* Declared in bodytable.h */
+struct IFF_BodyTable;
+
 struct IFF_ReaderCallbacks {
   int (*read) (IFF_Reader *file, void *data, IFF_ULong size);
+  
+  /* Optional: returns the offset of the next byte to read, or -1 if it is unknown */
+  long (*tell) (IFF_Reader *file);
 };
 
 struct IFF_Reader {
   const struct IFF_ReaderCallbacks *callbacks;
+  
+  /* Sinks that receive the bodies of raw chunks with particular chunk ids, see IFF_setBodySinks() */
+  const struct IFF_BodySink *bodySinks;
+  unsigned int bodySinksLength;
+  
+  /* Options that control how chunks are read and stored in memory, such as IFF_READ_INLINE_BODIES, see IFF_setReaderOptions() */
+  unsigned int options;
+  
+  /* Identity of the source, which is recorded in the metadata of every chunk that is read, see IFF_createSourceId() */
+  unsigned long sourceId;
+  
+  /* Distinct bodies that have been read so far, if IFF_READ_SHARE_BODIES is set, or NULL. Only maintained by IFF_readReader() */
+  struct IFF_BodyTable *bodyTable;
 };
 
 struct IFF_WriterCallbacks {
   int (*write) (IFF_Writer *file, const void *data, IFF_ULong size);
+  
+  /* Optional: returns the current position in the output, or -1 if the output is not seekable */
+  long (*tell) (IFF_Writer *file);
+  
+  /* Optional: moves the current position to the given absolute offset */
+  int (*seek) (IFF_Writer *file, long offset);
+  
+  /* Optional: writes data without copying it. The data must stay valid until the writer has been flushed */
+  int (*writeRef) (IFF_Writer *file, const void *data, IFF_ULong size);
+  
+  /* Optional: writes an unmodified chunk by copying its bytes from the file from which it has been read */
+  int (*copyChunk) (IFF_Writer *file, const struct IFF_Chunk *chunk);
+  
+  /* Optional: checks whether an unmodified chunk originates from the file from which copyChunk copies. If it is not provided, all unmodified chunks are copied */
+  int (*hasChunk) (IFF_Writer *file, const struct IFF_Chunk *chunk);
+  
+  /* Optional: writes a range of bytes of another file, preferably without passing it through a user space buffer */
+  int (*copyFile) (IFF_Writer *file, FILE *source, long offset, IFF_ULong size);
 };
 
 struct IFF_Writer {
   const struct IFF_WriterCallbacks *callbacks;
 };
 
+/** Reader option that stores small raw chunk bodies in the same allocation as the chunk itself */
+#define IFF_READ_INLINE_BODIES 0x1
+
+/** Reader option that stores identical raw chunk bodies only once, as shared data */
+#define IFF_READ_SHARE_BODIES 0x2
+
+/** Reader option that checks every chunk for conformance to the IFF specification while it is read */
+#define IFF_READ_CHECK 0x4
+
 #define IFF_readData(file, data, size) (file)->callbacks->read((file), (data), (size))
+#define IFF_tellReader(file) ((file)->callbacks->tell == NULL ? -1L : (file)->callbacks->tell(file))
 #define IFF_writeData(file, data, size) (file)->callbacks->write((file), (data), (size))
+#define IFF_writeDataRef(file, data, size) ((file)->callbacks->writeRef == NULL ? (file)->callbacks->write((file), (data), (size)) : (file)->callbacks->writeRef((file), (data), (size)))
+#define IFF_tellWriter(file) ((file)->callbacks->tell == NULL ? -1L : (file)->callbacks->tell(file))
+#define IFF_seekWriter(file, offset) ((file)->callbacks->seek == NULL ? FALSE : (file)->callbacks->seek((file), (offset)))
+
+/**
+ * Initialises the common part of a reader. Every reader, including readers
+ * with custom callbacks, must be initialised with this function before any
+ * other function is applied to it, because it resets all the fields that the
+ * library maintains, such as the body sinks and the reader options, and gives
+ * the reader a new source identity.
+ *
+ * @param reader A reader instance
+ * @param callbacks Callbacks that read data from the underlying source
+ */
+void IFF_initReader(IFF_Reader *reader, const struct IFF_ReaderCallbacks *callbacks);
+
+/**
+ * Creates a new identity for a source of chunks, such as a reader or a file that
+ * has been written. Every call returns a different, non-zero value. The identity
+ * is recorded in the metadata of the chunks, so that writers that reuse the bytes
+ * of unmodified chunks can verify that the chunks originate from their file.
+ *
+ * @return A new source identity
+ */
+unsigned long IFF_createSourceId(void);
+
+/**
+ * Sets the options that control how the chunks are read by the given reader and
+ * how they are stored in memory.
+ *
+ * With IFF_READ_INLINE_BODIES, raw chunk bodies of at most IFF_INLINE_BODY_SIZE
+ * bytes are stored behind the chunk in the same allocation. The chunk data of
+ * such chunks must not be passed to free(). Replacing it with
+ * IFF_setRawChunkData() is allowed.
+ *
+ * With IFF_READ_SHARE_BODIES, IFF_readReader() hashes every raw chunk body and
+ * lets chunks with identical bodies refer to the same shared data, see
+ * IFF_setRawChunkSharedData(). Shared bodies must not be modified. This option
+ * takes precedence over IFF_READ_INLINE_BODIES.
+ *
+ * With IFF_READ_CHECK, every chunk is subjected to the checks of IFF_check()
+ * as soon as it has been read, and reading stops at the first violation. A
+ * hierarchy that has been read successfully does not have to be checked again.
+ *
+ * @param reader A reader instance
+ * @param options A bitwise or of reader options, or 0 to use the defaults
+ */
+void IFF_setReaderOptions(IFF_Reader *reader, const unsigned int options);
 
 /**
  * Reads an unsigned byte from a file.
@@ -157,6 +259,29 @@ int IFF_readLong(IFF_Reader *file, IFF_Long *value, const IFF_ID chunkId, const
  */
 int IFF_writeLong(IFF_Writer* file, const IFF_Long value, const IFF_ID chunkId, const char *attributeName);
 
+/**
+ * Writes a chunk header, consisting of the chunk id and the chunk size, to a file
+ * in a single write operation.
+ *
+ * @param file File descriptor of the file
+ * @param chunkId A 4 character chunk id
+ * @param chunkSize Size of the chunk data in bytes
+ * @return TRUE if the header has been successfully written, else FALSE
+ */
+int IFF_writeChunkHeader(IFF_Writer *file, const IFF_ID chunkId, const IFF_Long chunkSize);
+
+/**
+ * Writes a range of bytes of another file. If the writer supports it, the bytes are
+ * transferred without being copied into memory. Otherwise, they are read in blocks.
+ *
+ * @param file File descriptor of the file
+ * @param source File descriptor of the file from which the bytes are read
+ * @param offset Offset of the first byte to write in the source file
+ * @param size Amount of bytes to write
+ * @return TRUE if the bytes have been successfully written, else FALSE
+ */
+int IFF_writeFileData(IFF_Writer *file, FILE *source, long offset, const IFF_ULong size);
+
 /**
  * Reads a padding byte from a chunk with an odd size.
  *
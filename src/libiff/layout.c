@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "layout.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id.h"
+#include "util.h"
+#include "error.h"
+
+/** Size of the buffer on the stack that is used to read or write bodies. Larger bodies use a buffer on the heap. */
+#define LAYOUT_BUFFER_SIZE 256
+
+/**
+ * Returns the size of an element of the given field type, which is the same
+ * in the chunk body and in the chunk struct.
+ */
+static size_t fieldSize(const IFF_FieldType type)
+{
+    switch(type)
+    {
+	case IFF_FIELD_UBYTE:
+	case IFF_FIELD_BYTE:
+	    return 1;
+	case IFF_FIELD_UWORD:
+	case IFF_FIELD_WORD:
+	    return 2;
+	default:
+	    return 4;
+    }
+}
+
+static IFF_UByte *getMember(const IFF_Chunk *chunk, const IFF_Field *field, const unsigned int index)
+{
+    return (IFF_UByte*)chunk + field->offset + index * fieldSize(field->type);
+}
+
+/**
+ * Decodes a big endian element from the buffer into a struct member.
+ */
+static void decodeElement(const IFF_FieldType type, const IFF_UByte *buffer, IFF_UByte *member)
+{
+    switch(type)
+    {
+	case IFF_FIELD_UBYTE:
+	    *((IFF_UByte*)member) = buffer[0];
+	    break;
+	case IFF_FIELD_BYTE:
+	    *((IFF_Byte*)member) = (IFF_Byte)buffer[0];
+	    break;
+	case IFF_FIELD_UWORD:
+	    *((IFF_UWord*)member) = (IFF_UWord)(buffer[0] << 8 | buffer[1]);
+	    break;
+	case IFF_FIELD_WORD:
+	    *((IFF_Word*)member) = (IFF_Word)(buffer[0] << 8 | buffer[1]);
+	    break;
+	case IFF_FIELD_ULONG:
+	    *((IFF_ULong*)member) = (IFF_ULong)buffer[0] << 24 | (IFF_ULong)buffer[1] << 16 | (IFF_ULong)buffer[2] << 8 | (IFF_ULong)buffer[3];
+	    break;
+	case IFF_FIELD_LONG:
+	    *((IFF_Long*)member) = (IFF_Long)((IFF_ULong)buffer[0] << 24 | (IFF_ULong)buffer[1] << 16 | (IFF_ULong)buffer[2] << 8 | (IFF_ULong)buffer[3]);
+	    break;
+	case IFF_FIELD_ID:
+	    memcpy(member, buffer, IFF_ID_SIZE);
+	    break;
+    }
+}
+
+/**
+ * Encodes a struct member as a big endian element into the buffer.
+ */
+static void encodeElement(const IFF_FieldType type, const IFF_UByte *member, IFF_UByte *buffer)
+{
+    IFF_ULong value;
+    
+    switch(type)
+    {
+	case IFF_FIELD_UBYTE:
+	case IFF_FIELD_BYTE:
+	case IFF_FIELD_ID:
+	    memcpy(buffer, member, fieldSize(type));
+	    return;
+	case IFF_FIELD_UWORD:
+	case IFF_FIELD_WORD:
+	    value = *((const IFF_UWord*)member);
+	    buffer[0] = (IFF_UByte)(value >> 8);
+	    buffer[1] = (IFF_UByte)value;
+	    return;
+	default:
+	    value = *((const IFF_ULong*)member);
+	    buffer[0] = (IFF_UByte)(value >> 24);
+	    buffer[1] = (IFF_UByte)(value >> 16);
+	    buffer[2] = (IFF_UByte)(value >> 8);
+	    buffer[3] = (IFF_UByte)value;
+	    return;
+    }
+}
+
+static void printElement(const IFF_FieldType type, const IFF_UByte *member)
+{
+    switch(type)
+    {
+	case IFF_FIELD_UBYTE:
+	    printf("%u", *((const IFF_UByte*)member));
+	    break;
+	case IFF_FIELD_BYTE:
+	    printf("%d", *((const IFF_Byte*)member));
+	    break;
+	case IFF_FIELD_UWORD:
+	    printf("%u", *((const IFF_UWord*)member));
+	    break;
+	case IFF_FIELD_WORD:
+	    printf("%d", *((const IFF_Word*)member));
+	    break;
+	case IFF_FIELD_ULONG:
+	    printf("%u", *((const IFF_ULong*)member));
+	    break;
+	case IFF_FIELD_LONG:
+	    printf("%d", *((const IFF_Long*)member));
+	    break;
+	case IFF_FIELD_ID:
+	    printf("'");
+	    IFF_printId((const char*)member);
+	    printf("'");
+	    break;
+    }
+}
+
+/**
+ * Returns a buffer that can hold the body of the layout, which is the given
+ * stack buffer if it is large enough.
+ */
+static IFF_UByte *allocateBuffer(IFF_UByte *stackBuffer, const IFF_Long size)
+{
+    if(size <= LAYOUT_BUFFER_SIZE)
+	return stackBuffer;
+    else
+	return (IFF_UByte*)malloc(size);
+}
+
+static void freeBuffer(IFF_UByte *buffer, const IFF_UByte *stackBuffer)
+{
+    if(buffer != stackBuffer)
+	free(buffer);
+}
+
+IFF_Long IFF_computeLayoutSize(const IFF_ChunkLayout *layout)
+{
+    IFF_Long size = 0;
+    unsigned int i;
+    
+    for(i = 0; i < layout->fieldsLength; i++)
+	size += layout->fields[i].count * fieldSize(layout->fields[i].type);
+    
+    return size;
+}
+
+IFF_Chunk *IFF_createLayoutChunk(const char *chunkId, const IFF_ChunkLayout *layout)
+{
+    IFF_Chunk *chunk = IFF_allocateChunk(chunkId, layout->chunkStructSize);
+    
+    if(chunk != NULL)
+    {
+	/* Clear the members that follow the chunk header */
+	memset((IFF_UByte*)chunk + sizeof(IFF_Chunk), '\0', layout->chunkStructSize - sizeof(IFF_Chunk));
+	chunk->chunkSize = IFF_computeLayoutSize(layout);
+    }
+    
+    return chunk;
+}
+
+IFF_Chunk *IFF_readLayoutChunk(IFF_Reader *file, const char *chunkId, const IFF_Long chunkSize, const IFF_ChunkLayout *layout)
+{
+    IFF_UByte stackBuffer[LAYOUT_BUFFER_SIZE];
+    IFF_UByte *buffer, *position;
+    IFF_Chunk *chunk;
+    unsigned int i, j;
+    
+    if(chunkSize != IFF_computeLayoutSize(layout))
+    {
+	IFF_error("Chunk: '");
+	IFF_errorId(chunkId);
+	IFF_error("' has size: %d, but its layout has size: %d\n", chunkSize, IFF_computeLayoutSize(layout));
+	return NULL;
+    }
+    
+    if((buffer = allocateBuffer(stackBuffer, chunkSize)) == NULL)
+	return NULL;
+    
+    /* Read the entire body at once */
+    if(!IFF_readData(file, buffer, chunkSize))
+    {
+	IFF_readError(chunkId, "fields");
+	freeBuffer(buffer, stackBuffer);
+	return NULL;
+    }
+    
+    if((chunk = IFF_createLayoutChunk(chunkId, layout)) != NULL)
+    {
+	/* Decode the fields from the buffer */
+	position = buffer;
+	
+	for(i = 0; i < layout->fieldsLength; i++)
+	{
+	    const IFF_Field *field = &layout->fields[i];
+	    
+	    for(j = 0; j < field->count; j++)
+	    {
+		decodeElement(field->type, position, getMember(chunk, field, j));
+		position += fieldSize(field->type);
+	    }
+	}
+    }
+    
+    freeBuffer(buffer, stackBuffer);
+    return chunk;
+}
+
+int IFF_writeLayoutChunk(IFF_Writer *file, const IFF_Chunk *chunk, const IFF_ChunkLayout *layout)
+{
+    IFF_UByte stackBuffer[LAYOUT_BUFFER_SIZE];
+    IFF_Long size = IFF_computeLayoutSize(layout);
+    IFF_UByte *buffer, *position;
+    unsigned int i, j;
+    int status;
+    
+    if((buffer = allocateBuffer(stackBuffer, size)) == NULL)
+	return FALSE;
+    
+    /* Encode the fields into the buffer */
+    position = buffer;
+    
+    for(i = 0; i < layout->fieldsLength; i++)
+    {
+	const IFF_Field *field = &layout->fields[i];
+	
+	for(j = 0; j < field->count; j++)
+	{
+	    encodeElement(field->type, getMember(chunk, field, j), position);
+	    position += fieldSize(field->type);
+	}
+    }
+    
+    /* Write the entire body at once */
+    if(!(status = (IFF_writeData(file, buffer, size) == TRUE)))
+	IFF_writeError(chunk->chunkId, "fields");
+    
+    freeBuffer(buffer, stackBuffer);
+    return status;
+}
+
+void IFF_printLayoutChunk(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_ChunkLayout *layout)
+{
+    unsigned int i, j;
+    
+    for(i = 0; i < layout->fieldsLength; i++)
+    {
+	const IFF_Field *field = &layout->fields[i];
+	
+	IFF_printIndent(stdout, indentLevel, "%s = ", field->name);
+	
+	if(field->count == 1)
+	    printElement(field->type, getMember(chunk, field, 0));
+	else
+	{
+	    printf("{ ");
+	    
+	    for(j = 0; j < field->count; j++)
+	    {
+		if(j > 0)
+		    printf(", ");
+		
+		printElement(field->type, getMember(chunk, field, j));
+	    }
+	    
+	    printf(" }");
+	}
+	
+	printf(";\n");
+    }
+}
+
+int IFF_compareLayoutChunk(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ChunkLayout *layout)
+{
+    unsigned int i;
+    
+    /* The elements of a field are stored consecutively, without padding */
+    for(i = 0; i < layout->fieldsLength; i++)
+    {
+	const IFF_Field *field = &layout->fields[i];
+	
+	if(memcmp(getMember(chunk1, field, 0), getMember(chunk2, field, 0), field->count * fieldSize(field->type)) != 0)
+	    return FALSE;
+    }
+    
+    return TRUE;
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_LAYOUT_H
+#define __IFF_LAYOUT_H
+
+typedef struct IFF_Field IFF_Field;
+typedef struct IFF_ChunkLayout IFF_ChunkLayout;
+
+#include <stddef.h>
+#include "ifftypes.h"
+#include "chunk.h"
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Enumerates the types of fields that can be stored in a chunk with a layout.
+ * Each type corresponds to a member type in the chunk struct.
+ */
+typedef enum
+{
+    /** An unsigned byte, stored in an IFF_UByte member */
+    IFF_FIELD_UBYTE,
+    
+    /** A signed byte, stored in an IFF_Byte member */
+    IFF_FIELD_BYTE,
+    
+    /** A big endian unsigned 16-bit word, stored in an IFF_UWord member */
+    IFF_FIELD_UWORD,
+    
+    /** A big endian signed 16-bit word, stored in an IFF_Word member */
+    IFF_FIELD_WORD,
+    
+    /** A big endian unsigned 32-bit long, stored in an IFF_ULong member */
+    IFF_FIELD_ULONG,
+    
+    /** A big endian signed 32-bit long, stored in an IFF_Long member */
+    IFF_FIELD_LONG,
+    
+    /** A 4 character ID, stored in an IFF_ID member */
+    IFF_FIELD_ID
+}
+IFF_FieldType;
+
+/**
+ * @brief Describes a field of a chunk body and where it is stored in the chunk struct.
+ */
+struct IFF_Field
+{
+    /** Name of the field, which is used for printing and error reporting */
+    const char *name;
+    
+    /** Type of the field */
+    IFF_FieldType type;
+    
+    /** Offset of the member in the chunk struct, obtained with offsetof() */
+    size_t offset;
+    
+    /** Number of consecutive elements of the field, which is 1 for a member that is not an array */
+    unsigned int count;
+};
+
+/**
+ * @brief Describes a chunk body that consists of a fixed sequence of fields.
+ *
+ * A form extension that refers to a layout does not have to implement its
+ * read, write, free, print and compare functions. The fields are stored in the
+ * order of the array, without any padding in between.
+ */
+struct IFF_ChunkLayout
+{
+    /** Size of the chunk struct in bytes, including the members of IFF_Chunk */
+    size_t chunkStructSize;
+    
+    /** Number of fields in the fields array */
+    unsigned int fieldsLength;
+    
+    /** An array of fields in the order in which they are stored */
+    const IFF_Field *fields;
+};
+
+/**
+ * Returns the size of a chunk body that conforms to the given layout.
+ *
+ * @param layout A chunk layout
+ * @return The size of the chunk body in bytes
+ */
+IFF_Long IFF_computeLayoutSize(const IFF_ChunkLayout *layout);
+
+/**
+ * Creates a chunk with the given layout, in which all fields are zero.
+ * The resulting chunk must be freed with IFF_free() or IFF_freeChunk().
+ *
+ * @param chunkId A 4 character chunk id
+ * @param layout A chunk layout
+ * @return A chunk with the given layout, or NULL if the memory can't be allocated
+ */
+IFF_Chunk *IFF_createLayoutChunk(const char *chunkId, const IFF_ChunkLayout *layout);
+
+/**
+ * Reads a chunk body with the given layout. The body is read at once and the
+ * fields are decoded from the buffer afterwards.
+ *
+ * @param file File descriptor of the file
+ * @param chunkId A 4 character chunk id
+ * @param chunkSize Size of the chunk data, which must equal the size of the layout
+ * @param layout A chunk layout
+ * @return The chunk that has been read, or NULL if an error occurs
+ */
+IFF_Chunk *IFF_readLayoutChunk(IFF_Reader *file, const char *chunkId, const IFF_Long chunkSize, const IFF_ChunkLayout *layout);
+
+/**
+ * Writes the body of a chunk with the given layout. The fields are encoded
+ * into a buffer, which is written at once.
+ *
+ * @param file File descriptor of the file
+ * @param chunk A chunk with the given layout
+ * @param layout A chunk layout
+ * @return TRUE if the body has been successfully written, else FALSE
+ */
+int IFF_writeLayoutChunk(IFF_Writer *file, const IFF_Chunk *chunk, const IFF_ChunkLayout *layout);
+
+/**
+ * Prints the fields of a chunk with the given layout.
+ *
+ * @param chunk A chunk with the given layout
+ * @param indentLevel Indent level of the textual representation
+ * @param layout A chunk layout
+ */
+void IFF_printLayoutChunk(const IFF_Chunk *chunk, const unsigned int indentLevel, const IFF_ChunkLayout *layout);
+
+/**
+ * Compares the fields of two chunks with the given layout.
+ *
+ * @param chunk1 Chunk to compare
+ * @param chunk2 Chunk to compare
+ * @param layout A chunk layout
+ * @return TRUE if all fields are equal, else FALSE
+ */
+int IFF_compareLayoutChunk(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2, const IFF_ChunkLayout *layout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -24,13 +24,15 @@
 #include "id.h"
 #include "util.h"
 #include "cat.h"
+#include "group.h"
 #include "error.h"
+#include "io.h"
 
 #define CHUNKID "LIST"
 
 IFF_List *IFF_createList(const char *contentsType)
 {
-    IFF_List *list = (IFF_List*)IFF_allocateChunk(CHUNKID, sizeof(IFF_List));
+    IFF_List *list = (IFF_List*)IFF_allocatePooledChunk(CHUNKID, sizeof(IFF_List), 0);
     
     if(list != NULL)
     {
@@ -48,9 +50,22 @@ void IFF_addPropToList(IFF_List *list, IFF_Prop *prop)
     list->prop = (IFF_Prop**)realloc(list->prop, (list->propLength + 1) * sizeof(IFF_Prop*));
     list->prop[list->propLength] = prop;
     list->propLength++;
-    list->chunkSize = IFF_incrementChunkSize(list->chunkSize, (IFF_Chunk*)prop);
+    IFF_setChunkSize((IFF_Chunk*)list, IFF_incrementChunkSize(list->chunkSize, (IFF_Chunk*)prop));
     
     prop->parent = (IFF_Group*)list;
+    IFF_CHUNK_META(prop)->flags &= ~IFF_CHUNK_VALIDATED;
+}
+
+int IFF_removePropFromList(IFF_List *list, IFF_Prop *prop)
+{
+    if(IFF_removeChunkFromArray((IFF_Chunk**)list->prop, &list->propLength, (IFF_Chunk*)prop))
+    {
+	IFF_setChunkSize((IFF_Chunk*)list, IFF_decrementChunkSize(list->chunkSize, (IFF_Chunk*)prop));
+	prop->parent = NULL;
+	return TRUE;
+    }
+    else
+	return FALSE;
 }
 
 void IFF_addToList(IFF_List *list, IFF_Chunk *chunk)
@@ -58,14 +73,23 @@ void IFF_addToList(IFF_List *list, IFF_Chunk *chunk)
     IFF_addToCAT((IFF_CAT*)list, chunk);
 }
 
+int IFF_removeFromList(IFF_List *list, IFF_Chunk *chunk)
+{
+    return IFF_removeFromCAT((IFF_CAT*)list, chunk);
+}
+
 IFF_List *IFF_readList(IFF_Reader *file, const IFF_Long chunkSize, const IFF_Extension *extension, const unsigned int extensionLength)
 {
     IFF_ID contentsType;
     IFF_List *list;
+    int check = (file->options & IFF_READ_CHECK) != 0;
     
     /* Read the contentsType id */
     if(!IFF_readId(file, contentsType, CHUNKID, "contentsType"))
 	return NULL;
+    
+    if(check && !IFF_checkId(contentsType))
+	return NULL;
 
     /* Create new list */
     list = IFF_createList(contentsType);
@@ -88,7 +112,26 @@ IFF_List *IFF_readList(IFF_Reader *file, const IFF_Long chunkSize, const IFF_Ext
 	if(IFF_compareId(chunk->chunkId, "PROP") == 0)
 	    IFF_addPropToList(list, (IFF_Prop*)chunk);
 	else
+	{
 	    IFF_addToList(list, chunk);
+	    
+	    if(check && !IFF_checkCATSubChunk((IFF_Group*)list, chunk))
+	    {
+		IFF_freeChunk((IFF_Chunk*)list, NULL, extension, extensionLength);
+		return NULL;
+	    }
+	}
+    }
+    
+    /* The sub chunks may exceed the chunk size */
+    if(check && list->chunkSize != chunkSize)
+    {
+	IFF_Long subChunksSize = list->chunkSize;
+	
+	list->chunkSize = chunkSize;
+	IFF_checkGroupChunkSize((IFF_Group*)list, subChunksSize);
+	IFF_freeChunk((IFF_Chunk*)list, NULL, extension, extensionLength);
+	return NULL;
     }
     
     /* Set the chunk size to what we have read */
@@ -138,7 +181,7 @@ int IFF_checkList(const IFF_List *list, const IFF_Extension *extension, const un
     {
 	IFF_Chunk *propChunk = (IFF_Chunk*)list->prop[i];
 	
-	if(!IFF_checkChunk(propChunk, NULL, extension, extensionLength))
+	if(!IFF_checkSubChunk((const IFF_Chunk*)list, propChunk, NULL, extension, extensionLength))
 	    return FALSE;
 	
 	chunkSize = IFF_incrementChunkSize(chunkSize, propChunk);
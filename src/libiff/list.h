@@ -78,7 +78,7 @@ IFF_List *IFF_createList(const char *contentsType);
 
 /**
  * Adds a PROP chunk to the body of the given list. This function also increments the
- * chunk size and PROP length counter.
+ * chunk size of the list and its ancestors and the PROP length counter.
  *
  * @param list An instance of a list struct
  * @param prop A PROP chunk
@@ -87,13 +87,33 @@ void IFF_addPropToList(IFF_List *list, IFF_Prop *prop);
 
 /**
  * Adds a chunk to the body of the given list. This function also increments the
- * chunk size and chunk length counter.
+ * chunk size of the list and its ancestors and the chunk length counter.
  *
  * @param list An instance of a list struct
  * @param chunk A FORM, CAT or LIST chunk
  */
 void IFF_addToList(IFF_List *list, IFF_Chunk *chunk);
 
+/**
+ * Removes a PROP chunk from the body of the given list, without freeing it. This
+ * function also decrements the chunk size and PROP length counter.
+ *
+ * @param list An instance of a list struct
+ * @param prop A PROP chunk of the list
+ * @return TRUE if the PROP has been removed, FALSE if it is not a PROP chunk of the list
+ */
+int IFF_removePropFromList(IFF_List *list, IFF_Prop *prop);
+
+/**
+ * Removes a chunk from the body of the given list, without freeing it. This function
+ * also decrements the chunk size and chunk length counter.
+ *
+ * @param list An instance of a list struct
+ * @param chunk A sub chunk of the list
+ * @return TRUE if the chunk has been removed, FALSE if it is not a sub chunk of the list
+ */
+int IFF_removeFromList(IFF_List *list, IFF_Chunk *chunk);
+
 /**
  * Reads a list chunk and its sub chunks from a file. The resulting chunk must be
  * freed by using IFF_free().
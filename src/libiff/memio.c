@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "memio.h"
+#include <stdlib.h>
+#include <string.h>
+
+static int IFF_memoryRead(IFF_Reader *reader, void *data, IFF_ULong size)
+{
+    IFF_MemoryReader *memoryReader = (IFF_MemoryReader*)reader;
+    
+    if(size > memoryReader->size - memoryReader->position)
+	return FALSE;
+    else
+    {
+	memcpy(data, memoryReader->data + memoryReader->position, size);
+	memoryReader->position += size;
+	return TRUE;
+    }
+}
+
+static long IFF_memoryReaderTell(IFF_Reader *reader)
+{
+    IFF_MemoryReader *memoryReader = (IFF_MemoryReader*)reader;
+    return memoryReader->position;
+}
+
+static const struct IFF_ReaderCallbacks memoryReaderCallbacks =
+{
+    &IFF_memoryRead,
+    &IFF_memoryReaderTell
+};
+
+void IFF_initMemoryReader(IFF_MemoryReader *reader, const IFF_UByte *data, const IFF_ULong size)
+{
+    IFF_initReader(&reader->base, &memoryReaderCallbacks);
+    reader->data = data;
+    reader->size = size;
+    reader->position = 0;
+}
+
+static int IFF_memoryWrite(IFF_Writer *writer, const void *data, IFF_ULong size)
+{
+    IFF_MemoryWriter *memoryWriter = (IFF_MemoryWriter*)writer;
+    IFF_ULong end = memoryWriter->position + size;
+    
+    /* Grow the memory block exponentially, so that appending takes amortized constant time */
+    if(end > memoryWriter->capacity)
+    {
+	IFF_ULong capacity = memoryWriter->capacity == 0 ? 256 : memoryWriter->capacity;
+	IFF_UByte *newData;
+	
+	while(capacity < end)
+	    capacity *= 2;
+	
+	newData = (IFF_UByte*)realloc(memoryWriter->data, capacity);
+	
+	if(newData == NULL)
+	    return FALSE;
+	
+	memoryWriter->data = newData;
+	memoryWriter->capacity = capacity;
+    }
+    
+    memcpy(memoryWriter->data + memoryWriter->position, data, size);
+    memoryWriter->position = end;
+    
+    if(end > memoryWriter->size)
+	memoryWriter->size = end;
+    
+    return TRUE;
+}
+
+static long IFF_memoryTell(IFF_Writer *writer)
+{
+    IFF_MemoryWriter *memoryWriter = (IFF_MemoryWriter*)writer;
+    return memoryWriter->position;
+}
+
+static int IFF_memorySeek(IFF_Writer *writer, long offset)
+{
+    IFF_MemoryWriter *memoryWriter = (IFF_MemoryWriter*)writer;
+    
+    if(offset < 0 || (IFF_ULong)offset > memoryWriter->size)
+	return FALSE;
+    else
+    {
+	memoryWriter->position = offset;
+	return TRUE;
+    }
+}
+
+static const struct IFF_WriterCallbacks memoryWriterCallbacks =
+{
+    &IFF_memoryWrite,
+    &IFF_memoryTell,
+    &IFF_memorySeek,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+void IFF_initMemoryWriter(IFF_MemoryWriter *writer)
+{
+    writer->base.callbacks = &memoryWriterCallbacks;
+    writer->data = NULL;
+    writer->size = 0;
+    writer->capacity = 0;
+    writer->position = 0;
+}
+
+void IFF_resetMemoryWriter(IFF_MemoryWriter *writer)
+{
+    writer->size = 0;
+    writer->position = 0;
+}
+
+void IFF_cleanupMemoryWriter(IFF_MemoryWriter *writer)
+{
+    free(writer->data);
+    IFF_initMemoryWriter(writer);
+}
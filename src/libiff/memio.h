@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_MEMIO_H
+#define __IFF_MEMIO_H
+
+#include "ifftypes.h"
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A reader that reads its data from a block of memory.
+ */
+typedef struct
+{
+    /** Reader base, so that a memory reader can be used as an IFF_Reader */
+    IFF_Reader base;
+    
+    /** Block of memory from which the data is read */
+    const IFF_UByte *data;
+    
+    /** Size of the memory block in bytes */
+    IFF_ULong size;
+    
+    /** Position of the next byte to read */
+    IFF_ULong position;
+}
+IFF_MemoryReader;
+
+/**
+ * @brief A seekable writer that writes its data to a growing block of memory.
+ */
+typedef struct
+{
+    /** Writer base, so that a memory writer can be used as an IFF_Writer */
+    IFF_Writer base;
+    
+    /** Block of memory to which the data is written */
+    IFF_UByte *data;
+    
+    /** Amount of bytes that have been written */
+    IFF_ULong size;
+    
+    /** Amount of bytes that have been allocated for the memory block */
+    IFF_ULong capacity;
+    
+    /** Position at which the next byte is written */
+    IFF_ULong position;
+}
+IFF_MemoryWriter;
+
+/**
+ * Initializes a memory reader that reads from the given block of memory.
+ * The memory block is not copied and must stay valid as long as the reader is used.
+ *
+ * @param reader A memory reader instance
+ * @param data Block of memory from which the data is read
+ * @param size Size of the memory block in bytes
+ */
+void IFF_initMemoryReader(IFF_MemoryReader *reader, const IFF_UByte *data, const IFF_ULong size);
+
+/**
+ * Initializes a memory writer with an empty memory block.
+ *
+ * @param writer A memory writer instance
+ */
+void IFF_initMemoryWriter(IFF_MemoryWriter *writer);
+
+/**
+ * Discards the data of a memory writer, so that it can be reused. The allocated
+ * memory block is retained.
+ *
+ * @param writer A memory writer instance
+ */
+void IFF_resetMemoryWriter(IFF_MemoryWriter *writer);
+
+/**
+ * Frees the memory block of a memory writer.
+ *
+ * @param writer A memory writer instance
+ */
+void IFF_cleanupMemoryWriter(IFF_MemoryWriter *writer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "parallel.h"
+#include "iff.h"
+#include "id.h"
+
+#if HAVE_PTHREAD_H == 1 && HAVE_UNISTD_H == 1
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "io.h"
+#include "error.h"
+#include "memio.h"
+#include "group.h"
+#include "list.h"
+
+#define GROUP_HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long) + IFF_ID_SIZE)
+
+/**
+ * @brief A sub chunk of the main chunk together with its position in the file
+ */
+typedef struct
+{
+    /** Sub chunk to write */
+    const IFF_Chunk *chunk;
+    
+    /** Position of the sub chunk's header in the file */
+    off_t offset;
+}
+IFF_ParallelUnit;
+
+/**
+ * @brief State that is shared by the threads that write the sub chunks
+ */
+typedef struct
+{
+    int fd;
+    const char *formType;
+    const IFF_Extension *extension;
+    unsigned int extensionLength;
+    
+    IFF_ParallelUnit *unit;
+    unsigned int unitLength;
+    
+    /* Both fields are guarded by the mutex */
+    unsigned int nextUnit;
+    int status;
+    pthread_mutex_t mutex;
+}
+IFF_ParallelJob;
+
+static int writeAt(const int fd, const IFF_UByte *data, IFF_ULong size, off_t offset)
+{
+    while(size > 0)
+    {
+	ssize_t written = pwrite(fd, data, size, offset);
+	
+	if(written < 0)
+	{
+	    if(errno == EINTR)
+		continue;
+	    else
+		return FALSE;
+	}
+	
+	data += written;
+	size -= written;
+	offset += written;
+    }
+    
+    return TRUE;
+}
+
+static int writeUnit(IFF_ParallelJob *job, IFF_MemoryWriter *memoryWriter, const IFF_ParallelUnit *unit)
+{
+    IFF_Long expectedSize = IFF_incrementChunkSize(0, unit->chunk);
+    
+    IFF_resetMemoryWriter(memoryWriter);
+    
+    if(!IFF_writeChunk(&memoryWriter->base, unit->chunk, job->formType, job->extension, job->extensionLength))
+	return FALSE;
+    
+    /* The offsets of all subsequent chunks are wrong if the size does not match */
+    if(memoryWriter->size != (IFF_ULong)expectedSize)
+    {
+	IFF_error("Chunk size mismatch! ");
+	IFF_errorId(unit->chunk->chunkId);
+	IFF_error(" size: %d, while %u bytes were written\n", unit->chunk->chunkSize, memoryWriter->size);
+	return FALSE;
+    }
+    
+    if(!writeAt(job->fd, memoryWriter->data, memoryWriter->size, unit->offset))
+    {
+	IFF_writeError(unit->chunk->chunkId, "chunk");
+	return FALSE;
+    }
+    
+    return TRUE;
+}
+
+static void *writeUnits(void *data)
+{
+    IFF_ParallelJob *job = (IFF_ParallelJob*)data;
+    IFF_MemoryWriter memoryWriter;
+    
+    IFF_initMemoryWriter(&memoryWriter);
+    
+    for(;;)
+    {
+	unsigned int index;
+	int status;
+	
+	pthread_mutex_lock(&job->mutex);
+	index = job->nextUnit++;
+	status = job->status;
+	pthread_mutex_unlock(&job->mutex);
+	
+	if(index >= job->unitLength || !status)
+	    break;
+	
+	if(!writeUnit(job, &memoryWriter, &job->unit[index]))
+	{
+	    pthread_mutex_lock(&job->mutex);
+	    job->status = FALSE;
+	    pthread_mutex_unlock(&job->mutex);
+	}
+    }
+    
+    IFF_cleanupMemoryWriter(&memoryWriter);
+    return NULL;
+}
+
+/**
+ * Collects the sub chunks of the main chunk in the order in which they appear in
+ * the file and computes their offsets.
+ */
+static IFF_ParallelUnit *createUnits(const IFF_Group *group, unsigned int *unitLength)
+{
+    IFF_ParallelUnit *unit;
+    unsigned int propLength = 0;
+    unsigned int i;
+    off_t offset = GROUP_HEADER_SIZE;
+    
+    if(IFF_compareId(group->chunkId, "LIST") == 0)
+	propLength = ((const IFF_List*)group)->propLength;
+    
+    *unitLength = propLength + group->chunkLength;
+    unit = (IFF_ParallelUnit*)malloc((*unitLength + 1) * sizeof(IFF_ParallelUnit)); /* Never request zero bytes, as malloc() may return NULL then */
+    
+    if(unit == NULL)
+	return NULL;
+    
+    for(i = 0; i < *unitLength; i++)
+    {
+	if(i < propLength)
+	    unit[i].chunk = (const IFF_Chunk*)((const IFF_List*)group)->prop[i];
+	else
+	    unit[i].chunk = group->chunk[i - propLength];
+	
+	unit[i].offset = offset;
+	offset += IFF_incrementChunkSize(0, unit[i].chunk);
+    }
+    
+    if(offset != (long)(GROUP_HEADER_SIZE - IFF_ID_SIZE) + group->chunkSize)
+    {
+	IFF_error("Chunk size mismatch! ");
+	IFF_errorId(group->chunkId);
+	IFF_error(" size: %d, while body has: %ld\n", group->chunkSize, (long)(offset - GROUP_HEADER_SIZE + IFF_ID_SIZE));
+	free(unit);
+	return NULL;
+    }
+    
+    return unit;
+}
+
+static int writeHeader(const int fd, const IFF_Group *group)
+{
+    IFF_MemoryWriter memoryWriter;
+    int status;
+    
+    IFF_initMemoryWriter(&memoryWriter);
+    
+    status = IFF_writeChunkHeader(&memoryWriter.base, group->chunkId, group->chunkSize) &&
+	IFF_writeId(&memoryWriter.base, group->groupType, group->chunkId, "groupType") &&
+	writeAt(fd, memoryWriter.data, memoryWriter.size, 0);
+    
+    IFF_cleanupMemoryWriter(&memoryWriter);
+    return status;
+}
+
+static int writeGroupParallel(const char *filename, const IFF_Group *group, const IFF_Extension *extension, const unsigned int extensionLength, const unsigned int numOfThreads)
+{
+    IFF_ParallelJob job;
+    pthread_t *thread;
+    unsigned int threadLength = 0;
+    unsigned int i;
+    
+    if((job.unit = createUnits(group, &job.unitLength)) == NULL)
+	return FALSE;
+    
+    if((job.fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0666)) == -1)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	free(job.unit);
+	return FALSE;
+    }
+    
+    if(IFF_compareId(group->chunkId, "FORM") == 0 || IFF_compareId(group->chunkId, "PROP") == 0)
+	job.formType = group->groupType;
+    else
+	job.formType = NULL;
+    
+    job.extension = extension;
+    job.extensionLength = extensionLength;
+    job.nextUnit = 0;
+    job.status = writeHeader(job.fd, group);
+    pthread_mutex_init(&job.mutex, NULL);
+    
+    /* The calling thread takes part as well, so it is not a problem if fewer threads can be created */
+    thread = (pthread_t*)malloc(numOfThreads * sizeof(pthread_t));
+    
+    if(thread != NULL)
+    {
+	for(i = 1; i < numOfThreads && i < job.unitLength; i++)
+	{
+	    if(pthread_create(&thread[threadLength], NULL, &writeUnits, &job) == 0)
+		threadLength++;
+	}
+    }
+    
+    writeUnits(&job);
+    
+    for(i = 0; i < threadLength; i++)
+	pthread_join(thread[i], NULL);
+    
+    pthread_mutex_destroy(&job.mutex);
+    free(thread);
+    free(job.unit);
+    
+    if(close(job.fd) != 0)
+    {
+	IFF_error("ERROR: cannot close file: %s\n", filename);
+	job.status = FALSE;
+    }
+    
+    return job.status;
+}
+
+#endif
+
+int IFF_writeParallel(const char *filename, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength, const unsigned int numOfThreads)
+{
+#if HAVE_PTHREAD_H == 1 && HAVE_UNISTD_H == 1
+    if(numOfThreads > 1 &&
+       (IFF_compareId(chunk->chunkId, "FORM") == 0 ||
+	IFF_compareId(chunk->chunkId, "CAT ") == 0 ||
+	IFF_compareId(chunk->chunkId, "LIST") == 0))
+	return writeGroupParallel(filename, (const IFF_Group*)chunk, extension, extensionLength, numOfThreads);
+#endif
+    
+    return IFF_write(filename, chunk, extension, extensionLength);
+}
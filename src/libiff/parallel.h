@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_PARALLEL_H
+#define __IFF_PARALLEL_H
+
+#include "ifftypes.h"
+#include "chunk.h"
+#include "extension.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Writes an IFF file to a file with the given filename, serializing the sub chunks
+ * of the main chunk concurrently. Because the position of every sub chunk follows
+ * from the chunk sizes, each thread encodes a sub chunk in memory and writes it
+ * directly to its final position in the file. This pays off for large
+ * concatenations of forms with expensive extension chunk encoders.
+ *
+ * The chunk sizes of the hierarchy must be up to date. On systems without POSIX
+ * threads, the file is written sequentially.
+ *
+ * @param filename Filename of the file
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @param numOfThreads Number of threads that serialize the sub chunks
+ * @return TRUE if the file has been successfully written, else FALSE
+ */
+int IFF_writeParallel(const char *filename, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength, const unsigned int numOfThreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "passthrough.h"
+#include <string.h>
+#include "error.h"
+#include "id.h"
+
+#if HAVE_SYS_MMAN_H == 1 && HAVE_UNISTD_H == 1
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define IFF_PASSTHROUGH_MMAP 1
+#endif
+
+#define HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long))
+
+/** Size of the blocks in which chunks are copied, if the source file cannot be mapped */
+#define COPY_BLOCK_SIZE 65536
+
+static int IFF_passthroughWrite(IFF_Writer *file, const void *data, IFF_ULong size)
+{
+    IFF_PassthroughWriter *writer = (IFF_PassthroughWriter*)file;
+    return IFF_writeData(&writer->writer.base, data, size);
+}
+
+static int IFF_passthroughWriteRef(IFF_Writer *file, const void *data, IFF_ULong size)
+{
+    IFF_PassthroughWriter *writer = (IFF_PassthroughWriter*)file;
+    return IFF_writeDataRef(&writer->writer.base, data, size);
+}
+
+static long IFF_passthroughTell(IFF_Writer *file)
+{
+    IFF_PassthroughWriter *writer = (IFF_PassthroughWriter*)file;
+    return IFF_tellWriter(&writer->writer.base);
+}
+
+static int IFF_passthroughSeek(IFF_Writer *file, long offset)
+{
+    IFF_PassthroughWriter *writer = (IFF_PassthroughWriter*)file;
+    return IFF_seekWriter(&writer->writer.base, offset);
+}
+
+/**
+ * Checks whether the given chunk header in the source file belongs to the given chunk,
+ * so that chunks originating from another file are not copied silently.
+ */
+static int checkHeader(const IFF_UByte *header, const IFF_Chunk *chunk)
+{
+    IFF_ULong chunkSize = (IFF_ULong)header[4] << 24 | (IFF_ULong)header[5] << 16 | (IFF_ULong)header[6] << 8 | (IFF_ULong)header[7];
+    
+    if(memcmp(header, chunk->chunkId, IFF_ID_SIZE) == 0 && (IFF_Long)chunkSize == chunk->chunkSize)
+	return TRUE;
+    else
+    {
+	IFF_error("Chunk: '");
+	IFF_errorId(chunk->chunkId);
+	IFF_error("' does not originate from the source file!\n");
+	return FALSE;
+    }
+}
+
+static int copyFromStream(IFF_PassthroughWriter *writer, const IFF_Chunk *chunk, long size)
+{
+    IFF_UByte block[COPY_BLOCK_SIZE];
+    
+    if(fseek(writer->source, IFF_CHUNK_META(chunk)->sourceOffset, SEEK_SET) != 0 ||
+	fread(block, sizeof(IFF_UByte), HEADER_SIZE, writer->source) != HEADER_SIZE)
+	return FALSE;
+    
+    if(!checkHeader(block, chunk) || !IFF_writeData(&writer->writer.base, block, HEADER_SIZE))
+	return FALSE;
+    
+    size -= HEADER_SIZE;
+    
+    while(size > 0)
+    {
+	size_t blockSize = (size > COPY_BLOCK_SIZE) ? COPY_BLOCK_SIZE : size;
+	
+	if(fread(block, sizeof(IFF_UByte), blockSize, writer->source) != blockSize ||
+	    !IFF_writeData(&writer->writer.base, block, blockSize))
+	    return FALSE;
+	
+	size -= blockSize;
+    }
+    
+    return TRUE;
+}
+
+static int IFF_passthroughCopyChunk(IFF_Writer *file, const IFF_Chunk *chunk)
+{
+    IFF_PassthroughWriter *writer = (IFF_PassthroughWriter*)file;
+    long size = IFF_incrementChunkSize(0, chunk);
+    
+    if(IFF_CHUNK_META(chunk)->sourceOffset + size > writer->sourceSize)
+    {
+	IFF_error("Chunk: '");
+	IFF_errorId(chunk->chunkId);
+	IFF_error("' exceeds the size of the source file!\n");
+	return FALSE;
+    }
+    
+    if(writer->sourceData == NULL)
+	return copyFromStream(writer, chunk, size);
+    else
+    {
+	/* Refer to the mapped chunk in place, so that it is written without being copied */
+	const IFF_UByte *data = writer->sourceData + IFF_CHUNK_META(chunk)->sourceOffset;
+	return (checkHeader(data, chunk) && IFF_writeDataRef(&writer->writer.base, data, size));
+    }
+}
+
+static int IFF_passthroughHasChunk(IFF_Writer *file, const IFF_Chunk *chunk)
+{
+    IFF_PassthroughWriter *writer = (IFF_PassthroughWriter*)file;
+    
+    /* Chunks that have been moved in from a hierarchy of another file must be serialized */
+    return (IFF_CHUNK_META(chunk)->sourceId == writer->sourceId);
+}
+
+static int IFF_passthroughCopyFile(IFF_Writer *file, FILE *source, long offset, IFF_ULong size)
+{
+    IFF_PassthroughWriter *writer = (IFF_PassthroughWriter*)file;
+    return IFF_writeFileData(&writer->writer.base, source, offset, size);
+}
+
+static const struct IFF_WriterCallbacks passthroughWriterCallbacks =
+{
+    &IFF_passthroughWrite,
+    &IFF_passthroughTell,
+    &IFF_passthroughSeek,
+    &IFF_passthroughWriteRef,
+    &IFF_passthroughCopyChunk,
+    &IFF_passthroughHasChunk,
+    &IFF_passthroughCopyFile
+};
+
+int IFF_initPassthroughWriter(IFF_PassthroughWriter *writer, FILE *file, FILE *source, const unsigned long sourceId)
+{
+    writer->base.callbacks = &passthroughWriterCallbacks;
+    writer->source = source;
+    writer->sourceId = sourceId;
+    writer->sourceData = NULL;
+    
+    if(fseek(source, 0, SEEK_END) != 0 || (writer->sourceSize = ftell(source)) < 0)
+	return FALSE;
+    
+#ifdef IFF_PASSTHROUGH_MMAP
+    if(writer->sourceSize > 0)
+    {
+	void *sourceData = mmap(NULL, writer->sourceSize, PROT_READ, MAP_SHARED, fileno(source), 0);
+	
+	/* If the file cannot be mapped, we read from the stream instead */
+	if(sourceData != MAP_FAILED)
+	    writer->sourceData = (const IFF_UByte*)sourceData;
+    }
+#endif
+    
+    if(!IFF_initGatherWriter(&writer->writer, file))
+    {
+#ifdef IFF_PASSTHROUGH_MMAP
+	if(writer->sourceData != NULL)
+	    munmap((void*)writer->sourceData, writer->sourceSize);
+#endif
+	return FALSE;
+    }
+    
+    return TRUE;
+}
+
+int IFF_cleanupPassthroughWriter(IFF_PassthroughWriter *writer)
+{
+    /* The gather writer may still refer to the mapping, so it must be flushed before unmapping */
+    int status = IFF_cleanupGatherWriter(&writer->writer);
+    
+#ifdef IFF_PASSTHROUGH_MMAP
+    if(writer->sourceData != NULL)
+	munmap((void*)writer->sourceData, writer->sourceSize);
+#endif
+    writer->sourceData = NULL;
+    
+    return status;
+}
+
+int IFF_writePassthrough(const char *filename, const IFF_Chunk *chunk, const char *sourceFilename, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_PassthroughWriter writer;
+    FILE *source, *file;
+    int status;
+    
+    /* Opening the output file would destroy the source file */
+    if(strcmp(filename, sourceFilename) == 0)
+    {
+	IFF_error("ERROR: the output file must differ from the source file: %s\n", filename);
+	return FALSE;
+    }
+    
+    source = fopen(sourceFilename, "rb");
+    
+    if(source == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", sourceFilename);
+	return FALSE;
+    }
+    
+    file = fopen(filename, "wb");
+    
+    if(file == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	fclose(source);
+	return FALSE;
+    }
+    
+    /* Only the chunks that have been read together with the root chunk originate from the source file */
+    if(IFF_initPassthroughWriter(&writer, file, source, IFF_CHUNK_META(chunk)->sourceId))
+    {
+	status = IFF_writeChunk(&writer.base, chunk, NULL, extension, extensionLength);
+	
+	if(!IFF_cleanupPassthroughWriter(&writer))
+	    status = FALSE;
+    }
+    else
+    {
+	IFF_error("ERROR: cannot access source file: %s\n", sourceFilename);
+	status = FALSE;
+    }
+    
+    if(fclose(file) != 0)
+	status = FALSE;
+    
+    fclose(source);
+    
+    return status;
+}
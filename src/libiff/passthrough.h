@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_PASSTHROUGH_H
+#define __IFF_PASSTHROUGH_H
+
+#include <stdio.h>
+#include "ifftypes.h"
+#include "io.h"
+#include "chunk.h"
+#include "extension.h"
+#include "gatherio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A writer that copies unmodified chunks from the file from which they
+ * have been read, instead of serializing them. On systems that support it, the
+ * source file is mapped into memory, so that the copied chunks are referenced in
+ * place by the underlying gather writer. Otherwise, they are read from the source
+ * file stream.
+ */
+typedef struct
+{
+    /** Writer base, so that a passthrough writer can be used as an IFF_Writer */
+    IFF_Writer base;
+    
+    /** Gather writer that writes to the output file */
+    IFF_GatherWriter writer;
+    
+    /** File stream of the file from which the unmodified chunks have been read */
+    FILE *source;
+    
+    /** Source identity of the chunks that have been read from the source file, see IFF_createSourceId() */
+    unsigned long sourceId;
+    
+    /** Contents of the source file mapped into memory, or NULL if it is not mapped */
+    const IFF_UByte *sourceData;
+    
+    /** Size of the source file in bytes */
+    long sourceSize;
+}
+IFF_PassthroughWriter;
+
+/**
+ * Initializes a passthrough writer that writes to the given file stream and copies
+ * unmodified chunks from the given source file stream.
+ *
+ * @param writer A passthrough writer instance
+ * @param file File descriptor of the output file
+ * @param source File descriptor of the file from which the chunk hierarchy has been read
+ * @param sourceId Source identity of the chunks that have been read from the source file. Only these chunks are copied
+ * @return TRUE if the writer has been successfully initialized, else FALSE
+ */
+int IFF_initPassthroughWriter(IFF_PassthroughWriter *writer, FILE *file, FILE *source, const unsigned long sourceId);
+
+/**
+ * Writes the remaining data of a passthrough writer and frees its resources.
+ * The file streams are not closed.
+ *
+ * @param writer A passthrough writer instance
+ * @return TRUE if the remaining data has been successfully written, else FALSE
+ */
+int IFF_cleanupPassthroughWriter(IFF_PassthroughWriter *writer);
+
+/**
+ * Writes a chunk hierarchy that has been read from a source file to a file with
+ * the given filename. Unmodified subtrees are copied from the source file as they
+ * are, so that they are byte-identical and do not have to be serialized. Only
+ * chunks that have been read together with the root chunk are copied, so chunks
+ * moved in from a hierarchy of another file are serialized. The
+ * output file must differ from the source file. To update the source file
+ * itself, use IFF_writeInPlace().
+ *
+ * @param filename Filename of the output file
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param sourceFilename Filename of the file from which the chunk hierarchy has been read
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the file has been successfully written, else FALSE
+ */
+int IFF_writePassthrough(const char *filename, const IFF_Chunk *chunk, const char *sourceFilename, const IFF_Extension *extension, const unsigned int extensionLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -40,14 +40,9 @@ void IFF_addToProp(IFF_Prop *prop, IFF_Chunk *chunk)
     IFF_addToForm((IFF_Form*)prop, chunk);
 }
 
-IFF_Prop *IFF_readProp(IFF_Reader *file, const IFF_Long chunkSize, const IFF_Extension *extension, const unsigned int extensionLength)
-{
-    return (IFF_Prop*)IFF_readGroup(file, PROP_CHUNKID, chunkSize, PROP_GROUPTYPENAME, TRUE, extension, extensionLength);
-}
-
-int IFF_writeProp(IFF_Writer *file, const IFF_Prop *prop, const IFF_Extension *extension, const unsigned int extensionLength)
+int IFF_removeFromProp(IFF_Prop *prop, IFF_Chunk *chunk)
 {
-    return IFF_writeForm(file, (IFF_Form*)prop, extension, extensionLength);
+    return IFF_removeFromForm((IFF_Form*)prop, chunk);
 }
 
 static int subChunkCheck(const IFF_Group *group, const IFF_Chunk *subChunk)
@@ -67,6 +62,16 @@ static int subChunkCheck(const IFF_Group *group, const IFF_Chunk *subChunk)
 	return TRUE;
 }
 
+IFF_Prop *IFF_readProp(IFF_Reader *file, const IFF_Long chunkSize, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    return (IFF_Prop*)IFF_readCheckedGroup(file, PROP_CHUNKID, chunkSize, PROP_GROUPTYPENAME, TRUE, &IFF_checkFormType, &subChunkCheck, extension, extensionLength);
+}
+
+int IFF_writeProp(IFF_Writer *file, const IFF_Prop *prop, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    return IFF_writeForm(file, (IFF_Form*)prop, extension, extensionLength);
+}
+
 int IFF_checkProp(const IFF_Prop *prop, const IFF_Extension *extension, const unsigned int extensionLength)
 {
     return IFF_checkGroup((IFF_Group*)prop, &IFF_checkFormType, &subChunkCheck, prop->formType, extension, extensionLength);
@@ -43,13 +43,23 @@ IFF_Prop *IFF_createProp(const char *formType);
 
 /**
  * Adds a chunk to the body of the given PROP. This function also increments the
- * chunk size and chunk length counter.
+ * chunk size of the PROP and its ancestors and the chunk length counter.
  *
  * @param prop An instance of a PROP chunk
  * @param chunk A data chunk
  */
 void IFF_addToProp(IFF_Prop *prop, IFF_Chunk *chunk);
 
+/**
+ * Removes a chunk from the body of the given PROP, without freeing it. This function
+ * also decrements the chunk size and chunk length counter.
+ *
+ * @param prop An instance of a PROP chunk
+ * @param chunk A sub chunk of the PROP
+ * @return TRUE if the chunk has been removed, FALSE if it is not a sub chunk of the PROP
+ */
+int IFF_removeFromProp(IFF_Prop *prop, IFF_Chunk *chunk);
+
 /**
  * Reads a PROP chunk and its sub chunks from a file. The resulting chunk must be
  * freed by using IFF_free().
@@ -0,0 +1,502 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pushparser.h"
+#include <stdlib.h>
+#include <string.h>
+#include "id.h"
+#include "error.h"
+#include "memio.h"
+#include "form.h"
+#include "cat.h"
+#include "list.h"
+#include "prop.h"
+#include "rawchunk.h"
+#include "scanner.h"
+
+#define HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long))
+#define GROUP_HEADER_SIZE (HEADER_SIZE + IFF_ID_SIZE)
+
+typedef enum
+{
+    STATE_HEADER,
+    STATE_GROUPTYPE,
+    STATE_BODY,
+    STATE_PADDING,
+    STATE_DONE,
+    STATE_ERROR
+}
+IFF_PushParserState;
+
+/**
+ * @brief Describes a group chunk whose sub chunks are still being parsed
+ */
+typedef struct
+{
+    /** The group chunk that is being parsed */
+    IFF_Group *group;
+    
+    /** Chunk size of the group as declared in the stream */
+    IFF_Long chunkSize;
+    
+    /** Number of bytes of the group body that have been parsed so far */
+    IFF_Long bytesRead;
+}
+IFF_PushParserFrame;
+
+struct IFF_PushParser
+{
+    IFF_PushParserCallbacks callbacks;
+    void *userData;
+    const IFF_Extension *extension;
+    unsigned int extensionLength;
+    
+    IFF_PushParserState state;
+    
+    /* Collects the chunk header and the group type of a group chunk */
+    IFF_UByte header[GROUP_HEADER_SIZE];
+    unsigned int headerLength;
+    
+    /* Properties of the chunk that is currently being parsed */
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+    const IFF_FormExtension *formExtension;
+    
+    /* Collects the body of the data chunk that is currently being parsed */
+    IFF_UByte *body;
+    IFF_ULong bodySize;
+    IFF_ULong bodyLength;
+    
+    /* Raw chunk that waits for its padding byte */
+    IFF_Chunk *pending;
+    
+    /* Stack of group chunks that are currently open */
+    IFF_PushParserFrame *frame;
+    unsigned int frameLength;
+    unsigned int frameCapacity;
+    
+    /* The main chunk, once it has been completely parsed */
+    IFF_Chunk *chunk;
+    
+    /* Indicates whether trailing contents after the main chunk have been reported */
+    int trailing;
+};
+
+IFF_PushParser *IFF_createPushParser(const IFF_PushParserCallbacks *callbacks, void *userData, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_PushParser *parser = (IFF_PushParser*)malloc(sizeof(IFF_PushParser));
+    
+    if(parser != NULL)
+    {
+	if(callbacks == NULL)
+	{
+	    parser->callbacks.beginGroup = NULL;
+	    parser->callbacks.endChunk = NULL;
+	}
+	else
+	    parser->callbacks = *callbacks;
+	
+	parser->userData = userData;
+	parser->extension = extension;
+	parser->extensionLength = extensionLength;
+	parser->state = STATE_HEADER;
+	parser->headerLength = 0;
+	parser->chunkSize = 0;
+	parser->formExtension = NULL;
+	parser->body = NULL;
+	parser->bodySize = 0;
+	parser->bodyLength = 0;
+	parser->pending = NULL;
+	parser->frame = NULL;
+	parser->frameLength = 0;
+	parser->frameCapacity = 0;
+	parser->chunk = NULL;
+	parser->trailing = FALSE;
+    }
+    
+    return parser;
+}
+
+/**
+ * Returns the form type of the group chunk in which the next sub chunk is located, or NULL if it is not located in a FORM or PROP.
+ */
+static const char *currentFormType(const IFF_PushParser *parser)
+{
+    if(parser->frameLength == 0)
+	return NULL;
+    else
+    {
+	const IFF_Group *group = parser->frame[parser->frameLength - 1].group;
+	
+	if(IFF_compareId(group->chunkId, "FORM") == 0 || IFF_compareId(group->chunkId, "PROP") == 0)
+	    return group->groupType;
+	else
+	    return NULL;
+    }
+}
+
+static int fail(IFF_PushParser *parser)
+{
+    parser->state = STATE_ERROR;
+    return FALSE;
+}
+
+/**
+ * Hands a completely parsed chunk over to the callback and its parent group.
+ * Group chunks that become complete as a consequence are handled as well.
+ */
+static int completeChunk(IFF_PushParser *parser, IFF_Chunk *chunk)
+{
+    while(TRUE)
+    {
+	if(parser->frameLength == 0)
+	{
+	    /* The main chunk has been parsed */
+	    if(parser->callbacks.endChunk == NULL || !parser->callbacks.endChunk(chunk, NULL, parser->userData))
+		parser->chunk = chunk;
+	    
+	    parser->state = STATE_DONE;
+	    return TRUE;
+	}
+	else
+	{
+	    IFF_PushParserFrame *frame = &parser->frame[parser->frameLength - 1];
+	    IFF_Group *group = frame->group;
+	    
+	    /* Account for the chunk before the callback possibly takes it away */
+	    frame->bytesRead = IFF_incrementChunkSize(frame->bytesRead, chunk);
+	    
+	    if(parser->callbacks.endChunk == NULL || !parser->callbacks.endChunk(chunk, group, parser->userData))
+	    {
+		if(IFF_compareId(group->chunkId, "LIST") == 0 && IFF_compareId(chunk->chunkId, "PROP") == 0)
+		    IFF_addPropToList((IFF_List*)group, (IFF_Prop*)chunk);
+		else
+		    IFF_addToGroup(group, chunk);
+	    }
+	    
+	    if(frame->bytesRead < frame->chunkSize)
+	    {
+		parser->state = STATE_HEADER;
+		return TRUE;
+	    }
+	    else
+	    {
+		/* The group is complete. Like IFF_readGroup(), respect the chunk size that was declared */
+		group->chunkSize = frame->chunkSize;
+		parser->frameLength--;
+		chunk = (IFF_Chunk*)group;
+	    }
+	}
+    }
+}
+
+static int pushFrame(IFF_PushParser *parser, IFF_Group *group, const IFF_Long chunkSize)
+{
+    IFF_PushParserFrame *frame;
+    
+    if(parser->frameLength == parser->frameCapacity)
+    {
+	unsigned int frameCapacity = parser->frameCapacity == 0 ? 8 : parser->frameCapacity * 2;
+	IFF_PushParserFrame *frames = (IFF_PushParserFrame*)realloc(parser->frame, frameCapacity * sizeof(IFF_PushParserFrame));
+	
+	if(frames == NULL)
+	    return FALSE;
+	
+	parser->frame = frames;
+	parser->frameCapacity = frameCapacity;
+    }
+    
+    frame = &parser->frame[parser->frameLength];
+    frame->group = group;
+    frame->chunkSize = chunkSize;
+    frame->bytesRead = IFF_ID_SIZE; /* We have the group type */
+    parser->frameLength++;
+    
+    return TRUE;
+}
+
+static int startGroup(IFF_PushParser *parser)
+{
+    IFF_ID groupType;
+    IFF_Group *group;
+    
+    memcpy(groupType, parser->header + HEADER_SIZE, IFF_ID_SIZE);
+    
+    if(IFF_compareId(parser->chunkId, "FORM") == 0)
+	group = (IFF_Group*)IFF_createForm(groupType);
+    else if(IFF_compareId(parser->chunkId, "CAT ") == 0)
+	group = (IFF_Group*)IFF_createCAT(groupType);
+    else if(IFF_compareId(parser->chunkId, "LIST") == 0)
+	group = (IFF_Group*)IFF_createList(groupType);
+    else
+	group = (IFF_Group*)IFF_createProp(groupType);
+    
+    if(group == NULL)
+	return fail(parser);
+    
+    if(parser->callbacks.beginGroup != NULL)
+	parser->callbacks.beginGroup(group, parser->userData);
+    
+    if(parser->chunkSize <= IFF_ID_SIZE)
+    {
+	/* The group has no sub chunks */
+	group->chunkSize = parser->chunkSize;
+	return completeChunk(parser, (IFF_Chunk*)group);
+    }
+    else if(!pushFrame(parser, group, parser->chunkSize))
+    {
+	IFF_freeChunk((IFF_Chunk*)group, NULL, parser->extension, parser->extensionLength);
+	return fail(parser);
+    }
+    else
+    {
+	parser->state = STATE_HEADER;
+	return TRUE;
+    }
+}
+
+static int finishBody(IFF_PushParser *parser)
+{
+    if(parser->formExtension == NULL)
+    {
+	IFF_RawChunk *rawChunk = IFF_createRawChunk(parser->chunkId);
+	
+	if(rawChunk == NULL)
+	    return fail(parser);
+	
+	/* The raw chunk takes ownership of the collected body */
+	IFF_setRawChunkData(rawChunk, parser->body, parser->chunkSize);
+	parser->body = NULL;
+	
+	/* If the chunk size is odd, we have to wait for the padding byte */
+	if(parser->chunkSize % 2 != 0)
+	{
+	    parser->pending = (IFF_Chunk*)rawChunk;
+	    parser->state = STATE_PADDING;
+	    return TRUE;
+	}
+	else
+	    return completeChunk(parser, (IFF_Chunk*)rawChunk);
+    }
+    else
+    {
+	/* Let the extension parse the collected body, including the padding byte */
+	IFF_MemoryReader reader;
+	IFF_Chunk *chunk;
+	
+	IFF_initMemoryReader(&reader, parser->body, parser->bodySize);
+	chunk = IFF_readExtensionChunk(parser->formExtension, (IFF_Reader*)&reader, parser->chunkSize);
+	
+	free(parser->body);
+	parser->body = NULL;
+	
+	if(chunk == NULL)
+	{
+	    IFF_error("Error while reading chunk!\n");
+	    return fail(parser);
+	}
+	else
+	    return completeChunk(parser, chunk);
+    }
+}
+
+static int startChunk(IFF_PushParser *parser)
+{
+    memcpy(parser->chunkId, parser->header, IFF_ID_SIZE);
+    parser->chunkSize = IFF_decodeLong(parser->header + IFF_ID_SIZE);
+    
+    if(IFF_isGroupChunkId(parser->chunkId))
+    {
+	parser->state = STATE_GROUPTYPE;
+	return TRUE;
+    }
+    else
+    {
+	if(parser->chunkSize < 0)
+	{
+	    IFF_error("Invalid chunk size: %d of chunk: '", parser->chunkSize);
+	    IFF_errorId(parser->chunkId);
+	    IFF_error("'\n");
+	    return fail(parser);
+	}
+	
+	parser->formExtension = IFF_findFormExtension(currentFormType(parser), parser->chunkId, parser->extension, parser->extensionLength);
+	parser->bodySize = parser->chunkSize;
+	
+	/* Extensions read the padding byte themselves */
+	if(parser->formExtension != NULL && parser->chunkSize % 2 != 0)
+	    parser->bodySize++;
+	
+	parser->bodyLength = 0;
+	parser->body = (IFF_UByte*)malloc(parser->bodySize * sizeof(IFF_UByte));
+	
+	if(parser->body == NULL && parser->bodySize > 0)
+	{
+	    IFF_error("Cannot allocate memory for the body of chunk: '");
+	    IFF_errorId(parser->chunkId);
+	    IFF_error("'\n");
+	    return fail(parser);
+	}
+	
+	parser->state = STATE_BODY;
+	
+	if(parser->bodySize == 0)
+	    return finishBody(parser);
+	else
+	    return TRUE;
+    }
+}
+
+int IFF_pushFeed(IFF_PushParser *parser, const void *data, const IFF_ULong size)
+{
+    const IFF_UByte *bytes = (const IFF_UByte*)data;
+    IFF_ULong remaining = size;
+    
+    while(remaining > 0)
+    {
+	IFF_ULong length;
+	
+	switch(parser->state)
+	{
+	    case STATE_HEADER:
+	    case STATE_GROUPTYPE:
+	    {
+		unsigned int headerSize = (parser->state == STATE_HEADER) ? HEADER_SIZE : GROUP_HEADER_SIZE;
+		
+		length = headerSize - parser->headerLength;
+		
+		if(length > remaining)
+		    length = remaining;
+		
+		memcpy(parser->header + parser->headerLength, bytes, length);
+		parser->headerLength += length;
+		
+		if(parser->headerLength == headerSize)
+		{
+		    int status;
+		    
+		    if(parser->state == STATE_HEADER)
+			status = startChunk(parser);
+		    else
+		    {
+			parser->headerLength = 0;
+			status = startGroup(parser);
+		    }
+		    
+		    if(!status)
+			return FALSE;
+		    
+		    if(parser->state != STATE_GROUPTYPE)
+			parser->headerLength = 0;
+		}
+		break;
+	    }
+	    case STATE_BODY:
+		length = parser->bodySize - parser->bodyLength;
+		
+		if(length > remaining)
+		    length = remaining;
+		
+		memcpy(parser->body + parser->bodyLength, bytes, length);
+		parser->bodyLength += length;
+		
+		if(parser->bodyLength == parser->bodySize && !finishBody(parser))
+		    return FALSE;
+		
+		break;
+	    case STATE_PADDING:
+	    {
+		IFF_Chunk *chunk = parser->pending;
+		
+		/* Normally, a padding byte is 0, warn if this is not the case */
+		if(bytes[0] != 0)
+		    IFF_error("WARNING: Padding byte is non-zero!\n");
+		
+		length = 1;
+		parser->pending = NULL;
+		
+		if(!completeChunk(parser, chunk))
+		    return FALSE;
+		
+		break;
+	    }
+	    case STATE_DONE:
+		/* We should have reached the EOF now */
+		if(!parser->trailing)
+		{
+		    IFF_error("WARNING: Trailing IFF contents found: %d!\n", bytes[0]);
+		    parser->trailing = TRUE;
+		}
+		return TRUE;
+	    default:
+		return FALSE;
+	}
+	
+	bytes += length;
+	remaining -= length;
+    }
+    
+    return (parser->state != STATE_ERROR);
+}
+
+int IFF_pushIsComplete(const IFF_PushParser *parser)
+{
+    return (parser->state == STATE_DONE);
+}
+
+IFF_Chunk *IFF_pushFinish(IFF_PushParser *parser)
+{
+    if(parser->state == STATE_DONE)
+    {
+	IFF_Chunk *chunk = parser->chunk;
+	parser->chunk = NULL;
+	return chunk;
+    }
+    else
+    {
+	if(parser->state != STATE_ERROR)
+	    IFF_error("Unexpected end of stream, while parsing the IFF stream!\n");
+	
+	IFF_error("ERROR: cannot open main chunk!\n");
+	return NULL;
+    }
+}
+
+void IFF_freePushParser(IFF_PushParser *parser)
+{
+    unsigned int i;
+    
+    free(parser->body);
+    
+    if(parser->pending != NULL)
+	IFF_freeChunk(parser->pending, NULL, parser->extension, parser->extensionLength);
+    
+    /* Open groups have not been added to their parents yet, so they must be freed individually */
+    for(i = 0; i < parser->frameLength; i++)
+	IFF_freeChunk((IFF_Chunk*)parser->frame[i].group, NULL, parser->extension, parser->extensionLength);
+    
+    free(parser->frame);
+    
+    if(parser->chunk != NULL)
+	IFF_freeChunk(parser->chunk, NULL, parser->extension, parser->extensionLength);
+    
+    free(parser);
+}
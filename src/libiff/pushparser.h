@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_PUSHPARSER_H
+#define __IFF_PUSHPARSER_H
+
+typedef struct IFF_PushParser IFF_PushParser;
+
+#include "ifftypes.h"
+#include "chunk.h"
+#include "group.h"
+#include "extension.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Functions that a push parser invokes to notify its user about parsing progress. Each of them may be NULL.
+ */
+typedef struct
+{
+    /**
+     * Invoked as soon as the header and group type of a group chunk have been parsed.
+     * The group does not contain any sub chunks yet.
+     */
+    void (*beginGroup) (const IFF_Group *group, void *userData);
+    
+    /**
+     * Invoked as soon as a chunk and all its sub chunks have been completely parsed.
+     * The parent is the group to which the chunk will be added, or NULL if it is the main chunk.
+     * If the function returns TRUE, the callee takes ownership of the chunk and it is not
+     * added to the parent, which keeps the memory usage of the parser bounded when
+     * streaming large concatenations. The chunk size of the parent remains as declared in
+     * the stream.
+     */
+    int (*endChunk) (IFF_Chunk *chunk, const IFF_Group *parent, void *userData);
+}
+IFF_PushParserCallbacks;
+
+/**
+ * Creates a push parser that accepts an IFF stream in arbitrary fragments.
+ * The resulting parser must be freed using IFF_freePushParser().
+ *
+ * @param callbacks Functions that are notified about parsing progress, or NULL
+ * @param userData Pointer that is passed to the callback functions
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return A push parser, or NULL if the memory can't be allocated
+ */
+IFF_PushParser *IFF_createPushParser(const IFF_PushParserCallbacks *callbacks, void *userData, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Feeds the next fragment of an IFF stream to the push parser. Chunks are
+ * constructed and reported as soon as all their bytes have been fed.
+ *
+ * @param parser A push parser instance
+ * @param data Fragment of the IFF stream
+ * @param size Size of the fragment in bytes
+ * @return TRUE if the fragment has been successfully processed, else FALSE
+ */
+int IFF_pushFeed(IFF_PushParser *parser, const void *data, const IFF_ULong size);
+
+/**
+ * Indicates whether the push parser has completely parsed the main chunk.
+ *
+ * @param parser A push parser instance
+ * @return TRUE if the main chunk is complete, else FALSE
+ */
+int IFF_pushIsComplete(const IFF_PushParser *parser);
+
+/**
+ * Signals the push parser that the end of the stream has been reached and
+ * returns the main chunk. The resulting chunk must be freed using IFF_free().
+ *
+ * @param parser A push parser instance
+ * @return The main chunk, or NULL if the stream was incomplete, erroneous or if the main chunk was taken by the endChunk callback
+ */
+IFF_Chunk *IFF_pushFinish(IFF_PushParser *parser);
+
+/**
+ * Frees a push parser and all the chunks that it has not handed out yet.
+ *
+ * @param parser A push parser instance
+ */
+void IFF_freePushParser(IFF_PushParser *parser);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -26,21 +26,147 @@
 #include "io.h"
 #include "id.h"
 #include "util.h"
+#include "bodysink.h"
+#include "bodytable.h"
+#include "fileio.h"
 
-IFF_RawChunk *IFF_createRawChunk(const char *chunkId)
+/** Size of the blocks in which bodies that are stored in a data file are compared */
+#define COMPARE_BLOCK_SIZE 4096
+
+static IFF_RawChunk *initRawChunk(IFF_RawChunk *rawChunk)
 {
-    IFF_RawChunk *rawChunk = (IFF_RawChunk*)IFF_allocateChunk(chunkId, sizeof(IFF_RawChunk));
-    
     if(rawChunk != NULL)
+    {
 	rawChunk->chunkData = NULL;
+	rawChunk->dataFile = NULL;
+	rawChunk->dataOffset = 0;
+	rawChunk->sharedData = NULL;
+    }
     
     return rawChunk;
 }
 
+IFF_RawChunk *IFF_createRawChunk(const char *chunkId)
+{
+    return initRawChunk((IFF_RawChunk*)IFF_allocatePooledChunk(chunkId, sizeof(IFF_RawChunk), 0));
+}
+
+/**
+ * Creates a raw chunk with room for a body of the given size behind it.
+ */
+static IFF_RawChunk *createInlineRawChunk(const char *chunkId, const IFF_Long chunkSize)
+{
+    return initRawChunk((IFF_RawChunk*)IFF_allocatePooledChunk(chunkId, sizeof(IFF_RawChunk) + chunkSize, IFF_CHUNK_INLINE_STORAGE));
+}
+
+/**
+ * Returns the memory behind a raw chunk in which a small body can be stored.
+ */
+static IFF_UByte *inlineData(const IFF_RawChunk *rawChunk)
+{
+    return (IFF_UByte*)(rawChunk + 1);
+}
+
+/**
+ * Forgets how the previous chunk data of a raw chunk was stored, before other chunk data is attached.
+ */
+static void detachData(IFF_RawChunk *rawChunk)
+{
+    if(rawChunk->sharedData != NULL)
+    {
+	IFF_releaseSharedData(rawChunk->sharedData);
+	rawChunk->sharedData = NULL;
+    }
+    
+    IFF_CHUNK_META(rawChunk)->flags &= ~IFF_CHUNK_BORROWED_DATA;
+}
+
 void IFF_setRawChunkData(IFF_RawChunk *rawChunk, IFF_UByte *chunkData, IFF_Long chunkSize)
 {
+    detachData(rawChunk);
+    
+    /* Data that is attached by the caller is never inline, even if it replaces an inline body */
+    if(chunkData != inlineData(rawChunk))
+	IFF_CHUNK_META(rawChunk)->flags &= ~IFF_CHUNK_INLINE_STORAGE;
+    
     rawChunk->chunkData = chunkData;
-    rawChunk->chunkSize = chunkSize;
+    rawChunk->dataFile = NULL;
+    IFF_setChunkSize((IFF_Chunk*)rawChunk, chunkSize);
+}
+
+void IFF_borrowRawChunkData(IFF_RawChunk *rawChunk, const IFF_UByte *chunkData, IFF_Long chunkSize)
+{
+    IFF_setRawChunkData(rawChunk, (IFF_UByte*)chunkData, chunkSize);
+    IFF_CHUNK_META(rawChunk)->flags |= IFF_CHUNK_BORROWED_DATA;
+}
+
+void IFF_setRawChunkSharedData(IFF_RawChunk *rawChunk, IFF_SharedData *sharedData)
+{
+    /* Add the reference first, as the chunk may already refer to the same data */
+    IFF_retainSharedData(sharedData);
+    IFF_setRawChunkData(rawChunk, sharedData->data, sharedData->size);
+    rawChunk->sharedData = sharedData;
+}
+
+int IFF_shareRawChunkData(IFF_RawChunk *rawChunk, IFF_RawChunk *source)
+{
+    IFF_SharedData *sharedData;
+    
+    if(source->sharedData != NULL)
+    {
+	IFF_setRawChunkSharedData(rawChunk, source->sharedData);
+	return TRUE;
+    }
+    else if(IFF_CHUNK_META(source)->flags & IFF_CHUNK_BORROWED_DATA)
+    {
+	IFF_borrowRawChunkData(rawChunk, source->chunkData, source->chunkSize);
+	return TRUE;
+    }
+    else if(source->chunkData == NULL && source->chunkSize > 0)
+    {
+	if(source->dataFile == NULL)
+	{
+	    IFF_error("Body of chunk '");
+	    IFF_errorId(source->chunkId);
+	    IFF_error("' is not available in memory\n");
+	    return FALSE;
+	}
+	
+	IFF_setRawChunkFileData(rawChunk, source->dataFile, source->dataOffset, source->chunkSize);
+	return TRUE;
+    }
+    else if(IFF_CHUNK_META(source)->flags & IFF_CHUNK_INLINE_STORAGE)
+    {
+	/* Inline data is freed together with the source chunk, so it is copied */
+	IFF_UByte *chunkData = (IFF_UByte*)malloc(source->chunkSize * sizeof(IFF_UByte));
+	
+	if(chunkData == NULL)
+	    return FALSE;
+	
+	memcpy(chunkData, source->chunkData, source->chunkSize);
+	IFF_setRawChunkData(rawChunk, chunkData, source->chunkSize);
+	return TRUE;
+    }
+    else
+    {
+	/* The reference of the shared data is taken over by the source chunk */
+	if((sharedData = IFF_createSharedData(source->chunkData, source->chunkSize, NULL, NULL)) == NULL)
+	    return FALSE;
+	
+	source->sharedData = sharedData;
+	IFF_setRawChunkSharedData(rawChunk, sharedData);
+	return TRUE;
+    }
+}
+
+void IFF_setRawChunkFileData(IFF_RawChunk *rawChunk, FILE *dataFile, long dataOffset, IFF_Long chunkSize)
+{
+    detachData(rawChunk);
+    IFF_CHUNK_META(rawChunk)->flags &= ~IFF_CHUNK_INLINE_STORAGE;
+    rawChunk->chunkData = NULL;
+    rawChunk->dataFile = dataFile;
+    rawChunk->dataOffset = dataOffset;
+    IFF_setChunkSize((IFF_Chunk*)rawChunk, chunkSize);
 }
 
 void IFF_setTextData(IFF_RawChunk *rawChunk, const char *text)
@@ -52,15 +178,87 @@ void IFF_setTextData(IFF_RawChunk *rawChunk, const char *text)
     IFF_setRawChunkData(rawChunk, chunkData, textLength);
 }
 
-IFF_RawChunk *IFF_readRawChunk(IFF_Reader *file, const char *chunkId, const IFF_Long chunkSize)
+/**
+ * Reads the body of a raw chunk by passing it to a body sink. The resulting chunk has no chunk data.
+ */
+static IFF_RawChunk *readRawChunkIntoSink(IFF_Reader *file, const IFF_BodySink *sink, const char *chunkId, const IFF_Long chunkSize)
 {
     IFF_RawChunk *rawChunk = IFF_createRawChunk(chunkId);
-    IFF_UByte *chunkData = (IFF_UByte*)malloc(chunkSize * sizeof(IFF_UByte));
+    
+    if(rawChunk == NULL)
+	return NULL;
+    
+    if(!IFF_readBody(file, sink, rawChunk->chunkId, chunkSize) || !IFF_readPaddingByte(file, chunkSize, chunkId))
+    {
+	IFF_freeChunk((IFF_Chunk*)rawChunk, NULL, NULL, 0);
+	return NULL;
+    }
+    
+    IFF_setRawChunkData(rawChunk, NULL, chunkSize);
+    return rawChunk;
+}
 
-    if (chunkData == NULL) {
-        return NULL;
+/**
+ * Attaches a body that has been read to a raw chunk, sharing it with the chunks
+ * that have an identical body if the reader has been asked to do so.
+ */
+static int attachReadData(IFF_Reader *file, IFF_RawChunk *rawChunk, IFF_UByte *chunkData, const IFF_Long chunkSize)
+{
+    if(file->bodyTable != NULL)
+    {
+	IFF_SharedData *sharedData = IFF_internBody(file->bodyTable, chunkData, chunkSize);
+	
+	if(sharedData == NULL)
+	{
+	    free(chunkData);
+	    return FALSE;
+	}
+	
+	/* The chunk adds its own reference */
+	IFF_setRawChunkSharedData(rawChunk, sharedData);
+	IFF_releaseSharedData(sharedData);
+    }
+    else
+	IFF_setRawChunkData(rawChunk, chunkData, chunkSize);
+    
+    return TRUE;
+}
+
+IFF_RawChunk *IFF_readRawChunk(IFF_Reader *file, const char *chunkId, const IFF_Long chunkSize)
+{
+    const IFF_BodySink *sink = IFF_findBodySink(file, chunkId);
+    IFF_RawChunk *rawChunk;
+    IFF_UByte *chunkData;
+    
+    if(sink != NULL)
+	return readRawChunkIntoSink(file, sink, chunkId, chunkSize);
+    
+    if((file->options & IFF_READ_INLINE_BODIES) && file->bodyTable == NULL && chunkSize >= 0 && chunkSize <= IFF_INLINE_BODY_SIZE)
+    {
+	/* Small bodies share the allocation of the chunk */
+	rawChunk = createInlineRawChunk(chunkId, chunkSize);
+	
+	if(rawChunk == NULL)
+	    return NULL;
+	
+	chunkData = inlineData(rawChunk);
     }
+    else
+    {
+	rawChunk = IFF_createRawChunk(chunkId);
+	
+	if(rawChunk == NULL)
+	    return NULL;
 	
+	chunkData = (IFF_UByte*)malloc(chunkSize * sizeof(IFF_UByte));
+	
+	if(chunkData == NULL)
+	{
+	    IFF_freeChunk((IFF_Chunk*)rawChunk, NULL, NULL, 0);
+	    return NULL;
+	}
+    }
+    
     /* Read remaining bytes verbatim */
 	
     if(IFF_readData(file, chunkData, chunkSize) != TRUE)
@@ -68,6 +266,17 @@ IFF_RawChunk *IFF_readRawChunk(IFF_Reader *file, const char *chunkId, const IFF_
 	IFF_error("Error reading raw chunk body of chunk: '");
 	IFF_errorId(chunkId);
 	IFF_error("'\n");
+	
+	if(!(IFF_CHUNK_META(rawChunk)->flags & IFF_CHUNK_INLINE_STORAGE))
+	    free(chunkData);
+	
+	IFF_freeChunk((IFF_Chunk*)rawChunk, NULL, NULL, 0);
+	return NULL;
+    }
+    
+    /* Add data to the created chunk */
+    if(!attachReadData(file, rawChunk, chunkData, chunkSize))
+    {
 	IFF_freeChunk((IFF_Chunk*)rawChunk, NULL, NULL, 0);
 	return NULL;
     }
@@ -79,16 +288,34 @@ IFF_RawChunk *IFF_readRawChunk(IFF_Reader *file, const char *chunkId, const IFF_
 	return NULL;
     }
     
-    /* Add data to the created chunk */
-    IFF_setRawChunkData(rawChunk, chunkData, chunkSize);
-    
     /* Return the resulting raw chunk */
     return rawChunk;
 }
 
 int IFF_writeRawChunk(IFF_Writer *file, const IFF_RawChunk *rawChunk)
 {
-    if(IFF_writeData(file, rawChunk->chunkData, rawChunk->chunkSize) != TRUE)
+    int status;
+    
+    if(rawChunk->chunkData == NULL && rawChunk->chunkSize > 0)
+    {
+	/* The body of a chunk that has been passed to a body sink is only available in its source file */
+	if(rawChunk->dataFile == NULL)
+	{
+	    IFF_error("Body of chunk '");
+	    IFF_errorId(rawChunk->chunkId);
+	    IFF_error("' is not available in memory\n");
+	    return FALSE;
+	}
+	
+	status = IFF_writeFileData(file, rawChunk->dataFile, rawChunk->dataOffset, rawChunk->chunkSize);
+    }
+    else
+    {
+	/* The body is part of the chunk hierarchy, so writers that support it may refer to it instead of copying it */
+	status = IFF_writeDataRef(file, rawChunk->chunkData, rawChunk->chunkSize);
+    }
+    
+    if(status != TRUE)
     {
 	IFF_error("Error writing raw chunk body of chunk '");
 	IFF_errorId(rawChunk->chunkId);
@@ -105,7 +332,11 @@ int IFF_writeRawChunk(IFF_Writer *file, const IFF_RawChunk *rawChunk)
 
 void IFF_freeRawChunk(IFF_RawChunk *rawChunk)
 {
-    free(rawChunk->chunkData);
+    /* An inline body is freed together with the chunk and borrowed data belongs to the caller */
+    if(rawChunk->sharedData != NULL)
+	IFF_releaseSharedData(rawChunk->sharedData);
+    else if(!(IFF_CHUNK_META(rawChunk)->flags & (IFF_CHUNK_INLINE_STORAGE | IFF_CHUNK_BORROWED_DATA)))
+	free(rawChunk->chunkData);
 }
 
 void IFF_printText(const IFF_RawChunk *rawChunk, const unsigned int indentLevel)
@@ -153,13 +384,60 @@ void IFF_printRaw(const IFF_RawChunk *rawChunk, const unsigned int indentLevel)
 
 void IFF_printRawChunk(const IFF_RawChunk *rawChunk, unsigned int indentLevel)
 {
-    if(IFF_compareId(rawChunk->chunkId, "TEXT") == 0)
+    if(rawChunk->chunkData == NULL && rawChunk->chunkSize > 0)
+	IFF_printIndent(stdout, indentLevel, "bytes = <not in memory>;\n");
+    else if(IFF_compareId(rawChunk->chunkId, "TEXT") == 0)
 	IFF_printText(rawChunk, indentLevel);
     else
 	IFF_printRaw(rawChunk, indentLevel);
 }
 
+/**
+ * Returns a range of the body of a raw chunk. A body in memory is returned
+ * directly, a body in a data file is read into the given block.
+ */
+static const IFF_UByte *getBodyRange(const IFF_RawChunk *rawChunk, const IFF_ULong offset, IFF_UByte *block, const IFF_ULong size)
+{
+    if(rawChunk->chunkData != NULL)
+	return rawChunk->chunkData + offset;
+    else if(IFF_readFileRange(rawChunk->dataFile, rawChunk->dataOffset + offset, block, size))
+	return block;
+    else
+	return NULL;
+}
+
 int IFF_compareRawChunk(const IFF_RawChunk *rawChunk1, const IFF_RawChunk *rawChunk2)
 {
-    return (memcmp(rawChunk1->chunkData, rawChunk2->chunkData, rawChunk1->chunkSize) == 0);
+    IFF_UByte block1[COMPARE_BLOCK_SIZE], block2[COMPARE_BLOCK_SIZE];
+    IFF_ULong size = rawChunk1->chunkSize;
+    IFF_ULong offset = 0;
+    
+    if(rawChunk1 == rawChunk2 || size == 0)
+	return TRUE;
+    
+    /* A body that has been passed to a body sink is gone, so it can't be compared */
+    if((rawChunk1->chunkData == NULL && rawChunk1->dataFile == NULL) || (rawChunk2->chunkData == NULL && rawChunk2->dataFile == NULL))
+	return FALSE;
+    
+    if(rawChunk1->chunkData != NULL && rawChunk2->chunkData != NULL)
+	return (memcmp(rawChunk1->chunkData, rawChunk2->chunkData, size) == 0);
+    
+    /* Bodies at the same location of the same data file are equal without reading them */
+    if(rawChunk1->chunkData == NULL && rawChunk2->chunkData == NULL && rawChunk1->dataFile == rawChunk2->dataFile && rawChunk1->dataOffset == rawChunk2->dataOffset)
+	return TRUE;
+    
+    /* Otherwise, the bodies in data files are compared block by block */
+    while(offset < size)
+    {
+	IFF_ULong blockSize = size - offset < COMPARE_BLOCK_SIZE ? size - offset : COMPARE_BLOCK_SIZE;
+	const IFF_UByte *range1 = getBodyRange(rawChunk1, offset, block1, blockSize);
+	const IFF_UByte *range2 = getBodyRange(rawChunk2, offset, block2, blockSize);
+	
+	if(range1 == NULL || range2 == NULL || memcmp(range1, range2, blockSize) != 0)
+	    return FALSE;
+	
+	offset += blockSize;
+    }
+    
+    return TRUE;
 }
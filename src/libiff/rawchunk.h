@@ -24,15 +24,26 @@
 
 typedef struct IFF_RawChunk IFF_RawChunk;
 
+#include <stdio.h>
 #include "ifftypes.h"
 #include "chunk.h"
+#include "shareddata.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Largest body that is stored in the same allocation as its raw chunk, if the reader has been asked to do so with IFF_READ_INLINE_BODIES */
+#define IFF_INLINE_BODY_SIZE 64
+
 /**
  * @brief A raw chunk, which contains an arbitrary number of bytes.
+ *
+ * The chunk data is stored in one of the following ways:
+ * - Owned: the chunk data has been allocated with malloc() and is freed together with the chunk (IFF_setRawChunkData())
+ * - Inline: the chunk data is stored behind the chunk (IFF_CHUNK_INLINE_STORAGE)
+ * - Borrowed: the chunk data belongs to the caller (IFF_CHUNK_BORROWED_DATA, IFF_borrowRawChunkData())
+ * - Shared: the chunk data is reference counted and may be shared with other chunks (IFF_setRawChunkSharedData())
  */
 struct IFF_RawChunk
 {
@@ -45,8 +56,20 @@ struct IFF_RawChunk
     /** Contains the size of the chunk data in bytes */
     IFF_Long chunkSize;
     
-    /** An array of bytes representing raw chunk data */
+    /**
+     * An array of bytes representing raw chunk data, or NULL if the body has been passed to a body sink or resides in a data file.
+     * The array is stored behind the chunk itself, if IFF_CHUNK_INLINE_STORAGE is set in the chunk's flags.
+     */
     IFF_UByte *chunkData;
+    
+    /** File that contains the chunk data if the chunk data is not in memory, or NULL. The chunk does not own the file. */
+    FILE *dataFile;
+    
+    /** Offset of the chunk data in the data file */
+    long dataOffset;
+    
+    /** Shared data to which the chunk data belongs, or NULL if it is not shared. The chunk holds a reference to it. */
+    IFF_SharedData *sharedData;
 };
 
 /**
@@ -58,7 +81,10 @@ struct IFF_RawChunk
 IFF_RawChunk *IFF_createRawChunk(const char *chunkId);
 
 /**
- * Attaches chunk data to a given chunk. It also increments the chunk size.
+ * Attaches chunk data to a given chunk. It also sets the chunk size and adjusts
+ * the chunk sizes of the ancestors of the chunk accordingly. Chunk data that was
+ * previously attached is not freed, but a reference to shared data is released.
+ * The chunk takes ownership of the given data, so it is freed by IFF_free().
  *
  * @param rawChunk A raw chunk
  * @param chunkData An array of bytes
@@ -66,6 +92,57 @@ IFF_RawChunk *IFF_createRawChunk(const char *chunkId);
  */
 void IFF_setRawChunkData(IFF_RawChunk *rawChunk, IFF_UByte *chunkData, IFF_Long chunkSize);
 
+/**
+ * Attaches chunk data that belongs to the caller to a given chunk, without
+ * copying it. The data is not freed by IFF_free(), so it must stay valid as long
+ * as the chunk refers to it. It also sets the chunk size and adjusts the chunk
+ * sizes of the ancestors of the chunk accordingly.
+ *
+ * @param rawChunk A raw chunk
+ * @param chunkData An array of bytes
+ * @param chunkSize Length of the bytes array.
+ */
+void IFF_borrowRawChunkData(IFF_RawChunk *rawChunk, const IFF_UByte *chunkData, IFF_Long chunkSize);
+
+/**
+ * Attaches reference counted data to a given chunk, without copying it. The
+ * chunk adds a reference, which is released by IFF_free() or when other chunk
+ * data is attached. Shared data must not be modified. It also sets the chunk
+ * size and adjusts the chunk sizes of the ancestors of the chunk accordingly.
+ *
+ * @param rawChunk A raw chunk
+ * @param sharedData Shared data
+ */
+void IFF_setRawChunkSharedData(IFF_RawChunk *rawChunk, IFF_SharedData *sharedData);
+
+/**
+ * Makes a raw chunk refer to the chunk data of another raw chunk, which may be
+ * part of another chunk hierarchy, without copying it if possible. If the
+ * source chunk owns its data, the ownership is transferred to shared data to
+ * which both chunks refer, so that both hierarchies can be freed independently.
+ * Borrowed data and data that resides in a data file are referred to in the same
+ * way as by the source chunk. Inline data is copied.
+ *
+ * @param rawChunk A raw chunk
+ * @param source Raw chunk whose chunk data is reused
+ * @return TRUE if the chunk data has been attached, or FALSE if the data of the source chunk is not in memory or the memory can't be allocated
+ */
+int IFF_shareRawChunkData(IFF_RawChunk *rawChunk, IFF_RawChunk *source);
+
+/**
+ * Makes a range of bytes of another file the data of the given chunk, so that it
+ * is copied from that file when the chunk is written, instead of being read into
+ * memory first. Writers that support it let the kernel transfer the bytes. It
+ * also sets the chunk size and adjusts the chunk sizes of the ancestors of the
+ * chunk accordingly.
+ *
+ * @param rawChunk A raw chunk
+ * @param dataFile File that contains the chunk data. It must stay open until the chunk has been written and is not closed by IFF_free().
+ * @param dataOffset Offset of the chunk data in the file
+ * @param chunkSize Size of the chunk data in bytes
+ */
+void IFF_setRawChunkFileData(IFF_RawChunk *rawChunk, FILE *dataFile, long dataOffset, IFF_Long chunkSize);
+
 /**
  * Copies the given string into the data of the chunk. Additionally, it makes
  * the chunk size equal to the given string.
@@ -126,7 +203,10 @@ void IFF_printRaw(const IFF_RawChunk *rawChunk, const unsigned int indentLevel);
 void IFF_printRawChunk(const IFF_RawChunk *rawChunk, unsigned int indentLevel);
 
 /**
- * Checks whether two given raw chunks are equal.
+ * Checks whether two given raw chunks are equal. Bodies that reside in a data
+ * file are read block by block, unless both chunks refer to the same range of
+ * the same file. Bodies that have been passed to a body sink are only equal to
+ * themselves.
  *
  * @param rawChunk1 Raw chunk to compare
  * @param rawChunk2 Raw chunk to compare
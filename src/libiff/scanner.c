@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "scanner.h"
+#include "id.h"
+#include "error.h"
+
+/** Size of the blocks in which data chunk bodies are skipped, if the file cannot be seeked */
+#define SKIP_BLOCK_SIZE 65536
+
+/** Bodies up to this size are most likely in the buffer of the stream already, so reading them is cheaper than seeking */
+#define SEEK_THRESHOLD 4096
+
+void IFF_initScanner(IFF_Scanner *scanner, IFF_Reader *reader)
+{
+    scanner->reader = reader;
+    scanner->file = NULL;
+    scanner->fileSize = 0;
+    scanner->position = 0;
+}
+
+int IFF_initSeekableScanner(IFF_Scanner *scanner, FILE *file)
+{
+    long position = ftell(file);
+    
+    /* We determine the size of the stream, so that we can skip bodies safely */
+    if(position >= 0 && fseek(file, 0, SEEK_END) == 0 && (scanner->fileSize = ftell(file)) >= 0 && fseek(file, position, SEEK_SET) == 0)
+    {
+	scanner->reader = NULL;
+	scanner->file = file;
+	scanner->position = position;
+	return TRUE;
+    }
+    else
+	return FALSE;
+}
+
+int IFF_scanBytes(IFF_Scanner *scanner, void *data, const IFF_ULong size)
+{
+    int status;
+    
+    if(scanner->file == NULL)
+	status = (IFF_readData(scanner->reader, data, size) == TRUE);
+    else
+	status = (fread(data, sizeof(IFF_UByte), size, scanner->file) == size);
+    
+    if(status)
+	scanner->position += size;
+    
+    return status;
+}
+
+int IFF_skipBytes(IFF_Scanner *scanner, IFF_ULong size)
+{
+    if(scanner->file == NULL || size <= SEEK_THRESHOLD)
+    {
+	IFF_UByte block[SKIP_BLOCK_SIZE];
+	
+	while(size > 0)
+	{
+	    IFF_ULong blockSize = size < SKIP_BLOCK_SIZE ? size : SKIP_BLOCK_SIZE;
+	    
+	    if(!IFF_scanBytes(scanner, block, blockSize))
+		return FALSE;
+	    
+	    size -= blockSize;
+	}
+	
+	return TRUE;
+    }
+    else
+    {
+	/* Seeking beyond the end of the file succeeds, so we have to check whether the bytes exist ourselves */
+	if(!IFF_scannerHasBytes(scanner, size) || fseek(scanner->file, size, SEEK_CUR) != 0)
+	    return FALSE;
+	
+	scanner->position += size;
+	return TRUE;
+    }
+}
+
+int IFF_scannerHasBytes(const IFF_Scanner *scanner, const IFF_ULong size)
+{
+    return (scanner->file == NULL || size <= (IFF_ULong)(scanner->fileSize - scanner->position));
+}
+
+IFF_Long IFF_decodeLong(const IFF_UByte *bytes)
+{
+    return (IFF_Long)((IFF_ULong)bytes[0] << 24 | (IFF_ULong)bytes[1] << 16 | (IFF_ULong)bytes[2] << 8 | (IFF_ULong)bytes[3]);
+}
+
+int IFF_isGroupChunkId(const IFF_ID chunkId)
+{
+    return (IFF_compareId(chunkId, "FORM") == 0 ||
+	IFF_compareId(chunkId, "CAT ") == 0 ||
+	IFF_compareId(chunkId, "LIST") == 0 ||
+	IFF_compareId(chunkId, "PROP") == 0);
+}
+
+static int notAllowed(const IFF_ID chunkId, const char *groupName)
+{
+    IFF_error("ERROR: Element with chunk Id: '");
+    IFF_errorId(chunkId);
+    IFF_error("' not allowed in %s chunk!\n", groupName);
+    return FALSE;
+}
+
+int IFF_checkChunkPlacement(const IFF_ID parentChunkId, const IFF_ID chunkId)
+{
+    if(parentChunkId == NULL)
+    {
+	/* The main chunk must be of ID: FORM, CAT or LIST */
+	if(IFF_compareId(chunkId, "FORM") != 0 && IFF_compareId(chunkId, "CAT ") != 0 && IFF_compareId(chunkId, "LIST") != 0)
+	{
+	    IFF_error("Not a valid IFF-85 file: First bytes should start with either: 'FORM', 'CAT ' or 'LIST'\n");
+	    return FALSE;
+	}
+    }
+    else if(IFF_compareId(parentChunkId, "FORM") == 0)
+    {
+	if(IFF_compareId(chunkId, "PROP") == 0)
+	    return notAllowed(chunkId, "FORM");
+    }
+    else if(IFF_compareId(parentChunkId, "PROP") == 0)
+    {
+	if(IFF_isGroupChunkId(chunkId))
+	    return notAllowed(chunkId, "PROP");
+    }
+    else if(IFF_compareId(chunkId, "PROP") == 0 && IFF_compareId(parentChunkId, "LIST") == 0)
+	return TRUE;
+    else
+    {
+	/* A concatenation or list may only contain other group chunks. Only a list may contain PROPs. */
+	if(IFF_compareId(chunkId, "FORM") != 0 && IFF_compareId(chunkId, "LIST") != 0 && IFF_compareId(chunkId, "CAT ") != 0)
+	    return notAllowed(chunkId, IFF_compareId(parentChunkId, "CAT ") == 0 ? "CAT" : "LIST");
+    }
+    
+    return TRUE;
+}
+
+int IFF_checkContentsType(const IFF_ID parentChunkId, const IFF_ID parentGroupType, const IFF_ID chunkId, const IFF_ID groupType)
+{
+    /* Sub chunks of a CAT or LIST must match its contents type, unless it is a wildcard */
+    if(parentChunkId != NULL && (IFF_compareId(parentChunkId, "CAT ") == 0 || IFF_compareId(parentChunkId, "LIST") == 0) &&
+	IFF_compareId(chunkId, "PROP") != 0 &&
+	IFF_compareId(parentGroupType, "JJJJ") != 0 && IFF_compareId(groupType, parentGroupType) != 0)
+    {
+	IFF_error("Sub chunk does not match contentsType of the ");
+	IFF_errorId(parentChunkId);
+	IFF_error("!\n");
+	return FALSE;
+    }
+    
+    return TRUE;
+}
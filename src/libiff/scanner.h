@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_SCANNER_H
+#define __IFF_SCANNER_H
+
+#include <stdio.h>
+#include "ifftypes.h"
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reads the chunk structure of an IFF file without building a chunk
+ * hierarchy. Bodies that are not needed are skipped: they are seeked over if the
+ * file stream is seekable, or read and discarded otherwise.
+ */
+typedef struct
+{
+    /** Reader from which the file is read, if no seekable file stream is used */
+    IFF_Reader *reader;
+    
+    /** Seekable file stream from which the file is read, or NULL */
+    FILE *file;
+    
+    /** Size of the seekable file stream */
+    long fileSize;
+    
+    /** Offset of the next byte to read */
+    long position;
+}
+IFF_Scanner;
+
+/**
+ * Initialises a scanner that reads from the given reader and skips bodies by
+ * reading and discarding them.
+ *
+ * @param scanner Scanner to initialise
+ * @param reader A reader instance
+ */
+void IFF_initScanner(IFF_Scanner *scanner, IFF_Reader *reader);
+
+/**
+ * Initialises a scanner that reads from the given file stream and skips large
+ * bodies by seeking over them.
+ *
+ * @param scanner Scanner to initialise
+ * @param file File descriptor of the file
+ * @return TRUE if the scanner has been initialised, or FALSE if the stream is not seekable
+ */
+int IFF_initSeekableScanner(IFF_Scanner *scanner, FILE *file);
+
+/**
+ * Reads the given amount of bytes.
+ *
+ * @param scanner Scanner from which the bytes are read
+ * @param data Memory in which the bytes are stored
+ * @param size Amount of bytes to read
+ * @return TRUE if the bytes have been read, else FALSE
+ */
+int IFF_scanBytes(IFF_Scanner *scanner, void *data, const IFF_ULong size);
+
+/**
+ * Skips the given amount of bytes.
+ *
+ * @param scanner Scanner from which the bytes are skipped
+ * @param size Amount of bytes to skip
+ * @return TRUE if the bytes have been skipped, or FALSE if the file has fewer bytes left
+ */
+int IFF_skipBytes(IFF_Scanner *scanner, IFF_ULong size);
+
+/**
+ * Checks whether the file has at least the given amount of bytes left. This is
+ * only known for seekable file streams.
+ *
+ * @param scanner Scanner from which the file is read
+ * @param size Amount of bytes
+ * @return TRUE if the bytes are present or the stream is not seekable, or FALSE if the file has fewer bytes left
+ */
+int IFF_scannerHasBytes(const IFF_Scanner *scanner, const IFF_ULong size);
+
+/**
+ * Decodes a big-endian 32-bit value that has been read with IFF_scanBytes().
+ *
+ * @param bytes The 4 bytes of the value
+ * @return The decoded value
+ */
+IFF_Long IFF_decodeLong(const IFF_UByte *bytes);
+
+/**
+ * Checks whether the given chunk ID is the ID of a group chunk.
+ *
+ * @param chunkId A 4 character chunk ID
+ * @return TRUE if it is a FORM, CAT, LIST or PROP, else FALSE
+ */
+int IFF_isGroupChunkId(const IFF_ID chunkId);
+
+/**
+ * Checks whether a chunk with the given chunk ID is allowed in its parent, using
+ * the same rules as the sub chunk checks of the group chunks. The contents type
+ * of CATs and LISTs is checked separately by IFF_checkContentsType(), as the
+ * group type of the sub chunk follows its header.
+ *
+ * @param parentChunkId Chunk ID of the group in which the chunk is located, or NULL for the main chunk
+ * @param chunkId Chunk ID of the chunk
+ * @return TRUE if the chunk is allowed, else FALSE
+ */
+int IFF_checkChunkPlacement(const IFF_ID parentChunkId, const IFF_ID chunkId);
+
+/**
+ * Checks whether a group chunk matches the contents type of the CAT or LIST in
+ * which it is located, unless it is a wildcard.
+ *
+ * @param parentChunkId Chunk ID of the group in which the chunk is located, or NULL for the main chunk
+ * @param parentGroupType Group type of the group in which the chunk is located, or NULL for the main chunk
+ * @param chunkId Chunk ID of the group chunk
+ * @param groupType Group type of the group chunk
+ * @return TRUE if the group type matches, else FALSE
+ */
+int IFF_checkContentsType(const IFF_ID parentChunkId, const IFF_ID parentGroupType, const IFF_ID chunkId, const IFF_ID groupType);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "shareddata.h"
+#include <stdlib.h>
+
+IFF_SharedData *IFF_createSharedData(IFF_UByte *data, const IFF_ULong size, void (*release) (IFF_UByte *data, void *userData), void *userData)
+{
+    IFF_SharedData *sharedData = (IFF_SharedData*)malloc(sizeof(IFF_SharedData));
+    
+    if(sharedData != NULL)
+    {
+	sharedData->data = data;
+	sharedData->size = size;
+	sharedData->refCount = 1;
+	sharedData->release = release;
+	sharedData->userData = userData;
+    }
+    
+    return sharedData;
+}
+
+IFF_SharedData *IFF_retainSharedData(IFF_SharedData *sharedData)
+{
+    /* Hierarchies that share data may be freed by different threads */
+#if HAVE_SYNC_BUILTINS == 1
+    __sync_add_and_fetch(&sharedData->refCount, 1);
+#else
+    sharedData->refCount++;
+#endif
+    return sharedData;
+}
+
+void IFF_releaseSharedData(IFF_SharedData *sharedData)
+{
+    unsigned int refCount;
+    
+#if HAVE_SYNC_BUILTINS == 1
+    refCount = __sync_sub_and_fetch(&sharedData->refCount, 1);
+#else
+    refCount = --sharedData->refCount;
+#endif
+    
+    if(refCount == 0)
+    {
+	if(sharedData->release == NULL)
+	    free(sharedData->data);
+	else
+	    sharedData->release(sharedData->data, sharedData->userData);
+	
+	free(sharedData);
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_SHAREDDATA_H
+#define __IFF_SHAREDDATA_H
+
+typedef struct IFF_SharedData IFF_SharedData;
+
+#include "ifftypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reference counted chunk data that can be shared by multiple raw chunks,
+ * possibly of different chunk hierarchies, without copying it.
+ */
+struct IFF_SharedData
+{
+    /** The shared bytes */
+    IFF_UByte *data;
+    
+    /** Amount of shared bytes */
+    IFF_ULong size;
+    
+    /** Number of references to the shared data */
+    unsigned int refCount;
+    
+    /** Invoked when the last reference has been released, or NULL to free the data with free() */
+    void (*release) (IFF_UByte *data, void *userData);
+    
+    /** Pointer that is passed to the release function */
+    void *userData;
+};
+
+/**
+ * Creates shared data for the given bytes with a reference count of 1, which
+ * belongs to the caller. The bytes may reside anywhere, such as in a memory
+ * mapping or in a buffer of the application, as long as they stay valid until
+ * the release function has been invoked. The resulting shared data must be
+ * released using IFF_releaseSharedData().
+ *
+ * @param data An array of bytes
+ * @param size Length of the bytes array
+ * @param release Function that is invoked when the last reference has been released, or NULL to free the bytes with free()
+ * @param userData Pointer that is passed to the release function
+ * @return Shared data referring to the given bytes, or NULL if the memory can't be allocated
+ */
+IFF_SharedData *IFF_createSharedData(IFF_UByte *data, const IFF_ULong size, void (*release) (IFF_UByte *data, void *userData), void *userData);
+
+/**
+ * Adds a reference to the given shared data.
+ *
+ * @param sharedData Shared data
+ * @return The given shared data
+ */
+IFF_SharedData *IFF_retainSharedData(IFF_SharedData *sharedData);
+
+/**
+ * Removes a reference from the given shared data. Releasing the last reference
+ * invokes its release function and frees the shared data itself.
+ *
+ * @param sharedData Shared data
+ */
+void IFF_releaseSharedData(IFF_SharedData *sharedData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
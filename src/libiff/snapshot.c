@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "memio.h"
+#include "error.h"
+
+#if HAVE_SYS_MMAN_H == 1 && HAVE_UNISTD_H == 1
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define IFF_SNAPSHOT_MMAP 1
+#endif
+
+#define SNAPSHOT_MAGIC "IFFS"
+#define SNAPSHOT_VERSION 1
+
+/** Value of the byte order field, which reads differently on systems with another byte order */
+#define SNAPSHOT_BYTE_ORDER 0x01020304
+
+#define HEADER_SIZE (IFF_ID_SIZE + sizeof(IFF_Long))
+
+/**
+ * @brief Header of a snapshot file. All fields have the size of an IFF_ULong,
+ * so that the struct does not contain padding. The header is followed by the
+ * offset array, the chunkId, groupType, chunkSize, parent, firstChild and
+ * nextSibling arrays and the serialized IFF file.
+ */
+typedef struct
+{
+    IFF_UByte magic[IFF_ID_SIZE];
+    IFF_ULong version;
+    IFF_ULong byteOrder;
+    IFF_ULong longSize;
+    IFF_ULong nodeLength;
+    IFF_ULong dataSize;
+    IFF_ULong reserved[2];
+}
+SnapshotHeader;
+
+/**
+ * Returns the size of the snapshot arrays of a tree with the given number of
+ * nodes. The offset array comes first, so that all arrays are properly aligned.
+ */
+static size_t getArraysSize(const IFF_ULong nodeLength)
+{
+    return nodeLength * (sizeof(long) + 2 * sizeof(IFF_ID) + sizeof(IFF_Long) + 3 * sizeof(unsigned int));
+}
+
+static int writeSnapshot(FILE *file, const IFF_FlatTree *tree, const IFF_MemoryWriter *writer)
+{
+    SnapshotHeader header;
+    unsigned int n = tree->nodeLength;
+    
+    memset(&header, '\0', sizeof(SnapshotHeader));
+    memcpy(header.magic, SNAPSHOT_MAGIC, IFF_ID_SIZE);
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.longSize = sizeof(long);
+    header.nodeLength = n;
+    header.dataSize = writer->size;
+    
+    return (fwrite(&header, sizeof(SnapshotHeader), 1, file) == 1 &&
+	fwrite(tree->offset, sizeof(long), n, file) == n &&
+	fwrite(tree->chunkId, sizeof(IFF_ID), n, file) == n &&
+	fwrite(tree->groupType, sizeof(IFF_ID), n, file) == n &&
+	fwrite(tree->chunkSize, sizeof(IFF_Long), n, file) == n &&
+	fwrite(tree->parent, sizeof(unsigned int), n, file) == n &&
+	fwrite(tree->firstChild, sizeof(unsigned int), n, file) == n &&
+	fwrite(tree->nextSibling, sizeof(unsigned int), n, file) == n &&
+	fwrite(writer->data, sizeof(IFF_UByte), writer->size, file) == writer->size);
+}
+
+int IFF_freezeChunk(const char *filename, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_MemoryWriter writer;
+    IFF_MemoryReader reader;
+    IFF_FlatTree *tree;
+    FILE *file;
+    int status;
+    
+    /* Serialize the hierarchy and derive the structure from the result, so that the offsets refer to it */
+    IFF_initMemoryWriter(&writer);
+    
+    if(!IFF_writeChunk(&writer.base, chunk, NULL, extension, extensionLength))
+    {
+	IFF_cleanupMemoryWriter(&writer);
+	return FALSE;
+    }
+    
+    IFF_initMemoryReader(&reader, writer.data, writer.size);
+    
+    if((tree = IFF_readFlatTreeReader(&reader.base)) == NULL)
+    {
+	IFF_cleanupMemoryWriter(&writer);
+	return FALSE;
+    }
+    
+    if((file = fopen(filename, "wb")) == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	status = FALSE;
+    }
+    else
+    {
+	status = writeSnapshot(file, tree, &writer);
+	
+	if(fclose(file) != 0)
+	    status = FALSE;
+	
+	if(!status)
+	    IFF_error("ERROR: cannot write snapshot: %s\n", filename);
+    }
+    
+    IFF_freeFlatTree(tree);
+    IFF_cleanupMemoryWriter(&writer);
+    
+    return status;
+}
+
+/**
+ * Makes the memory block containing the snapshot file available, preferably by mapping it.
+ */
+static int loadSnapshot(IFF_Snapshot *snapshot, FILE *file)
+{
+    long size;
+    
+    if(fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0 || (size_t)size < sizeof(SnapshotHeader))
+	return FALSE;
+    
+    snapshot->mappingSize = size;
+    
+#ifdef IFF_SNAPSHOT_MMAP
+    snapshot->mapping = mmap(NULL, snapshot->mappingSize, PROT_READ, MAP_SHARED, fileno(file), 0);
+    
+    if(snapshot->mapping != MAP_FAILED)
+    {
+	snapshot->mapped = TRUE;
+	return TRUE;
+    }
+#endif
+    
+    /* If the file cannot be mapped, we read a copy of it */
+    snapshot->mapped = FALSE;
+    
+    if((snapshot->mapping = malloc(snapshot->mappingSize)) == NULL)
+	return FALSE;
+    
+    return (fread(snapshot->mapping, sizeof(IFF_UByte), snapshot->mappingSize, file) == snapshot->mappingSize);
+}
+
+static void unloadSnapshot(IFF_Snapshot *snapshot)
+{
+#ifdef IFF_SNAPSHOT_MMAP
+    if(snapshot->mapped)
+    {
+	munmap(snapshot->mapping, snapshot->mappingSize);
+	return;
+    }
+#endif
+    free(snapshot->mapping);
+}
+
+/**
+ * Checks whether a node index read from a snapshot refers to a node that is
+ * stored after the given node, or is IFF_FLAT_NO_NODE.
+ */
+static int isFollowingNode(const unsigned int node, const unsigned int other, const IFF_ULong n)
+{
+    return (other == IFF_FLAT_NO_NODE || (other > node && other < n));
+}
+
+/**
+ * Checks whether the structure of a flat tree read from a snapshot can be used
+ * safely. As the nodes are stored in the order of the file, a parent precedes
+ * its sub chunks and a sub chunk precedes its next sibling, which also rules
+ * out cycles. The chunk of every node must lie within the serialized file.
+ */
+static int checkTree(const IFF_FlatTree *tree, const IFF_ULong dataSize)
+{
+    unsigned int node;
+    
+    for(node = 0; node < tree->nodeLength; node++)
+    {
+	unsigned int parent = tree->parent[node];
+	long offset = tree->offset[node];
+	IFF_Long chunkSize = tree->chunkSize[node];
+	
+	if((node == 0) != (parent == IFF_FLAT_NO_NODE) || (parent != IFF_FLAT_NO_NODE && parent >= node) ||
+	    !isFollowingNode(node, tree->firstChild[node], tree->nodeLength) ||
+	    !isFollowingNode(node, tree->nextSibling[node], tree->nodeLength))
+	    return FALSE;
+	
+	if(offset < 0 || chunkSize < 0 || (IFF_ULong)offset > dataSize || dataSize - (IFF_ULong)offset < HEADER_SIZE ||
+	    (IFF_ULong)chunkSize > dataSize - (IFF_ULong)offset - HEADER_SIZE)
+	    return FALSE;
+    }
+    
+    return TRUE;
+}
+
+/**
+ * Validates the header of a snapshot and lets the flat tree refer to the arrays that follow it.
+ */
+static int attachTree(IFF_Snapshot *snapshot)
+{
+    const IFF_UByte *base = (const IFF_UByte*)snapshot->mapping;
+    SnapshotHeader header;
+    IFF_FlatTree *tree = &snapshot->tree;
+    size_t arraysSize;
+    IFF_ULong n;
+    
+    memcpy(&header, base, sizeof(SnapshotHeader));
+    n = header.nodeLength;
+    
+    if(memcmp(header.magic, SNAPSHOT_MAGIC, IFF_ID_SIZE) != 0 || header.version != SNAPSHOT_VERSION)
+    {
+	IFF_error("Not a snapshot file!\n");
+	return FALSE;
+    }
+    
+    if(header.byteOrder != SNAPSHOT_BYTE_ORDER || header.longSize != sizeof(long))
+    {
+	IFF_error("The snapshot has been written by an incompatible system!\n");
+	return FALSE;
+    }
+    
+    /* A node count that does not fit in the file would overflow the size of the arrays */
+    if(n == 0 || n > snapshot->mappingSize / getArraysSize(1))
+    {
+	IFF_error("The size of the snapshot does not match its header!\n");
+	return FALSE;
+    }
+    
+    arraysSize = getArraysSize(n);
+    
+    if(sizeof(SnapshotHeader) + arraysSize + header.dataSize != snapshot->mappingSize)
+    {
+	IFF_error("The size of the snapshot does not match its header!\n");
+	return FALSE;
+    }
+    
+    base += sizeof(SnapshotHeader);
+    tree->offset = (long*)base;
+    base += n * sizeof(long);
+    tree->chunkId = (IFF_ID*)base;
+    base += n * sizeof(IFF_ID);
+    tree->groupType = (IFF_ID*)base;
+    base += n * sizeof(IFF_ID);
+    tree->chunkSize = (IFF_Long*)base;
+    base += n * sizeof(IFF_Long);
+    tree->parent = (unsigned int*)base;
+    base += n * sizeof(unsigned int);
+    tree->firstChild = (unsigned int*)base;
+    base += n * sizeof(unsigned int);
+    tree->nextSibling = (unsigned int*)base;
+    base += n * sizeof(unsigned int);
+    
+    tree->nodeLength = n;
+    tree->nodeCapacity = n;
+    snapshot->data = base;
+    snapshot->dataSize = header.dataSize;
+    
+    if(!checkTree(tree, header.dataSize))
+    {
+	IFF_error("The structure of the snapshot is corrupt!\n");
+	return FALSE;
+    }
+    
+    return TRUE;
+}
+
+IFF_Snapshot *IFF_openSnapshot(const char *filename)
+{
+    IFF_Snapshot *snapshot;
+    FILE *file = fopen(filename, "rb");
+    int status;
+    
+    if(file == NULL)
+    {
+	IFF_error("ERROR: cannot open file: %s\n", filename);
+	return NULL;
+    }
+    
+    if((snapshot = (IFF_Snapshot*)malloc(sizeof(IFF_Snapshot))) == NULL)
+    {
+	fclose(file);
+	return NULL;
+    }
+    
+    snapshot->mapping = NULL;
+    snapshot->mapped = FALSE;
+    
+    status = loadSnapshot(snapshot, file);
+    fclose(file);
+    
+    if(!status)
+    {
+	IFF_error("ERROR: cannot read snapshot: %s\n", filename);
+	unloadSnapshot(snapshot);
+	free(snapshot);
+	return NULL;
+    }
+    
+    if(!attachTree(snapshot))
+    {
+	IFF_closeSnapshot(snapshot);
+	return NULL;
+    }
+    
+    return snapshot;
+}
+
+const IFF_UByte *IFF_getSnapshotChunkData(const IFF_Snapshot *snapshot, const unsigned int node)
+{
+    return snapshot->data + snapshot->tree.offset[node] + HEADER_SIZE;
+}
+
+void IFF_closeSnapshot(IFF_Snapshot *snapshot)
+{
+    unloadSnapshot(snapshot);
+    free(snapshot);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_SNAPSHOT_H
+#define __IFF_SNAPSHOT_H
+
+#include <stddef.h>
+#include "ifftypes.h"
+#include "chunk.h"
+#include "extension.h"
+#include "flattree.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A snapshot of a chunk hierarchy that has been opened from a snapshot file.
+ *
+ * A snapshot file contains the node arrays of a flat tree, followed by the
+ * serialized IFF file. When a snapshot is opened, the file is mapped into memory
+ * and the arrays of the flat tree refer to it directly, so that nothing has to
+ * be parsed. Snapshot files depend on the byte order and the size of long of the
+ * system that wrote them, and are rejected by other systems.
+ */
+typedef struct
+{
+    /** Flat tree describing the chunk structure. Its arrays refer to the snapshot and must not be freed using IFF_freeFlatTree(). */
+    IFF_FlatTree tree;
+    
+    /** The serialized IFF file. The chunk header of each node is located at its offset in the tree. */
+    const IFF_UByte *data;
+    
+    /** Size of the serialized IFF file in bytes */
+    IFF_ULong dataSize;
+    
+    /** Memory block containing the entire snapshot file */
+    void *mapping;
+    
+    /** Size of the memory block containing the snapshot file */
+    size_t mappingSize;
+    
+    /** Indicates whether the memory block is a mapping of the file or a copy of it */
+    int mapped;
+}
+IFF_Snapshot;
+
+/**
+ * Writes a snapshot of a chunk hierarchy to a file, so that it can be opened
+ * with IFF_openSnapshot() without being parsed.
+ *
+ * @param filename Filename of the snapshot file
+ * @param chunk A chunk hierarchy representing an IFF file
+ * @param extension Extension array which specifies how application file format chunks can be handled
+ * @param extensionLength Length of the extension array
+ * @return TRUE if the snapshot has been successfully written, else FALSE
+ */
+int IFF_freezeChunk(const char *filename, const IFF_Chunk *chunk, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Opens a snapshot file. Where possible, the file is mapped into memory, so that
+ * processes that open the same snapshot share it through the page cache. The
+ * header is validated, as well as the node indices and chunk offsets of the
+ * structure, so that traversing the tree and accessing the chunk data stays
+ * within the snapshot. The IDs and sizes of the chunks are not checked against
+ * the serialized file. The resulting snapshot must be closed using
+ * IFF_closeSnapshot().
+ *
+ * @param filename Filename of the snapshot file
+ * @return The opened snapshot, or NULL if the file cannot be opened or is not a compatible snapshot
+ */
+IFF_Snapshot *IFF_openSnapshot(const char *filename);
+
+/**
+ * Returns the chunk data of the given node of a snapshot, which starts directly
+ * after the chunk header. For a group chunk, it starts with the group type.
+ *
+ * @param snapshot An opened snapshot
+ * @param node Index of a node in the flat tree of the snapshot
+ * @return Pointer to the chunk data inside the snapshot, which is valid until the snapshot is closed
+ */
+const IFF_UByte *IFF_getSnapshotChunkData(const IFF_Snapshot *snapshot, const unsigned int node);
+
+/**
+ * Closes a snapshot and releases its memory.
+ *
+ * @param snapshot An opened snapshot
+ */
+void IFF_closeSnapshot(IFF_Snapshot *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "streamwriter.h"
+#include <stdlib.h>
+#include "id.h"
+#include "io.h"
+#include "error.h"
+#include "memio.h"
+
+/**
+ * @brief Describes a group chunk that has been opened, but not closed yet
+ */
+typedef struct
+{
+    /** Contains a 4 character ID of the group chunk */
+    IFF_ID chunkId;
+    
+    /** Could be either a formType or a contentsType */
+    IFF_ID groupType;
+    
+    /** Number of bytes of the group body that have been written so far */
+    IFF_Long chunkSize;
+    
+    /** Chunk size that has been declared in advance, or -1 if it is unknown */
+    IFF_Long declaredSize;
+    
+    /** Position of the placeholder chunk size in the output to which the group is written */
+    long sizeOffset;
+}
+IFF_StreamWriterFrame;
+
+struct IFF_StreamWriter
+{
+    IFF_Writer *writer;
+    const IFF_Extension *extension;
+    unsigned int extensionLength;
+    
+    /* Indicates whether placeholder sizes can be patched in the writer itself */
+    int seekable;
+    
+    /* Contains the groups of unknown size on non-seekable writers */
+    IFF_MemoryWriter buffer;
+    unsigned int bufferedFrames;
+    
+    /* Stack of open group chunks */
+    IFF_StreamWriterFrame *frame;
+    unsigned int frameLength;
+    unsigned int frameCapacity;
+    
+    /* Indicates whether the main chunk has been completely written */
+    int complete;
+};
+
+IFF_StreamWriter *IFF_createStreamWriter(IFF_Writer *writer, const IFF_Extension *extension, const unsigned int extensionLength)
+{
+    IFF_StreamWriter *stream = (IFF_StreamWriter*)malloc(sizeof(IFF_StreamWriter));
+    
+    if(stream != NULL)
+    {
+	stream->writer = writer;
+	stream->extension = extension;
+	stream->extensionLength = extensionLength;
+	stream->seekable = (IFF_tellWriter(writer) >= 0 && writer->callbacks->seek != NULL);
+	IFF_initMemoryWriter(&stream->buffer);
+	stream->bufferedFrames = 0;
+	stream->frame = NULL;
+	stream->frameLength = 0;
+	stream->frameCapacity = 0;
+	stream->complete = FALSE;
+    }
+    
+    return stream;
+}
+
+/**
+ * Returns the writer to which the next bytes must be written. That is the memory
+ * buffer if a group of unknown size is open on a non-seekable writer.
+ */
+static IFF_Writer *getTarget(IFF_StreamWriter *stream)
+{
+    if(stream->bufferedFrames > 0)
+	return &stream->buffer.base;
+    else
+	return stream->writer;
+}
+
+static int checkStreamOpen(const IFF_StreamWriter *stream)
+{
+    if(stream->complete)
+    {
+	IFF_error("ERROR: The main chunk has already been written!\n");
+	return FALSE;
+    }
+    else
+	return TRUE;
+}
+
+/**
+ * Accounts a completely written chunk in the innermost open group, or marks the
+ * main chunk as complete if there is no open group.
+ */
+static void addChunkSize(IFF_StreamWriter *stream, const IFF_Long chunkSize)
+{
+    if(stream->frameLength == 0)
+	stream->complete = TRUE;
+    else
+    {
+	IFF_StreamWriterFrame *frame = &stream->frame[stream->frameLength - 1];
+	frame->chunkSize += IFF_ID_SIZE + sizeof(IFF_Long) + chunkSize;
+	
+	/* If the size of the nested chunk size is odd, we have to count the padding byte as well */
+	if(chunkSize % 2 != 0)
+	    frame->chunkSize++;
+    }
+}
+
+static int beginGroup(IFF_StreamWriter *stream, const char *chunkId, const char *groupType, const IFF_Long declaredSize)
+{
+    IFF_StreamWriterFrame *frame;
+    IFF_Writer *target;
+    
+    if(!checkStreamOpen(stream))
+	return FALSE;
+    
+    if(IFF_compareId(chunkId, "FORM") != 0 &&
+       IFF_compareId(chunkId, "CAT ") != 0 &&
+       IFF_compareId(chunkId, "LIST") != 0 &&
+       IFF_compareId(chunkId, "PROP") != 0)
+    {
+	IFF_error("ERROR: '");
+	IFF_errorId(chunkId);
+	IFF_error("' is not a group chunk!\n");
+	return FALSE;
+    }
+    
+    if(stream->frameLength == stream->frameCapacity)
+    {
+	unsigned int frameCapacity = stream->frameCapacity == 0 ? 8 : stream->frameCapacity * 2;
+	IFF_StreamWriterFrame *frames = (IFF_StreamWriterFrame*)realloc(stream->frame, frameCapacity * sizeof(IFF_StreamWriterFrame));
+	
+	if(frames == NULL)
+	    return FALSE;
+	
+	stream->frame = frames;
+	stream->frameCapacity = frameCapacity;
+    }
+    
+    frame = &stream->frame[stream->frameLength];
+    IFF_createId(frame->chunkId, chunkId);
+    IFF_createId(frame->groupType, groupType);
+    frame->chunkSize = IFF_ID_SIZE; /* The group type is part of the body */
+    frame->declaredSize = declaredSize;
+    
+    /* A group of unknown size must be buffered if we cannot patch its size afterwards */
+    if(declaredSize < 0 && !stream->seekable)
+	stream->bufferedFrames++;
+    
+    target = getTarget(stream);
+    frame->sizeOffset = declaredSize < 0 ? IFF_tellWriter(target) + IFF_ID_SIZE : -1;
+    stream->frameLength++;
+    
+    if(!IFF_writeChunkHeader(target, frame->chunkId, declaredSize < 0 ? 0 : declaredSize))
+	return FALSE;
+    
+    return IFF_writeId(target, frame->groupType, frame->chunkId, "groupType");
+}
+
+int IFF_beginGroup(IFF_StreamWriter *stream, const char *chunkId, const char *groupType)
+{
+    return beginGroup(stream, chunkId, groupType, -1);
+}
+
+int IFF_beginSizedGroup(IFF_StreamWriter *stream, const char *chunkId, const char *groupType, const IFF_Long chunkSize)
+{
+    if(chunkSize < IFF_ID_SIZE)
+    {
+	IFF_error("ERROR: Invalid chunk size: %d of group chunk: '", chunkSize);
+	IFF_errorId(chunkId);
+	IFF_error("'\n");
+	return FALSE;
+    }
+    else
+	return beginGroup(stream, chunkId, groupType, chunkSize);
+}
+
+int IFF_writeDataChunk(IFF_StreamWriter *stream, const char *chunkId, const void *data, const IFF_Long chunkSize)
+{
+    IFF_Writer *target = getTarget(stream);
+    IFF_ID id;
+    
+    if(stream->frameLength == 0)
+    {
+	IFF_error("ERROR: A data chunk must be written inside a group chunk!\n");
+	return FALSE;
+    }
+    
+    if(chunkSize < 0)
+    {
+	IFF_error("ERROR: Invalid chunk size: %d of data chunk: '", chunkSize);
+	IFF_errorId(chunkId);
+	IFF_error("'\n");
+	return FALSE;
+    }
+    
+    IFF_createId(id, chunkId);
+    
+    if(!IFF_writeChunkHeader(target, id, chunkSize))
+	return FALSE;
+    
+    if(chunkSize > 0 && !IFF_writeData(target, data, chunkSize))
+    {
+	IFF_error("Error writing data of chunk: '");
+	IFF_errorId(id);
+	IFF_error("'\n");
+	return FALSE;
+    }
+    
+    if(!IFF_writePaddingByte(target, chunkSize, id))
+	return FALSE;
+    
+    addChunkSize(stream, chunkSize);
+    return TRUE;
+}
+
+int IFF_writeStreamChunk(IFF_StreamWriter *stream, const IFF_Chunk *chunk)
+{
+    const char *formType = NULL;
+    
+    if(!checkStreamOpen(stream))
+	return FALSE;
+    
+    /* Sub chunks of a FORM or PROP are interpreted in the scope of its form type */
+    if(stream->frameLength > 0)
+    {
+	IFF_StreamWriterFrame *frame = &stream->frame[stream->frameLength - 1];
+	
+	if(IFF_compareId(frame->chunkId, "FORM") == 0 || IFF_compareId(frame->chunkId, "PROP") == 0)
+	    formType = frame->groupType;
+    }
+    
+    if(!IFF_writeChunk(getTarget(stream), chunk, formType, stream->extension, stream->extensionLength))
+	return FALSE;
+    
+    addChunkSize(stream, chunk->chunkSize);
+    return TRUE;
+}
+
+/**
+ * Patches the placeholder chunk size of the given group in the target and moves
+ * back to the end of the output.
+ */
+static int patchChunkSize(IFF_Writer *target, const IFF_StreamWriterFrame *frame)
+{
+    long endOffset = IFF_tellWriter(target);
+    
+    if(endOffset < 0 || !IFF_seekWriter(target, frame->sizeOffset))
+    {
+	IFF_error("ERROR: Cannot seek to the chunk size of: '");
+	IFF_errorId(frame->chunkId);
+	IFF_error("'\n");
+	return FALSE;
+    }
+    
+    if(!IFF_writeLong(target, frame->chunkSize, frame->chunkId, "chunkSize"))
+	return FALSE;
+    
+    return IFF_seekWriter(target, endOffset);
+}
+
+int IFF_endGroup(IFF_StreamWriter *stream)
+{
+    IFF_StreamWriterFrame *frame;
+    IFF_Writer *target = getTarget(stream);
+    
+    if(stream->frameLength == 0)
+    {
+	IFF_error("ERROR: There is no open group chunk to end!\n");
+	return FALSE;
+    }
+    
+    stream->frameLength--;
+    frame = &stream->frame[stream->frameLength];
+    
+    if(frame->declaredSize >= 0)
+    {
+	if(frame->chunkSize != frame->declaredSize)
+	{
+	    IFF_error("ERROR: Declared chunk size: %d of '", frame->declaredSize);
+	    IFF_errorId(frame->chunkId);
+	    IFF_error("' does not match the written size: %d\n", frame->chunkSize);
+	    return FALSE;
+	}
+    }
+    else
+    {
+	if(!patchChunkSize(target, frame))
+	    return FALSE;
+	
+	/* Once the outermost buffered group is complete, nothing in the buffer can change anymore */
+	if(!stream->seekable)
+	{
+	    stream->bufferedFrames--;
+	    
+	    if(stream->bufferedFrames == 0)
+	    {
+		int status = IFF_writeData(stream->writer, stream->buffer.data, stream->buffer.size);
+		IFF_resetMemoryWriter(&stream->buffer);
+		
+		if(!status)
+		{
+		    IFF_error("Error writing buffered chunk: '");
+		    IFF_errorId(frame->chunkId);
+		    IFF_error("'\n");
+		    return FALSE;
+		}
+	    }
+	}
+    }
+    
+    addChunkSize(stream, frame->chunkSize);
+    return TRUE;
+}
+
+int IFF_closeStreamWriter(IFF_StreamWriter *stream)
+{
+    int status = TRUE;
+    
+    while(stream->frameLength > 0)
+    {
+	if(!IFF_endGroup(stream))
+	{
+	    status = FALSE;
+	    break;
+	}
+    }
+    
+    IFF_cleanupMemoryWriter(&stream->buffer);
+    free(stream->frame);
+    free(stream);
+    
+    return status;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __IFF_STREAMWRITER_H
+#define __IFF_STREAMWRITER_H
+
+typedef struct IFF_StreamWriter IFF_StreamWriter;
+
+#include "ifftypes.h"
+#include "chunk.h"
+#include "extension.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Creates a stream writer, which writes an IFF file chunk by chunk without
+ * requiring the chunk hierarchy to be in memory. Group chunks are opened with
+ * IFF_beginGroup() and closed with IFF_endGroup(). Their sizes are written as
+ * placeholders and patched afterwards if the writer is seekable. On a
+ * non-seekable writer, only the open groups of which the size is unknown are
+ * buffered in memory. The resulting stream writer must be closed using
+ * IFF_closeStreamWriter().
+ *
+ * @param writer Writer to which the IFF file is written
+ * @param extension Extension array which specifies how application file format chunks should be handled
+ * @param extensionLength Length of the extension array
+ * @return A stream writer, or NULL if the memory can't be allocated
+ */
+IFF_StreamWriter *IFF_createStreamWriter(IFF_Writer *writer, const IFF_Extension *extension, const unsigned int extensionLength);
+
+/**
+ * Opens a group chunk of which the size is not known in advance.
+ *
+ * @param stream A stream writer instance
+ * @param chunkId A 4 character group chunk id: 'FORM', 'CAT ', 'LIST' or 'PROP'
+ * @param groupType A 4 character form type or contents type
+ * @return TRUE if the group header has been successfully written, else FALSE
+ */
+int IFF_beginGroup(IFF_StreamWriter *stream, const char *chunkId, const char *groupType);
+
+/**
+ * Opens a group chunk of which the size is known in advance. Its contents are
+ * never buffered, not even on non-seekable writers. IFF_endGroup() verifies that
+ * the written contents match the declared size.
+ *
+ * @param stream A stream writer instance
+ * @param chunkId A 4 character group chunk id: 'FORM', 'CAT ', 'LIST' or 'PROP'
+ * @param groupType A 4 character form type or contents type
+ * @param chunkSize Size of the group chunk data, including the group type
+ * @return TRUE if the group header has been successfully written, else FALSE
+ */
+int IFF_beginSizedGroup(IFF_StreamWriter *stream, const char *chunkId, const char *groupType, const IFF_Long chunkSize);
+
+/**
+ * Writes a data chunk into the innermost open group.
+ *
+ * @param stream A stream writer instance
+ * @param chunkId A 4 character chunk id
+ * @param data Body of the data chunk
+ * @param chunkSize Size of the body in bytes
+ * @return TRUE if the data chunk has been successfully written, else FALSE
+ */
+int IFF_writeDataChunk(IFF_StreamWriter *stream, const char *chunkId, const void *data, const IFF_Long chunkSize);
+
+/**
+ * Writes an in-memory chunk hierarchy into the innermost open group, or as the
+ * main chunk if no group is open. The chunk sizes of the hierarchy must be up to date.
+ *
+ * @param stream A stream writer instance
+ * @param chunk An arbitrary group or data chunk
+ * @return TRUE if the chunk has been successfully written, else FALSE
+ */
+int IFF_writeStreamChunk(IFF_StreamWriter *stream, const IFF_Chunk *chunk);
+
+/**
+ * Closes the innermost open group and writes its final size.
+ *
+ * @param stream A stream writer instance
+ * @return TRUE if the group has been successfully closed, else FALSE
+ */
+int IFF_endGroup(IFF_StreamWriter *stream);
+
+/**
+ * Closes all groups that are still open, writes the remaining buffered data
+ * and frees the stream writer. The underlying writer is not closed.
+ *
+ * @param stream A stream writer instance
+ * @return TRUE if the IFF file has been successfully completed, else FALSE
+ */
+int IFF_closeStreamWriter(IFF_StreamWriter *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
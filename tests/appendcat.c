@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <cat.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <catfile.h>
+
+#define FILENAME "appendcat.TEST"
+
+static IFF_Form *createForm(const char *formType, const char *text)
+{
+    IFF_Form *form = IFF_createForm(formType);
+    IFF_RawChunk *rawChunk = IFF_createRawChunk("TEXT");
+    IFF_UByte *chunkData = (IFF_UByte*)malloc(strlen(text) * sizeof(IFF_UByte));
+    
+    memcpy(chunkData, text, strlen(text));
+    IFF_setRawChunkData(rawChunk, chunkData, strlen(text));
+    IFF_addToForm(form, (IFF_Chunk*)rawChunk);
+    
+    return form;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_CAT *cat = IFF_createCAT("TEST");
+    IFF_Form *form1 = createForm("TEST", "abcd");
+    IFF_Form *form2 = createForm("TEST", "abc"); /* Odd size, so a padding byte is required */
+    IFF_Form *otherForm = createForm("OTHR", "abcd");
+    IFF_Chunk *chunk;
+    int status;
+    
+    IFF_addToCAT(cat, (IFF_Chunk*)form1);
+    status = IFF_write(FILENAME, (IFF_Chunk*)cat, NULL, 0);
+    
+    /* Append forms to the file and to the CAT in memory */
+    if(status && (!IFF_appendToCATFile(FILENAME, (IFF_Chunk*)form2, NULL, 0) || !IFF_appendToCATFile(FILENAME, (IFF_Chunk*)form1, NULL, 0)))
+    {
+	fprintf(stderr, "Cannot append forms to the CAT file!\n");
+	status = FALSE;
+    }
+    
+    IFF_addToCAT(cat, (IFF_Chunk*)form2);
+    IFF_addToCAT(cat, (IFF_Chunk*)createForm("TEST", "abcd"));
+    
+    /* A form that does not match the contents type of the CAT must be rejected */
+    if(status && IFF_appendToCATFile(FILENAME, (IFF_Chunk*)otherForm, NULL, 0))
+    {
+	fprintf(stderr, "A form with another form type should not be appended!\n");
+	status = FALSE;
+    }
+    
+    if(status)
+    {
+	chunk = IFF_read(FILENAME, NULL, 0);
+	
+	if(chunk == NULL || !IFF_check(chunk, NULL, 0) || !IFF_compare(chunk, (IFF_Chunk*)cat, NULL, 0))
+	{
+	    fprintf(stderr, "The CAT file does not contain the appended forms!\n");
+	    status = FALSE;
+	}
+	
+	if(chunk != NULL)
+	    IFF_free(chunk, NULL, 0);
+    }
+    
+    /* Files that do not consist of a CAT are rejected */
+    if(status && (!IFF_write(FILENAME, (IFF_Chunk*)otherForm, NULL, 0) || IFF_appendToCATFile(FILENAME, (IFF_Chunk*)form1, NULL, 0)))
+    {
+	fprintf(stderr, "Appending to a file that is not a CAT should fail!\n");
+	status = FALSE;
+    }
+    
+    IFF_free((IFF_Chunk*)otherForm, NULL, 0);
+    IFF_free((IFF_Chunk*)cat, NULL, 0);
+    
+    return (!status);
+}
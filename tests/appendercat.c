@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iff.h>
+#include <cat.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <catfile.h>
+
+#define FILENAME "appendercat.TEST"
+#define NUM_OF_FORMS 100
+
+static IFF_Form *createForm(const unsigned int index)
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    IFF_RawChunk *rawChunk = IFF_createRawChunk("DATA");
+    IFF_Long chunkSize = index % 7 + 1; /* Both odd and even sizes */
+    IFF_UByte *chunkData = (IFF_UByte*)malloc(chunkSize * sizeof(IFF_UByte));
+    IFF_Long i;
+    
+    for(i = 0; i < chunkSize; i++)
+	chunkData[i] = (IFF_UByte)(index + i);
+    
+    IFF_setRawChunkData(rawChunk, chunkData, chunkSize);
+    IFF_addToForm(form, (IFF_Chunk*)rawChunk);
+    
+    return form;
+}
+
+/* Submits forms to the appender and adds them to the expected CAT */
+static int submitForms(IFF_CATAppender *appender, IFF_CAT *cat, const unsigned int first, const unsigned int last)
+{
+    unsigned int i;
+    
+    for(i = first; i < last; i++)
+    {
+	IFF_Form *form = createForm(i);
+	
+	if(!IFF_submitToCATAppender(appender, (IFF_Chunk*)form, NULL, 0))
+	{
+	    IFF_free((IFF_Chunk*)form, NULL, 0);
+	    return FALSE;
+	}
+	
+	IFF_addToCAT(cat, (IFF_Chunk*)form);
+    }
+    
+    return TRUE;
+}
+
+/* Checks whether the file contains exactly the expected CAT */
+static int compareWithFile(const IFF_CAT *cat)
+{
+    IFF_Chunk *chunk = IFF_read(FILENAME, NULL, 0);
+    int status = (chunk != NULL && IFF_check(chunk, NULL, 0) && IFF_compare(chunk, (const IFF_Chunk*)cat, NULL, 0));
+    
+    if(chunk != NULL)
+	IFF_free(chunk, NULL, 0);
+    
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_CAT *cat = IFF_createCAT("TEST");
+    IFF_CATAppender *appender;
+    int status;
+    
+    remove(FILENAME);
+    
+    /* The file is created, and the size of the CAT is up to date after flushing */
+    if((appender = IFF_openCATAppender(FILENAME, "TEST")) == NULL)
+	return 1;
+    
+    status = submitForms(appender, cat, 0, NUM_OF_FORMS / 2) && IFF_flushCATAppender(appender) && compareWithFile(cat);
+    status = submitForms(appender, cat, NUM_OF_FORMS / 2, NUM_OF_FORMS) && status;
+    status = IFF_closeCATAppender(appender) && status && compareWithFile(cat);
+    
+    if(!status)
+	fprintf(stderr, "The CAT file does not contain the submitted forms!\n");
+    
+    /* An existing file is extended */
+    if(status && (appender = IFF_openCATAppender(FILENAME, "TEST")) != NULL)
+    {
+	status = submitForms(appender, cat, 0, 1);
+	status = IFF_closeCATAppender(appender) && status && compareWithFile(cat);
+	
+	if(!status)
+	    fprintf(stderr, "The existing CAT file has not been extended!\n");
+    }
+    
+    IFF_free((IFF_Chunk*)cat, NULL, 0);
+    
+    return (!status);
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ifftypes.h>
+#include <memio.h>
+#include <bufio.h>
+
+#define DATA_FILENAME "bufferedwriter.DATA"
+
+#define CAPACITY 16
+
+static IFF_UByte byteAt(long offset)
+{
+    return (IFF_UByte)(offset * 7 + 3);
+}
+
+/* Checks whether the memory writer contains the expected amount of bytes and the buffered writer the expected amount of pending bytes */
+static int checkSizes(const IFF_MemoryWriter *memoryWriter, const IFF_BufferedWriter *bufferedWriter, IFF_ULong writtenSize, IFF_ULong bufferedSize)
+{
+    return (memoryWriter->size == writtenSize && bufferedWriter->size == bufferedSize);
+}
+
+/* Checks whether the memory writer contains the test pattern from the given position on */
+static int checkPattern(const IFF_MemoryWriter *memoryWriter, IFF_ULong position, IFF_ULong size)
+{
+    IFF_ULong i;
+    
+    for(i = 0; i < size; i++)
+    {
+	if(memoryWriter->data[position + i] != byteAt(i))
+	    return FALSE;
+    }
+    
+    return TRUE;
+}
+
+static int createDataFile(void)
+{
+    FILE *file = fopen(DATA_FILENAME, "wb");
+    long i;
+    
+    if(file == NULL)
+	return FALSE;
+    
+    for(i = 0; i < 3 * CAPACITY; i++)
+	fputc(byteAt(i), file);
+    
+    return (fclose(file) == 0);
+}
+
+int main(int argc, char *argv[])
+{
+    int status = TRUE;
+    IFF_MemoryWriter memoryWriter;
+    IFF_BufferedWriter bufferedWriter;
+    IFF_UByte block[3 * CAPACITY];
+    IFF_ULong i;
+    FILE *dataFile;
+    
+    for(i = 0; i < sizeof(block); i++)
+	block[i] = byteAt(i);
+    
+    /* Small writes are collected in the buffer until it overflows */
+    IFF_initMemoryWriter(&memoryWriter);
+    
+    if(!IFF_initBufferedWriter(&bufferedWriter, (IFF_Writer*)&memoryWriter, CAPACITY))
+    {
+	fprintf(stderr, "Cannot allocate the buffer of the buffered writer!\n");
+	IFF_cleanupMemoryWriter(&memoryWriter);
+	return 1;
+    }
+    
+    if(!IFF_writeData((IFF_Writer*)&bufferedWriter, block, 10) || !checkSizes(&memoryWriter, &bufferedWriter, 0, 10))
+    {
+	fprintf(stderr, "A write that fits in the buffer should not be forwarded!\n");
+	status = FALSE;
+    }
+    
+    if(IFF_tellWriter((IFF_Writer*)&bufferedWriter) != 10)
+    {
+	fprintf(stderr, "The position of the buffered writer should include the buffered bytes!\n");
+	status = FALSE;
+    }
+    
+    if(!IFF_writeData((IFF_Writer*)&bufferedWriter, block + 10, 10) || !checkSizes(&memoryWriter, &bufferedWriter, 10, 10))
+    {
+	fprintf(stderr, "A write that does not fit in the buffer should flush it first!\n");
+	status = FALSE;
+    }
+    
+    if(IFF_tellWriter((IFF_Writer*)&bufferedWriter) != 20)
+    {
+	fprintf(stderr, "The position of the buffered writer should include the flushed and buffered bytes!\n");
+	status = FALSE;
+    }
+    
+    /* A write that is at least as large as the buffer is forwarded directly, after the pending bytes */
+    if(!IFF_writeData((IFF_Writer*)&bufferedWriter, block + 20, CAPACITY) || !checkSizes(&memoryWriter, &bufferedWriter, 20 + CAPACITY, 0))
+    {
+	fprintf(stderr, "A write that is as large as the buffer should be forwarded directly!\n");
+	status = FALSE;
+    }
+    
+    if(!IFF_cleanupBufferedWriter(&bufferedWriter) || memoryWriter.size != 20 + CAPACITY || !checkPattern(&memoryWriter, 0, 20 + CAPACITY))
+    {
+	fprintf(stderr, "The written data should be forwarded in the original order!\n");
+	status = FALSE;
+    }
+    
+    /* Seeking flushes the pending bytes, so that they end up at their original position */
+    IFF_resetMemoryWriter(&memoryWriter);
+    
+    if(!IFF_initBufferedWriter(&bufferedWriter, (IFF_Writer*)&memoryWriter, CAPACITY))
+    {
+	fprintf(stderr, "Cannot allocate the buffer of the buffered writer!\n");
+	IFF_cleanupMemoryWriter(&memoryWriter);
+	return 1;
+    }
+    
+    if(!IFF_writeData((IFF_Writer*)&bufferedWriter, block, 8)
+	|| !IFF_seekWriter((IFF_Writer*)&bufferedWriter, 2)
+	|| !checkSizes(&memoryWriter, &bufferedWriter, 8, 0)
+	|| !IFF_writeData((IFF_Writer*)&bufferedWriter, "XY", 2)
+	|| IFF_tellWriter((IFF_Writer*)&bufferedWriter) != 4
+	|| !IFF_cleanupBufferedWriter(&bufferedWriter)
+	|| memoryWriter.size != 8
+	|| memcmp(memoryWriter.data + 2, "XY", 2) != 0
+	|| !checkPattern(&memoryWriter, 0, 2)
+	|| memoryWriter.data[4] != byteAt(4))
+    {
+	fprintf(stderr, "Seeking should flush the buffered bytes before moving the position!\n");
+	status = FALSE;
+    }
+    
+    /* Copying a range of a file flushes the pending bytes and passes the range through */
+    IFF_resetMemoryWriter(&memoryWriter);
+    
+    if(!createDataFile() || (dataFile = fopen(DATA_FILENAME, "rb")) == NULL)
+    {
+	fprintf(stderr, "Cannot create the data file!\n");
+	IFF_cleanupMemoryWriter(&memoryWriter);
+	return 1;
+    }
+    
+    if(!IFF_initBufferedWriter(&bufferedWriter, (IFF_Writer*)&memoryWriter, CAPACITY))
+    {
+	fprintf(stderr, "Cannot allocate the buffer of the buffered writer!\n");
+	fclose(dataFile);
+	IFF_cleanupMemoryWriter(&memoryWriter);
+	return 1;
+    }
+    
+    if(!IFF_writeData((IFF_Writer*)&bufferedWriter, block, 5)
+	|| !IFF_writeFileData((IFF_Writer*)&bufferedWriter, dataFile, 5, 2 * CAPACITY)
+	|| !checkSizes(&memoryWriter, &bufferedWriter, 5 + 2 * CAPACITY, 0)
+	|| !IFF_cleanupBufferedWriter(&bufferedWriter)
+	|| !checkPattern(&memoryWriter, 0, 5 + 2 * CAPACITY))
+    {
+	fprintf(stderr, "Copying a file range should flush the buffered bytes and write the range after them!\n");
+	status = FALSE;
+    }
+    
+    fclose(dataFile);
+    IFF_cleanupMemoryWriter(&memoryWriter);
+    
+    return (!status);
+}
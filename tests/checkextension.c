@@ -26,14 +26,18 @@ int main(int argc, char *argv[])
 {
     int status;
     IFF_Chunk *chunk = TEST_read("extension.TEST");
+    IFF_Chunk *checkedChunk = TEST_readChecked("extension.TEST");
     
-    /* The given file should be invalid */
-    if(TEST_check(chunk))
+    /* The given file should be invalid, which must also be noticed while reading or streaming it */
+    if(TEST_check(chunk) || checkedChunk != NULL || TEST_checkFile("extension.TEST"))
 	status = 1;
     else
 	status = 0;
 
     TEST_free(chunk);
+    
+    if(checkedChunk != NULL)
+	TEST_free(checkedChunk);
 
     return status;
 }
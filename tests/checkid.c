@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <id.h>
+#include <form.h>
+#include <error.h>
+
+static const char *groupIds[] = {
+    "LIST", "FORM", "PROP", "CAT ", "JJJJ",
+    "LIS1", "LIS2", "LIS3", "LIS4", "LIS5", "LIS6", "LIS7", "LIS8", "LIS9",
+    "FOR1", "FOR2", "FOR3", "FOR4", "FOR5", "FOR6", "FOR7", "FOR8", "FOR9",
+    "CAT1", "CAT2", "CAT3", "CAT4", "CAT5", "CAT6", "CAT7", "CAT8", "CAT9"
+};
+
+#define GROUP_IDS_LENGTH (sizeof(groupIds) / sizeof(const char*))
+
+/* Characters that exercise the boundaries of every character class */
+static const char characters[] = { 0x00, 0x1f, ' ', '!', '.', '0', '1', '9', 'A', 'C', 'F', 'I', 'J', 'L', 'M', 'O', 'P', 'R', 'S', 'T', 'Z', '`', 'a', 'z', '{', '~', 0x7f, (char)0x80, (char)0xff };
+
+#define CHARACTERS_LENGTH (sizeof(characters) / sizeof(char))
+
+static void ignoreError(const char *formatString, va_list ap)
+{
+}
+
+/* Straightforward implementation of the rules of the IFF specification */
+
+static int referenceIdIsValid(const IFF_ID id)
+{
+    unsigned int i;
+    
+    for(i = 0; i < IFF_ID_SIZE; i++)
+    {
+	if(id[i] < 0x20 || id[i] > 0x7e)
+	    return FALSE;
+    }
+    
+    return (id[0] != ' ');
+}
+
+static int referenceIdIsReserved(const IFF_ID id)
+{
+    unsigned int i;
+    
+    for(i = 0; i < GROUP_IDS_LENGTH; i++)
+    {
+	if(IFF_compareId(id, groupIds[i]) == 0)
+	    return TRUE;
+    }
+    
+    return FALSE;
+}
+
+static int referenceFormTypeIsValid(const IFF_ID formType)
+{
+    unsigned int i;
+    
+    if(!referenceIdIsValid(formType) || referenceIdIsReserved(formType))
+	return FALSE;
+    
+    for(i = 0; i < IFF_ID_SIZE; i++)
+    {
+	if((formType[i] >= 'a' && formType[i] <= 'z') || formType[i] == '.')
+	    return FALSE;
+    }
+    
+    return TRUE;
+}
+
+static int checkId(const IFF_ID id)
+{
+    int valid = referenceIdIsValid(id);
+    int reserved = referenceIdIsReserved(id);
+    int formTypeValid = referenceFormTypeIsValid(id);
+    
+    if(IFF_idIsValid(id) != valid || IFF_checkId(id) != valid ||
+	IFF_idIsReserved(id) != reserved ||
+	IFF_formTypeIsValid(id) != formTypeValid || IFF_checkFormType(id) != formTypeValid)
+    {
+	fprintf(stderr, "Unexpected outcome for ID: %02x %02x %02x %02x!\n", (IFF_UByte)id[0], (IFF_UByte)id[1], (IFF_UByte)id[2], (IFF_UByte)id[3]);
+	return FALSE;
+    }
+    else
+	return TRUE;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int i, j, k, l;
+    int status = TRUE;
+    
+    IFF_errorCallback = &ignoreError;
+    
+    /* Every group chunk ID is reserved */
+    for(i = 0; i < GROUP_IDS_LENGTH; i++)
+    {
+	if(!IFF_idIsReserved(groupIds[i]) || IFF_formTypeIsValid(groupIds[i]))
+	{
+	    fprintf(stderr, "Group chunk ID: %s should be reserved!\n", groupIds[i]);
+	    status = FALSE;
+	}
+    }
+    
+    /* Packed IDs are ordered like the IDs themselves */
+    if(IFF_packId("FORM") != IFF_MAKE_ID('F', 'O', 'R', 'M') || IFF_packId("CAT ") >= IFF_packId("CAT1") || IFF_packId("~AAA") >= IFF_packId("\x80" "AAA"))
+    {
+	fprintf(stderr, "Packed IDs should be ordered like the IDs!\n");
+	status = FALSE;
+    }
+    
+    /* All combinations of the boundary characters agree with the reference implementation */
+    for(i = 0; i < CHARACTERS_LENGTH && status; i++)
+    {
+	for(j = 0; j < CHARACTERS_LENGTH; j++)
+	{
+	    for(k = 0; k < CHARACTERS_LENGTH; k++)
+	    {
+		for(l = 0; l < CHARACTERS_LENGTH; l++)
+		{
+		    IFF_ID id;
+		    
+		    id[0] = characters[i];
+		    id[1] = characters[j];
+		    id[2] = characters[k];
+		    id[3] = characters[l];
+		    
+		    if(!checkId(id))
+			status = FALSE;
+		}
+	    }
+	}
+    }
+    
+    return (!status);
+}
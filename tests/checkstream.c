@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <iff.h>
+#include <memio.h>
+#include <checkstream.h>
+#include "listdata.h"
+#include "test.h"
+
+/* Offset of the form type of the first FORM in the test list */
+#define FORM_TYPE_OFFSET 44
+
+/* A FORM with a chunk for which an extension exists, whose chunk size exceeds the size of the file */
+static const IFF_UByte oversizedData[] = {
+    'F', 'O', 'R', 'M', 0x00, 0x00, 0x00, 0x10,
+    'T', 'E', 'S', 'T',
+    'H', 'E', 'L', 'O', 0x7f, 0xff, 0xff, 0xf0,
+    0x01, 0x02, 0x00, 0x03
+};
+
+static int checkBytes(const IFF_UByte *data, const IFF_ULong size)
+{
+    IFF_MemoryReader reader;
+    
+    IFF_initMemoryReader(&reader, data, size);
+    return IFF_checkStream(&reader.base, NULL, 0);
+}
+
+static int checkOversizedFile(void)
+{
+    FILE *file = fopen("oversized.TEST", "wb");
+    
+    if(file == NULL)
+	return TRUE;
+    
+    if(fwrite(oversizedData, sizeof(IFF_UByte), sizeof(oversizedData), file) != sizeof(oversizedData))
+    {
+	fclose(file);
+	return TRUE;
+    }
+    
+    fclose(file);
+    return TEST_checkFile("oversized.TEST");
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *chunk = (IFF_Chunk*)IFF_createTestList();
+    IFF_MemoryWriter writer;
+    int status;
+    
+    IFF_initMemoryWriter(&writer);
+    status = IFF_writeWriter(&writer.base, chunk, NULL, 0);
+    IFF_free(chunk, NULL, 0);
+    
+    if(!status)
+	return 1;
+    
+    /* The test list is valid */
+    if(!checkBytes(writer.data, writer.size))
+    {
+	fprintf(stderr, "The test list should be valid!\n");
+	status = FALSE;
+    }
+    
+    /* A truncated file is rejected, even if only the body of the last chunk is missing */
+    if(checkBytes(writer.data, writer.size - 2))
+    {
+	fprintf(stderr, "A truncated file should be invalid!\n");
+	status = FALSE;
+    }
+    
+    /* A FORM whose form type does not match the contents type of the LIST is rejected */
+    if(memcmp(writer.data + FORM_TYPE_OFFSET, "TEST", IFF_ID_SIZE) != 0)
+    {
+	fprintf(stderr, "The first FORM should be located at the expected offset!\n");
+	status = FALSE;
+    }
+    else
+    {
+	memcpy(writer.data + FORM_TYPE_OFFSET, "OTHR", IFF_ID_SIZE);
+	
+	if(checkBytes(writer.data, writer.size))
+	{
+	    fprintf(stderr, "A FORM with another form type should not be allowed in the LIST!\n");
+	    status = FALSE;
+	}
+    }
+    
+    /* A chunk size that exceeds the size of the file is rejected before the body is read */
+    if(checkOversizedFile())
+    {
+	fprintf(stderr, "A chunk that is larger than the file should be invalid!\n");
+	status = FALSE;
+    }
+    
+    IFF_cleanupMemoryWriter(&writer);
+    
+    return (!status);
+}
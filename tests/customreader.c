@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <memio.h>
+
+/* A reader with custom callbacks that reads from a memory block */
+typedef struct
+{
+    IFF_Reader base;
+    const IFF_UByte *data;
+    IFF_ULong size;
+    IFF_ULong position;
+}
+BlockReader;
+
+static int blockRead(IFF_Reader *reader, void *data, IFF_ULong size)
+{
+    BlockReader *blockReader = (BlockReader*)reader;
+    
+    if(size > blockReader->size - blockReader->position)
+	return FALSE;
+    
+    memcpy(data, blockReader->data + blockReader->position, size);
+    blockReader->position += size;
+    return TRUE;
+}
+
+static const struct IFF_ReaderCallbacks blockReaderCallbacks =
+{
+    &blockRead,
+    NULL
+};
+
+static IFF_Form *createForm(void)
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    IFF_RawChunk *firstChunk = IFF_createRawChunk("BODY");
+    IFF_RawChunk *secondChunk = IFF_createRawChunk("BODY");
+    
+    IFF_setTextData(firstChunk, "body");
+    IFF_setTextData(secondChunk, "body");
+    
+    IFF_addToForm(form, (IFF_Chunk*)firstChunk);
+    IFF_addToForm(form, (IFF_Chunk*)secondChunk);
+    
+    return form;
+}
+
+static IFF_Chunk *readBlock(const IFF_UByte *data, const IFF_ULong size, const unsigned int options)
+{
+    BlockReader reader;
+    
+    /* Everything the library maintains must be reset by IFF_initReader() */
+    memset(&reader, 0xff, sizeof(BlockReader));
+    IFF_initReader(&reader.base, &blockReaderCallbacks);
+    IFF_setReaderOptions(&reader.base, options);
+    reader.data = data;
+    reader.size = size;
+    reader.position = 0;
+    
+    return IFF_readReader(&reader.base, NULL, 0);
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form = createForm();
+    IFF_MemoryWriter writer;
+    IFF_Chunk *chunk;
+    int status;
+    
+    IFF_initMemoryWriter(&writer);
+    status = IFF_writeWriter(&writer.base, (IFF_Chunk*)form, NULL, 0);
+    
+    if(!status)
+	return 1;
+    
+    /* Without options, every body is read into its own allocation */
+    chunk = readBlock(writer.data, writer.size, 0);
+    
+    if(chunk == NULL || !IFF_compare(chunk, (IFF_Chunk*)form, NULL, 0))
+    {
+	fprintf(stderr, "The hierarchy read by a custom reader should be equal to the original!\n");
+	status = FALSE;
+    }
+    else if(((IFF_RawChunk*)((IFF_Form*)chunk)->chunk[0])->sharedData != NULL)
+    {
+	fprintf(stderr, "Bodies should only be shared if the reader has been asked to!\n");
+	status = FALSE;
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    
+    /* With IFF_READ_SHARE_BODIES, identical bodies are stored once */
+    chunk = readBlock(writer.data, writer.size, IFF_READ_SHARE_BODIES);
+    
+    if(chunk == NULL || !IFF_compare(chunk, (IFF_Chunk*)form, NULL, 0))
+    {
+	fprintf(stderr, "The hierarchy with shared bodies should be equal to the original!\n");
+	status = FALSE;
+    }
+    else if(((IFF_RawChunk*)((IFF_Form*)chunk)->chunk[0])->chunkData != ((IFF_RawChunk*)((IFF_Form*)chunk)->chunk[1])->chunkData)
+    {
+	fprintf(stderr, "Identical bodies should be stored only once!\n");
+	status = FALSE;
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    IFF_free((IFF_Chunk*)form, NULL, 0);
+    IFF_cleanupMemoryWriter(&writer);
+    
+    return (!status);
+}
@@ -0,0 +1,11 @@
+#!/bin/sh -e
+
+../src/iffjoin/iffjoin -o diff-different1.IFF join.HELO join.BYE
+../src/iffjoin/iffjoin -o diff-different2.IFF join.HELO join.HELO join.BYE
+
+# An inserted chunk is reported as added, while the identical chunks around it are skipped
+test "`../src/iffdiff/iffdiff diff-different1.IFF diff-different2.IFF || true`" = "+ /CAT :JJJJ[0]/FORM:HELO[1]"
+
+# A modified body is reported by the path of its chunk
+tr d x < diff-different1.IFF > diff-different3.IFF
+test "`../src/iffdiff/iffdiff diff-different1.IFF diff-different3.IFF || true`" = "! /CAT :JJJJ[0]/FORM:HELO[0]/ABCD[0]"
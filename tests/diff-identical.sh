@@ -0,0 +1,4 @@
+#!/bin/sh -e
+
+../src/iffjoin/iffjoin -o diff-identical.IFF join.HELO join.BYE
+test "x`../src/iffdiff/iffdiff diff-identical.IFF diff-identical.IFF`" = "x"
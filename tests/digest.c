@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <iff.h>
+#include <form.h>
+#include <list.h>
+#include <rawchunk.h>
+#include <digest.h>
+#include "listdata.h"
+
+static IFF_RawChunk *getByeChunk(IFF_List *list, unsigned int index)
+{
+    return (IFF_RawChunk*)((IFF_Form*)list->chunk[index])->chunk[0];
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_List *list1 = IFF_createTestList();
+    IFF_List *list2 = IFF_createTestList();
+    IFF_Digest digest1, digest2;
+    IFF_RawChunk *byeChunk = getByeChunk(list2, 0);
+    int status = TRUE;
+    
+    /* Identical hierarchies have identical digests, which are only cached on request */
+    if(!IFF_computeChunkDigest((IFF_Chunk*)list1, NULL, NULL, 0, &digest1) ||
+	!IFF_computeChunkDigest((IFF_Chunk*)list2, NULL, NULL, 0, &digest2) ||
+	!IFF_compareDigest(&digest1, &digest2))
+    {
+	fprintf(stderr, "Identical hierarchies should have identical digests!\n");
+	status = FALSE;
+    }
+    
+    if(!IFF_compare((IFF_Chunk*)list1, (IFF_Chunk*)list2, NULL, 0) || (IFF_CHUNK_META(list1)->flags & IFF_CHUNK_DIGEST_VALID) || (IFF_CHUNK_META(list2)->flags & IFF_CHUNK_DIGEST_VALID))
+    {
+	fprintf(stderr, "Computing digests and comparing without caching should leave the hierarchies untouched!\n");
+	status = FALSE;
+    }
+    
+    if(!IFF_compareCached((IFF_Chunk*)list1, (IFF_Chunk*)list2, NULL, 0))
+    {
+	fprintf(stderr, "Identical hierarchies should be equal!\n");
+	status = FALSE;
+    }
+    
+    /* Modifying a body invalidates the digests of the chunk and its ancestors only */
+    byeChunk->chunkData[0] = 'z';
+    IFF_markChunkDirty((IFF_Chunk*)byeChunk);
+    
+    if((IFF_CHUNK_META(list2)->flags & IFF_CHUNK_DIGEST_VALID) || (IFF_CHUNK_META(list2->chunk[0])->flags & IFF_CHUNK_DIGEST_VALID) || (IFF_CHUNK_META(byeChunk)->flags & IFF_CHUNK_DIGEST_VALID))
+    {
+	fprintf(stderr, "The digests of the modified chunk and its ancestors should be invalid!\n");
+	status = FALSE;
+    }
+    
+    if(!(IFF_CHUNK_META(list2->chunk[1])->flags & IFF_CHUNK_DIGEST_VALID) || !(IFF_CHUNK_META(list2->prop[0])->flags & IFF_CHUNK_DIGEST_VALID))
+    {
+	fprintf(stderr, "The digests of unmodified chunks should stay valid!\n");
+	status = FALSE;
+    }
+    
+    if(IFF_compareCached((IFF_Chunk*)list1, (IFF_Chunk*)list2, NULL, 0))
+    {
+	fprintf(stderr, "A modified hierarchy should not be equal!\n");
+	status = FALSE;
+    }
+    
+    /* Restoring the body makes the hierarchies equal again */
+    byeChunk->chunkData[0] = 'a';
+    IFF_markChunkDirty((IFF_Chunk*)byeChunk);
+    
+    if(!IFF_compareCached((IFF_Chunk*)list1, (IFF_Chunk*)list2, NULL, 0))
+    {
+	fprintf(stderr, "A restored hierarchy should be equal again!\n");
+	status = FALSE;
+    }
+    
+    /* Equal digests do not make different chunks equal, as digests may collide */
+    byeChunk->chunkData[0] = 'z';
+    IFF_markChunkDirty((IFF_Chunk*)byeChunk);
+    
+    if(IFF_cacheChunkDigest((IFF_Chunk*)byeChunk, NULL, NULL, 0, &digest2))
+    {
+	IFF_RawChunk *otherByeChunk = getByeChunk(list1, 0);
+	
+	IFF_CHUNK_META(byeChunk)->digest = IFF_CHUNK_META(otherByeChunk)->digest;
+	
+	if(IFF_compare((IFF_Chunk*)byeChunk, (IFF_Chunk*)otherByeChunk, NULL, 0))
+	{
+	    fprintf(stderr, "Chunks with colliding digests should not be equal!\n");
+	    status = FALSE;
+	}
+    }
+    else
+	status = FALSE;
+    
+    byeChunk->chunkData[0] = 'a';
+    IFF_markChunkDirty((IFF_Chunk*)byeChunk);
+    
+    /* Changing a group membership invalidates the digests as well */
+    if(status)
+    {
+	IFF_Chunk *form = list2->chunk[1];
+	
+	if(!IFF_removeFromList(list2, form) || IFF_compareCached((IFF_Chunk*)list1, (IFF_Chunk*)list2, NULL, 0))
+	{
+	    fprintf(stderr, "A hierarchy from which a chunk has been removed should not be equal!\n");
+	    status = FALSE;
+	}
+	
+	IFF_free(form, NULL, 0);
+    }
+    
+    IFF_free((IFF_Chunk*)list1, NULL, 0);
+    IFF_free((IFF_Chunk*)list2, NULL, 0);
+    
+    return (!status);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <memio.h>
+#include <flattree.h>
+#include "listdata.h"
+
+#define FILENAME "flattree.TEST"
+#define TRUNCATED_FILENAME "flattree-truncated.TEST"
+
+#define NUM_OF_NODES 7
+
+/* The chunk structure of the test list, in the order in which the chunks appear in the file */
+static const char *chunkIds[] = { "LIST", "PROP", "HELO", "FORM", "BYE ", "FORM", "BYE " };
+static const long offsets[] = { 0, 12, 24, 36, 48, 60, 72 };
+static const unsigned int parents[] = { IFF_FLAT_NO_NODE, 0, 1, 0, 3, 0, 5 };
+static const unsigned int firstChildren[] = { 1, 2, IFF_FLAT_NO_NODE, 4, IFF_FLAT_NO_NODE, 6, IFF_FLAT_NO_NODE };
+static const unsigned int nextSiblings[] = { IFF_FLAT_NO_NODE, 3, IFF_FLAT_NO_NODE, 5, IFF_FLAT_NO_NODE, IFF_FLAT_NO_NODE, IFF_FLAT_NO_NODE };
+
+static int checkTree(const IFF_FlatTree *tree)
+{
+    unsigned int i, formsLength;
+    unsigned int *forms;
+    int status = TRUE;
+    
+    if(tree == NULL || tree->nodeLength != NUM_OF_NODES)
+    {
+	fprintf(stderr, "The flat tree should consist of %d nodes!\n", NUM_OF_NODES);
+	return FALSE;
+    }
+    
+    for(i = 0; i < NUM_OF_NODES; i++)
+    {
+	if(memcmp(tree->chunkId[i], chunkIds[i], IFF_ID_SIZE) != 0 || tree->offset[i] != offsets[i] ||
+	    tree->parent[i] != parents[i] || tree->firstChild[i] != firstChildren[i] || tree->nextSibling[i] != nextSiblings[i])
+	{
+	    fprintf(stderr, "Node %u does not match the structure of the test list!\n", i);
+	    status = FALSE;
+	}
+    }
+    
+    if(tree->chunkSize[0] != 76 || tree->chunkSize[4] != 4 || memcmp(tree->groupType[0], "TEST", IFF_ID_SIZE) != 0)
+    {
+	fprintf(stderr, "The chunk sizes or group types do not match!\n");
+	status = FALSE;
+    }
+    
+    if(!IFF_checkFlatTree(tree))
+    {
+	fprintf(stderr, "The flat tree should be valid!\n");
+	status = FALSE;
+    }
+    
+    forms = IFF_searchFlatForms(tree, "TEST", &formsLength);
+    
+    if(formsLength != 2 || forms[0] != 3 || forms[1] != 5)
+    {
+	fprintf(stderr, "The search should find the two TEST forms!\n");
+	status = FALSE;
+    }
+    
+    free(forms);
+    
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *chunk = (IFF_Chunk*)IFF_createTestList();
+    IFF_MemoryWriter writer;
+    IFF_MemoryReader reader;
+    IFF_FlatTree *tree;
+    FILE *file;
+    int status;
+    
+    IFF_initMemoryWriter(&writer);
+    status = IFF_writeWriter(&writer.base, chunk, NULL, 0) && IFF_write(FILENAME, chunk, NULL, 0);
+    IFF_free(chunk, NULL, 0);
+    
+    if(!status)
+	return 1;
+    
+    /* Read the structure from a seekable file */
+    tree = IFF_readFlatTree(FILENAME);
+    
+    if(!checkTree(tree))
+	status = FALSE;
+    
+    if(tree != NULL)
+	IFF_freeFlatTree(tree);
+    
+    /* Read the structure from a reader */
+    IFF_initMemoryReader(&reader, writer.data, writer.size);
+    tree = IFF_readFlatTreeReader(&reader.base);
+    
+    if(!checkTree(tree))
+	status = FALSE;
+    
+    if(tree != NULL)
+	IFF_freeFlatTree(tree);
+    
+    /* A truncated file is rejected, even if only the body of the last chunk is missing */
+    if((file = fopen(TRUNCATED_FILENAME, "wb")) != NULL)
+    {
+	fwrite(writer.data, sizeof(IFF_UByte), writer.size - 2, file);
+	fclose(file);
+	
+	if((tree = IFF_readFlatTree(TRUNCATED_FILENAME)) != NULL)
+	{
+	    fprintf(stderr, "Reading a truncated file should fail!\n");
+	    IFF_freeFlatTree(tree);
+	    status = FALSE;
+	}
+    }
+    
+    IFF_cleanupMemoryWriter(&writer);
+    
+    return (!status);
+}
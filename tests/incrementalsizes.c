@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <cat.h>
+#include <form.h>
+#include <list.h>
+#include <prop.h>
+#include <rawchunk.h>
+
+static IFF_UByte *createData(const char *text)
+{
+    IFF_UByte *data = (IFF_UByte*)malloc(strlen(text) * sizeof(IFF_UByte));
+    memcpy(data, text, strlen(text));
+    return data;
+}
+
+/* Checks whether the chunk sizes are consistent without recalculating them */
+static int checkSizes(const IFF_Chunk *chunk, const char *step)
+{
+    if(IFF_check(chunk, NULL, 0))
+	return TRUE;
+    else
+    {
+	fprintf(stderr, "Chunk sizes are inconsistent after: %s\n", step);
+	return FALSE;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_List *list = IFF_createList("TEST");
+    IFF_Prop *prop = IFF_createProp("TEST");
+    IFF_Form *form = IFF_createForm("TEST");
+    IFF_CAT *cat = IFF_createCAT("TEST");
+    IFF_RawChunk *heloChunk = IFF_createRawChunk("HELO");
+    IFF_RawChunk *byeChunk = IFF_createRawChunk("BYE ");
+    IFF_RawChunk *propChunk = IFF_createRawChunk("BYE ");
+    int status;
+    
+    /* Compose the hierarchy top-down, so that every addition must be propagated to the ancestors */
+    IFF_addToList(list, (IFF_Chunk*)cat);
+    IFF_addToCAT(cat, (IFF_Chunk*)form);
+    IFF_addToForm(form, (IFF_Chunk*)heloChunk);
+    IFF_addToForm(form, (IFF_Chunk*)byeChunk);
+    IFF_addPropToList(list, prop);
+    IFF_addToProp(prop, (IFF_Chunk*)propChunk);
+    
+    IFF_setRawChunkData(heloChunk, createData("abcd"), 4);
+    IFF_setRawChunkData(byeChunk, createData("EFG"), 3); /* Odd size, so a padding byte is added */
+    IFF_setRawChunkData(propChunk, createData("HIJKL"), 5);
+    
+    status = checkSizes((IFF_Chunk*)list, "composing the hierarchy");
+    
+    /* Grow a chunk, which removes the padding byte */
+    free(byeChunk->chunkData);
+    IFF_setRawChunkData(byeChunk, createData("EFGH"), 4);
+    status = status && checkSizes((IFF_Chunk*)list, "growing a chunk to an even size");
+    
+    /* Shrink a chunk, which adds the padding byte */
+    free(heloChunk->chunkData);
+    IFF_setRawChunkData(heloChunk, createData("a"), 1);
+    status = status && checkSizes((IFF_Chunk*)list, "shrinking a chunk to an odd size");
+    
+    /* Remove a data chunk and a PROP chunk */
+    if(status && (!IFF_removeFromForm(form, (IFF_Chunk*)byeChunk) || !IFF_removePropFromList(list, prop)))
+    {
+	fprintf(stderr, "Cannot remove chunks!\n");
+	status = FALSE;
+    }
+    
+    status = status && checkSizes((IFF_Chunk*)list, "removing chunks");
+    
+    /* A removed chunk is no longer a member */
+    if(status && (byeChunk->parent != NULL || IFF_removeFromForm(form, (IFF_Chunk*)byeChunk)))
+    {
+	fprintf(stderr, "The removed chunk is still a member!\n");
+	status = FALSE;
+    }
+    
+    IFF_free((IFF_Chunk*)byeChunk, NULL, 0);
+    IFF_free((IFF_Chunk*)prop, NULL, 0);
+    IFF_free((IFF_Chunk*)list, NULL, 0);
+    
+    return (!status);
+}
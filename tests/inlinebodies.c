@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <fileio.h>
+
+#define FILENAME "inlinebodies.TEST"
+
+/* Larger than the inline storage, so that it is allocated separately */
+#define LARGE_SIZE (IFF_INLINE_BODY_SIZE + 1)
+
+/* Exactly fills the inline storage, so that the chunk has the largest pooled size */
+#define MAXIMUM_SIZE IFF_INLINE_BODY_SIZE
+
+static IFF_Form *createForm(void)
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    IFF_RawChunk *smallChunk = IFF_createRawChunk("SMAL");
+    IFF_RawChunk *largeChunk = IFF_createRawChunk("LARG");
+    IFF_RawChunk *maximumChunk = IFF_createRawChunk("MAXI");
+    IFF_UByte *chunkData = (IFF_UByte*)malloc(LARGE_SIZE * sizeof(IFF_UByte));
+    IFF_UByte *maximumData = (IFF_UByte*)malloc(MAXIMUM_SIZE * sizeof(IFF_UByte));
+    
+    memset(chunkData, 'x', LARGE_SIZE);
+    memset(maximumData, 'y', MAXIMUM_SIZE);
+    
+    IFF_setTextData(smallChunk, "abcde"); /* Odd size, so a padding byte follows the body */
+    IFF_setRawChunkData(largeChunk, chunkData, LARGE_SIZE);
+    IFF_setRawChunkData(maximumChunk, maximumData, MAXIMUM_SIZE);
+    
+    IFF_addToForm(form, (IFF_Chunk*)smallChunk);
+    IFF_addToForm(form, (IFF_Chunk*)largeChunk);
+    IFF_addToForm(form, (IFF_Chunk*)maximumChunk);
+    
+    return form;
+}
+
+static IFF_Chunk *readInline(void)
+{
+    IFF_FileReader reader;
+    IFF_Chunk *chunk;
+    FILE *file = fopen(FILENAME, "rb");
+    
+    if(file == NULL)
+	return NULL;
+    
+    IFF_initFileReader(&reader, file);
+    IFF_setReaderOptions(&reader.base, IFF_READ_INLINE_BODIES);
+    chunk = IFF_readReader(&reader.base, NULL, 0);
+    fclose(file);
+    
+    return chunk;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form = createForm();
+    IFF_Chunk *chunk;
+    IFF_RawChunk *smallChunk, *largeChunk, *maximumChunk;
+    IFF_UByte *chunkData;
+    int status;
+    
+    if(!IFF_write(FILENAME, (IFF_Chunk*)form, NULL, 0) || (chunk = readInline()) == NULL)
+	return 1;
+    
+    status = IFF_compare(chunk, (IFF_Chunk*)form, NULL, 0);
+    
+    if(!status)
+	fprintf(stderr, "The hierarchy with inline bodies should be equal to the original!\n");
+    
+    smallChunk = (IFF_RawChunk*)((IFF_Form*)chunk)->chunk[0];
+    largeChunk = (IFF_RawChunk*)((IFF_Form*)chunk)->chunk[1];
+    maximumChunk = (IFF_RawChunk*)((IFF_Form*)chunk)->chunk[2];
+    
+    if(!(IFF_CHUNK_META(smallChunk)->flags & IFF_CHUNK_INLINE_STORAGE) || smallChunk->chunkData != (IFF_UByte*)(smallChunk + 1))
+    {
+	fprintf(stderr, "The small body should be stored inline!\n");
+	status = FALSE;
+    }
+    
+    if(IFF_CHUNK_META(largeChunk)->flags & IFF_CHUNK_INLINE_STORAGE)
+    {
+	fprintf(stderr, "The large body should not be stored inline!\n");
+	status = FALSE;
+    }
+    
+    if(!(IFF_CHUNK_META(maximumChunk)->flags & IFF_CHUNK_INLINE_STORAGE) || maximumChunk->chunkData != (IFF_UByte*)(maximumChunk + 1))
+    {
+	fprintf(stderr, "A body of the maximum inline size should be stored inline!\n");
+	status = FALSE;
+    }
+    
+    /* Replace the inline body, after which the new body must be written */
+    chunkData = (IFF_UByte*)malloc(2 * sizeof(IFF_UByte));
+    memcpy(chunkData, "fg", 2);
+    IFF_setRawChunkData(smallChunk, chunkData, 2);
+    
+    if(status)
+    {
+	IFF_Chunk *copy;
+	
+	if(!IFF_write(FILENAME, chunk, NULL, 0) || (copy = IFF_read(FILENAME, NULL, 0)) == NULL)
+	    return 1;
+	
+	if(!IFF_compare(chunk, copy, NULL, 0))
+	{
+	    fprintf(stderr, "The file should contain the replaced body!\n");
+	    status = FALSE;
+	}
+	
+	IFF_free(copy, NULL, 0);
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    IFF_free((IFF_Chunk*)form, NULL, 0);
+    
+    return (!status);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <iff.h>
+#include <id.h>
+#include <form.h>
+#include <memio.h>
+#include <layout.h>
+
+typedef struct
+{
+    IFF_Group *parent;
+    
+    IFF_ID chunkId;
+    IFF_Long chunkSize;
+    
+    IFF_UByte a;
+    IFF_Byte b;
+    IFF_UWord c[3];
+    IFF_Word d;
+    IFF_ULong e;
+    IFF_Long f;
+    IFF_ID g;
+}
+TEST_Sample;
+
+static const IFF_Field sampleFields[] = {
+    {"a", IFF_FIELD_UBYTE, offsetof(TEST_Sample, a), 1},
+    {"b", IFF_FIELD_BYTE, offsetof(TEST_Sample, b), 1},
+    {"c", IFF_FIELD_UWORD, offsetof(TEST_Sample, c), 3},
+    {"d", IFF_FIELD_WORD, offsetof(TEST_Sample, d), 1},
+    {"e", IFF_FIELD_ULONG, offsetof(TEST_Sample, e), 1},
+    {"f", IFF_FIELD_LONG, offsetof(TEST_Sample, f), 1},
+    {"g", IFF_FIELD_ID, offsetof(TEST_Sample, g), 1}
+};
+
+static const IFF_ChunkLayout sampleLayout = {
+    sizeof(TEST_Sample), sizeof(sampleFields) / sizeof(IFF_Field), sampleFields
+};
+
+/* Only the layout is given, the library provides all functions */
+static IFF_FormExtension testFormExtension[] = {
+    {"SMPL", NULL, NULL, NULL, NULL, NULL, NULL, &sampleLayout}
+};
+
+static IFF_Extension extension[] = {
+    {"TEST", 1, testFormExtension}
+};
+
+/* Big endian encoding of the sample body */
+static const IFF_UByte sampleBody[] = {
+    0x12,
+    0xfe,
+    0x01, 0x02, 0xff, 0xfe, 0x80, 0x00,
+    0xfe, 0xd4,
+    0xde, 0xad, 0xbe, 0xef,
+    0xff, 0xff, 0xff, 0xfe,
+    'A', 'B', 'C', 'D'
+};
+
+#define SAMPLE_BODY_SIZE sizeof(sampleBody)
+
+/* Offset of the sample body in the written FORM, behind the FORM header, form type and sample chunk header */
+#define SAMPLE_BODY_OFFSET 20
+
+static IFF_Form *createTestForm(void)
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    TEST_Sample *sample = (TEST_Sample*)IFF_createLayoutChunk("SMPL", &sampleLayout);
+    
+    sample->a = 0x12;
+    sample->b = -2;
+    sample->c[0] = 0x0102;
+    sample->c[1] = 0xfffe;
+    sample->c[2] = 0x8000;
+    sample->d = -300;
+    sample->e = 0xdeadbeef;
+    sample->f = -2;
+    IFF_createId(sample->g, "ABCD");
+    
+    IFF_addToForm(form, (IFF_Chunk*)sample);
+    
+    return form;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form = createTestForm();
+    IFF_Chunk *chunk = NULL;
+    IFF_MemoryWriter writer;
+    IFF_MemoryReader reader;
+    int status = TRUE;
+    
+    if(((IFF_Chunk*)form->chunk[0])->chunkSize != SAMPLE_BODY_SIZE || IFF_computeLayoutSize(&sampleLayout) != SAMPLE_BODY_SIZE)
+    {
+	fprintf(stderr, "The chunk size should be the size of the layout!\n");
+	status = FALSE;
+    }
+    
+    /* The fields are written in big endian order */
+    IFF_initMemoryWriter(&writer);
+    
+    if(!IFF_writeWriter(&writer.base, (IFF_Chunk*)form, extension, 1) ||
+	writer.size != SAMPLE_BODY_OFFSET + SAMPLE_BODY_SIZE ||
+	memcmp(writer.data + SAMPLE_BODY_OFFSET, sampleBody, SAMPLE_BODY_SIZE) != 0)
+    {
+	fprintf(stderr, "The sample chunk should be written in big endian order!\n");
+	status = FALSE;
+    }
+    
+    /* Reading the fields yields the same chunk */
+    IFF_initMemoryReader(&reader, writer.data, writer.size);
+    
+    if((chunk = IFF_readReader(&reader.base, extension, 1)) == NULL ||
+	!IFF_check(chunk, extension, 1) ||
+	!IFF_compare(chunk, (IFF_Chunk*)form, extension, 1))
+    {
+	fprintf(stderr, "The sample chunk should be read back unchanged!\n");
+	status = FALSE;
+    }
+    
+    if(chunk != NULL)
+    {
+	const TEST_Sample *sample = (const TEST_Sample*)((IFF_Form*)chunk)->chunk[0];
+	
+	if(sample->b != -2 || sample->c[1] != 0xfffe || sample->d != -300 || sample->f != -2 || IFF_compareId(sample->g, "ABCD") != 0)
+	{
+	    fprintf(stderr, "The signed fields should be decoded correctly!\n");
+	    status = FALSE;
+	}
+	
+	IFF_print(chunk, 0, extension, 1);
+	IFF_free(chunk, extension, 1);
+    }
+    
+    /* A modified field makes the chunks different */
+    ((TEST_Sample*)form->chunk[0])->c[2] = 0x7fff;
+    IFF_markChunkDirty(form->chunk[0]);
+    IFF_initMemoryReader(&reader, writer.data, writer.size);
+    
+    if((chunk = IFF_readReader(&reader.base, extension, 1)) == NULL || IFF_compare(chunk, (IFF_Chunk*)form, extension, 1))
+    {
+	fprintf(stderr, "A modified sample chunk should be different!\n");
+	status = FALSE;
+    }
+    
+    if(chunk != NULL)
+	IFF_free(chunk, extension, 1);
+    
+    /* A body that does not match the size of the layout is rejected */
+    writer.data[SAMPLE_BODY_OFFSET - 1]--;
+    writer.data[7]--;
+    IFF_initMemoryReader(&reader, writer.data, writer.size - 1);
+    
+    if((chunk = IFF_readReader(&reader.base, extension, 1)) != NULL)
+    {
+	fprintf(stderr, "A sample chunk with a different size should be rejected!\n");
+	IFF_free(chunk, extension, 1);
+	status = FALSE;
+    }
+    
+    IFF_cleanupMemoryWriter(&writer);
+    IFF_free((IFF_Chunk*)form, extension, 1);
+    
+    return (!status);
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <iff.h>
+#include <pushparser.h>
+#include "catdata.h"
+
+static unsigned int groupsBegun = 0;
+static unsigned int chunksEnded = 0;
+
+static void beginGroup(const IFF_Group *group, void *userData)
+{
+    groupsBegun++;
+}
+
+static int endChunk(IFF_Chunk *chunk, const IFF_Group *parent, void *userData)
+{
+    chunksEnded++;
+    return FALSE;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_PushParserCallbacks callbacks = { &beginGroup, &endChunk };
+    IFF_PushParser *parser = IFF_createPushParser(&callbacks, NULL, NULL, 0);
+    IFF_Chunk *chunk;
+    FILE *file = fopen("cat.TEST", "rb");
+    int byte;
+    
+    if(file == NULL)
+    {
+	fprintf(stderr, "Cannot open 'cat.TEST'\n");
+	IFF_freePushParser(parser);
+	return 1;
+    }
+    
+    /* Feed the file one byte at a time, so that every parser state is interrupted */
+    while((byte = fgetc(file)) != EOF)
+    {
+	IFF_UByte data = byte;
+	
+	if(!IFF_pushFeed(parser, &data, 1))
+	{
+	    fprintf(stderr, "Cannot parse 'cat.TEST'\n");
+	    fclose(file);
+	    IFF_freePushParser(parser);
+	    return 1;
+	}
+    }
+    
+    fclose(file);
+    
+    chunk = IFF_pushFinish(parser);
+    IFF_freePushParser(parser);
+    
+    if(chunk == NULL)
+	return 1;
+    else
+    {
+	IFF_CAT *cat = IFF_createTestCAT();
+	int status = IFF_compare(chunk, (IFF_Chunk*)cat, NULL, 0);
+	
+	/* The CAT and its two forms are groups and each form has two data chunks */
+	if(groupsBegun != 3 || chunksEnded != 7)
+	{
+	    fprintf(stderr, "Unexpected number of events: %u groups, %u chunks\n", groupsBegun, chunksEnded);
+	    status = FALSE;
+	}
+	
+	IFF_free(chunk, NULL, 0);
+	IFF_free((IFF_Chunk*)cat, NULL, 0);
+	
+	return (!status);
+    }
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <iff.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <fileio.h>
+#include <bodysink.h>
+#include <passthrough.h>
+
+#define SOURCE_FILENAME "bodysink-source.TEST"
+#define FILENAME "bodysink.TEST"
+
+/* An odd size that spans multiple blocks, so that the padding byte is involved as well */
+#define BODY_SIZE (3 * IFF_BODY_BLOCK_SIZE + 1001)
+
+typedef struct
+{
+    unsigned int begun;
+    unsigned int ended;
+    IFF_ULong size;
+    IFF_ULong maxBlockSize;
+    unsigned long sum;
+}
+SinkState;
+
+static int beginBody(const IFF_ID chunkId, const IFF_Long chunkSize, void *userData)
+{
+    SinkState *state = (SinkState*)userData;
+    state->begun++;
+    return TRUE;
+}
+
+static int consumeBody(const IFF_UByte *block, const IFF_ULong size, void *userData)
+{
+    SinkState *state = (SinkState*)userData;
+    IFF_ULong i;
+    
+    for(i = 0; i < size; i++)
+	state->sum += block[i];
+    
+    state->size += size;
+    
+    if(size > state->maxBlockSize)
+	state->maxBlockSize = size;
+    
+    return TRUE;
+}
+
+static int endBody(void *userData)
+{
+    SinkState *state = (SinkState*)userData;
+    state->ended++;
+    return TRUE;
+}
+
+static IFF_Form *createForm(unsigned long *sum)
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    IFF_RawChunk *bodyChunk = IFF_createRawChunk("BODY");
+    IFF_RawChunk *textChunk = IFF_createRawChunk("TEXT");
+    IFF_UByte *chunkData = (IFF_UByte*)malloc(BODY_SIZE * sizeof(IFF_UByte));
+    unsigned int i;
+    
+    *sum = 0;
+    
+    for(i = 0; i < BODY_SIZE; i++)
+    {
+	chunkData[i] = (IFF_UByte)(i * 7);
+	*sum += chunkData[i];
+    }
+    
+    IFF_setRawChunkData(bodyChunk, chunkData, BODY_SIZE);
+    IFF_setTextData(textChunk, "Hello");
+    
+    IFF_addToForm(form, (IFF_Chunk*)bodyChunk);
+    IFF_addToForm(form, (IFF_Chunk*)textChunk);
+    
+    return form;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long sum;
+    IFF_Form *form = createForm(&sum);
+    SinkState state = { 0, 0, 0, 0, 0 };
+    IFF_BodySink sink;
+    IFF_FileReader reader;
+    IFF_Chunk *chunk;
+    IFF_RawChunk *bodyChunk, *textChunk;
+    FILE *file;
+    int status;
+    
+    sink.chunkId = "BODY";
+    sink.beginBody = &beginBody;
+    sink.consumeBody = &consumeBody;
+    sink.endBody = &endBody;
+    sink.userData = &state;
+    
+    status = IFF_write(SOURCE_FILENAME, (IFF_Chunk*)form, NULL, 0);
+    IFF_free((IFF_Chunk*)form, NULL, 0);
+    
+    if(!status || (file = fopen(SOURCE_FILENAME, "rb")) == NULL)
+	return 1;
+    
+    /* Read the file while passing the BODY chunk to the sink */
+    IFF_initFileReader(&reader, file);
+    IFF_setBodySinks(&reader.base, &sink, 1);
+    chunk = IFF_readReader(&reader.base, NULL, 0);
+    fclose(file);
+    
+    if(chunk == NULL)
+	return 1;
+    
+    bodyChunk = (IFF_RawChunk*)((IFF_Form*)chunk)->chunk[0];
+    textChunk = (IFF_RawChunk*)((IFF_Form*)chunk)->chunk[1];
+    
+    if(state.begun != 1 || state.ended != 1 || state.size != BODY_SIZE || state.sum != sum)
+    {
+	fprintf(stderr, "The sink should have received the complete body!\n");
+	status = FALSE;
+    }
+    
+    if(state.maxBlockSize > IFF_BODY_BLOCK_SIZE)
+    {
+	fprintf(stderr, "The sink received a block that is too large!\n");
+	status = FALSE;
+    }
+    
+    if(bodyChunk->chunkData != NULL || bodyChunk->chunkSize != BODY_SIZE)
+    {
+	fprintf(stderr, "The BODY chunk should have the original size, but no data!\n");
+	status = FALSE;
+    }
+    
+    if(textChunk->chunkData == NULL || textChunk->chunkSize != 5)
+    {
+	fprintf(stderr, "The TEXT chunk should have been read into memory!\n");
+	status = FALSE;
+    }
+    
+    /* The body is not in memory, so it can only be copied from the source file */
+    if(status && IFF_write(FILENAME, chunk, NULL, 0))
+    {
+	fprintf(stderr, "Writing a body that is not in memory should fail!\n");
+	status = FALSE;
+    }
+    
+    if(status && !IFF_writePassthrough(FILENAME, chunk, SOURCE_FILENAME, NULL, 0))
+    {
+	fprintf(stderr, "Copying the BODY chunk from the source file should succeed!\n");
+	status = FALSE;
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    
+    if(status)
+    {
+	/* The copy is identical, so it can be read back completely */
+	unsigned long copySum = 0;
+	unsigned int i;
+	
+	if((chunk = IFF_read(FILENAME, NULL, 0)) == NULL)
+	    return 1;
+	
+	bodyChunk = (IFF_RawChunk*)((IFF_Form*)chunk)->chunk[0];
+	
+	for(i = 0; i < bodyChunk->chunkSize; i++)
+	    copySum += bodyChunk->chunkData[i];
+	
+	if(bodyChunk->chunkSize != BODY_SIZE || copySum != sum)
+	{
+	    fprintf(stderr, "The copied BODY chunk does not match the original!\n");
+	    status = FALSE;
+	}
+	
+	IFF_free(chunk, NULL, 0);
+    }
+    
+    return (!status);
+}
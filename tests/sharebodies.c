@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <cat.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <fileio.h>
+
+#define FILENAME "sharebodies.TEST"
+#define NUM_OF_FORMS 10
+
+static IFF_CAT *createCAT(void)
+{
+    IFF_CAT *cat = IFF_createCAT("TEST");
+    unsigned int i;
+    
+    for(i = 0; i < NUM_OF_FORMS; i++)
+    {
+	IFF_Form *form = IFF_createForm("TEST");
+	IFF_RawChunk *paletteChunk = IFF_createRawChunk("CMAP");
+	IFF_RawChunk *nameChunk = IFF_createRawChunk("NAME");
+	char name[2];
+	
+	name[0] = 'a' + i;
+	name[1] = '\0';
+	
+	IFF_setTextData(paletteChunk, "palette");
+	IFF_setTextData(nameChunk, name);
+	
+	IFF_addToForm(form, (IFF_Chunk*)paletteChunk);
+	IFF_addToForm(form, (IFF_Chunk*)nameChunk);
+	IFF_addToCAT(cat, (IFF_Chunk*)form);
+    }
+    
+    return cat;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_CAT *cat = createCAT();
+    IFF_FileReader reader;
+    IFF_Chunk *chunk;
+    FILE *file;
+    unsigned int i;
+    int status;
+    
+    status = IFF_write(FILENAME, (IFF_Chunk*)cat, NULL, 0);
+    
+    if(!status || (file = fopen(FILENAME, "rb")) == NULL)
+	return 1;
+    
+    IFF_initFileReader(&reader, file);
+    IFF_setReaderOptions(&reader.base, IFF_READ_SHARE_BODIES);
+    chunk = IFF_readReader(&reader.base, NULL, 0);
+    fclose(file);
+    
+    if(chunk == NULL)
+	return 1;
+    
+    if(!IFF_compare(chunk, (IFF_Chunk*)cat, NULL, 0))
+    {
+	fprintf(stderr, "The hierarchy with shared bodies should be equal to the original!\n");
+	status = FALSE;
+    }
+    
+    if(reader.base.bodyTable != NULL)
+    {
+	fprintf(stderr, "The body table should only exist while reading!\n");
+	status = FALSE;
+    }
+    
+    for(i = 0; i < NUM_OF_FORMS; i++)
+    {
+	IFF_Form *form = (IFF_Form*)((IFF_CAT*)chunk)->chunk[i];
+	IFF_Form *firstForm = (IFF_Form*)((IFF_CAT*)chunk)->chunk[0];
+	IFF_RawChunk *paletteChunk = (IFF_RawChunk*)form->chunk[0];
+	IFF_RawChunk *nameChunk = (IFF_RawChunk*)form->chunk[1];
+	
+	if(paletteChunk->sharedData == NULL || paletteChunk->chunkData != ((IFF_RawChunk*)firstForm->chunk[0])->chunkData)
+	{
+	    fprintf(stderr, "Identical bodies should be stored only once!\n");
+	    status = FALSE;
+	}
+	
+	if(i > 0 && nameChunk->chunkData == ((IFF_RawChunk*)firstForm->chunk[1])->chunkData)
+	{
+	    fprintf(stderr, "Different bodies should not be shared!\n");
+	    status = FALSE;
+	}
+    }
+    
+    if(status && ((IFF_RawChunk*)((IFF_Form*)((IFF_CAT*)chunk)->chunk[0])->chunk[0])->sharedData->refCount != NUM_OF_FORMS)
+    {
+	fprintf(stderr, "Each chunk should hold one reference to the shared body!\n");
+	status = FALSE;
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    IFF_free((IFF_Chunk*)cat, NULL, 0);
+    
+    return (!status);
+}
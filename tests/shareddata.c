@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <form.h>
+#include <list.h>
+#include <rawchunk.h>
+#include <shareddata.h>
+#include "listdata.h"
+
+#define FILENAME "shareddata.TEST"
+
+static IFF_UByte buffer[] = { 'a', 'b', 'c', 'd' };
+
+static void countRelease(IFF_UByte *data, void *userData)
+{
+    unsigned int *releaseCount = (unsigned int*)userData;
+    (*releaseCount)++;
+}
+
+static IFF_Form *createForm(IFF_RawChunk **rawChunk)
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    *rawChunk = IFF_createRawChunk("BYE ");
+    IFF_addToForm(form, (IFF_Chunk*)*rawChunk);
+    return form;
+}
+
+/* Borrowed data belongs to the caller, so it must not be freed together with the chunk */
+static int testBorrowed(void)
+{
+    IFF_RawChunk *rawChunk;
+    IFF_Form *form = createForm(&rawChunk);
+    int status;
+    
+    IFF_borrowRawChunkData(rawChunk, buffer, sizeof(buffer));
+    status = (form->chunkSize == 4 + 8 + sizeof(buffer) && rawChunk->chunkData == buffer);
+    
+    if(!status)
+	fprintf(stderr, "The borrowed data should be attached without copying it!\n");
+    
+    IFF_free((IFF_Chunk*)form, NULL, 0);
+    return status;
+}
+
+/* Shared data is released when the last chunk that refers to it has been freed */
+static int testShared(void)
+{
+    unsigned int releaseCount = 0;
+    IFF_SharedData *sharedData = IFF_createSharedData(buffer, sizeof(buffer), &countRelease, &releaseCount);
+    IFF_RawChunk *rawChunk1, *rawChunk2;
+    IFF_Form *form1 = createForm(&rawChunk1);
+    IFF_Form *form2 = createForm(&rawChunk2);
+    int status = TRUE;
+    
+    IFF_setRawChunkSharedData(rawChunk1, sharedData);
+    IFF_setRawChunkSharedData(rawChunk2, sharedData);
+    IFF_releaseSharedData(sharedData);
+    
+    if(!IFF_compare((IFF_Chunk*)form1, (IFF_Chunk*)form2, NULL, 0) || rawChunk1->chunkData != buffer || rawChunk2->chunkData != buffer)
+    {
+	fprintf(stderr, "Both chunks should refer to the shared data!\n");
+	status = FALSE;
+    }
+    
+    IFF_free((IFF_Chunk*)form1, NULL, 0);
+    
+    if(releaseCount != 0)
+    {
+	fprintf(stderr, "The shared data should not be released while it is still referenced!\n");
+	status = FALSE;
+    }
+    
+    IFF_free((IFF_Chunk*)form2, NULL, 0);
+    
+    if(releaseCount != 1)
+    {
+	fprintf(stderr, "The shared data should be released exactly once!\n");
+	status = FALSE;
+    }
+    
+    return status;
+}
+
+/* An output tree can reuse the bodies of an input tree and outlive it */
+static int testReuse(void)
+{
+    IFF_Chunk *chunk = (IFF_Chunk*)IFF_createTestList();
+    IFF_RawChunk *source, *rawChunk;
+    IFF_Form *form = createForm(&rawChunk);
+    IFF_Chunk *copy;
+    int status;
+    
+    status = IFF_write(FILENAME, chunk, NULL, 0);
+    IFF_free(chunk, NULL, 0);
+    
+    if(!status || (chunk = IFF_read(FILENAME, NULL, 0)) == NULL)
+	return FALSE;
+    
+    source = (IFF_RawChunk*)((IFF_Form*)((IFF_List*)chunk)->chunk[0])->chunk[0];
+    
+    if(!IFF_shareRawChunkData(rawChunk, source) || rawChunk->chunkData != source->chunkData)
+    {
+	fprintf(stderr, "The body of the input tree should be reused without copying it!\n");
+	status = FALSE;
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    
+    if(status && (!IFF_write(FILENAME, (IFF_Chunk*)form, NULL, 0) || (copy = IFF_read(FILENAME, NULL, 0)) == NULL))
+	status = FALSE;
+    else if(status)
+    {
+	if(!IFF_compare((IFF_Chunk*)form, copy, NULL, 0) || memcmp(rawChunk->chunkData, "abcd", 4) != 0)
+	{
+	    fprintf(stderr, "The reused body should remain valid after the input tree has been freed!\n");
+	    status = FALSE;
+	}
+	
+	IFF_free(copy, NULL, 0);
+    }
+    
+    IFF_free((IFF_Chunk*)form, NULL, 0);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    int status = testBorrowed();
+    status = testShared() && status;
+    status = testReuse() && status;
+    
+    return (!status);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <iff.h>
+#include <memio.h>
+#include <snapshot.h>
+#include "listdata.h"
+
+#define FILENAME "snapshot.TEST"
+#define INVALID_FILENAME "snapshot-invalid.TEST"
+
+/* Size of the header of a snapshot file, which consists of a magic number and seven IFF_ULong fields */
+#define SNAPSHOT_HEADER_SIZE (IFF_ID_SIZE + 7 * sizeof(IFF_ULong))
+
+/* Copies the snapshot to the invalid file, replaces the given bytes and checks whether opening it fails */
+static int openCorruptSnapshot(const size_t position, const void *value, const size_t size)
+{
+    IFF_UByte data[4096];
+    IFF_Snapshot *snapshot;
+    FILE *file = fopen(FILENAME, "rb");
+    size_t length;
+    
+    if(file == NULL)
+	return FALSE;
+    
+    length = fread(data, sizeof(IFF_UByte), sizeof(data), file);
+    fclose(file);
+    
+    if(position + size > length)
+	return FALSE;
+    
+    memcpy(data + position, value, size);
+    
+    if((file = fopen(INVALID_FILENAME, "wb")) == NULL)
+	return FALSE;
+    
+    fwrite(data, sizeof(IFF_UByte), length, file);
+    fclose(file);
+    
+    if((snapshot = IFF_openSnapshot(INVALID_FILENAME)) != NULL)
+    {
+	IFF_closeSnapshot(snapshot);
+	return FALSE;
+    }
+    
+    return TRUE;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *chunk = (IFF_Chunk*)IFF_createTestList();
+    IFF_Snapshot *snapshot;
+    int status = TRUE;
+    
+    if(!IFF_freezeChunk(FILENAME, chunk, NULL, 0) || (snapshot = IFF_openSnapshot(FILENAME)) == NULL)
+    {
+	IFF_free(chunk, NULL, 0);
+	return 1;
+    }
+    
+    /* The structure of the test list is: LIST, PROP, HELO, FORM, BYE , FORM, BYE */
+    if(snapshot->tree.nodeLength != 7 || !IFF_checkFlatTree(&snapshot->tree) ||
+	memcmp(snapshot->tree.chunkId[5], "FORM", IFF_ID_SIZE) != 0 || snapshot->tree.parent[6] != 5)
+    {
+	fprintf(stderr, "The snapshot does not contain the structure of the test list!\n");
+	status = FALSE;
+    }
+    
+    /* The chunk data is available without parsing */
+    if(status && (memcmp(IFF_getSnapshotChunkData(snapshot, 2), "qwer", 4) != 0 || memcmp(IFF_getSnapshotChunkData(snapshot, 6), "EFGH", 4) != 0))
+    {
+	fprintf(stderr, "The chunk data in the snapshot is not correct!\n");
+	status = FALSE;
+    }
+    
+    /* The serialized file in the snapshot can still be read as a chunk hierarchy */
+    if(status)
+    {
+	IFF_MemoryReader reader;
+	IFF_Chunk *readChunk;
+	
+	IFF_initMemoryReader(&reader, snapshot->data, snapshot->dataSize);
+	readChunk = IFF_readReader(&reader.base, NULL, 0);
+	
+	if(readChunk == NULL || !IFF_compare(readChunk, chunk, NULL, 0))
+	{
+	    fprintf(stderr, "The serialized file in the snapshot does not match the hierarchy!\n");
+	    status = FALSE;
+	}
+	
+	if(readChunk != NULL)
+	    IFF_free(readChunk, NULL, 0);
+    }
+    
+    IFF_closeSnapshot(snapshot);
+    
+    /* Node indices and offsets that point outside the snapshot are rejected */
+    if(status)
+    {
+	const unsigned int n = 7;
+	size_t firstChildPosition = SNAPSHOT_HEADER_SIZE + n * (sizeof(long) + 2 * IFF_ID_SIZE + sizeof(IFF_Long) + sizeof(unsigned int));
+	unsigned int node = 100;
+	long offset = 1000000;
+	
+	if(!openCorruptSnapshot(firstChildPosition, &node, sizeof(unsigned int)))
+	{
+	    fprintf(stderr, "Opening a snapshot with an invalid node index should fail!\n");
+	    status = FALSE;
+	}
+	
+	/* A cycle of sub chunks */
+	node = 0;
+	
+	if(!openCorruptSnapshot(firstChildPosition + 3 * sizeof(unsigned int), &node, sizeof(unsigned int)))
+	{
+	    fprintf(stderr, "Opening a snapshot with a cyclic structure should fail!\n");
+	    status = FALSE;
+	}
+	
+	if(!openCorruptSnapshot(SNAPSHOT_HEADER_SIZE + 6 * sizeof(long), &offset, sizeof(long)))
+	{
+	    fprintf(stderr, "Opening a snapshot with an invalid offset should fail!\n");
+	    status = FALSE;
+	}
+    }
+    
+    /* An IFF file is not a snapshot */
+    if(IFF_write(INVALID_FILENAME, chunk, NULL, 0) && (snapshot = IFF_openSnapshot(INVALID_FILENAME)) != NULL)
+    {
+	fprintf(stderr, "Opening an IFF file as a snapshot should fail!\n");
+	IFF_closeSnapshot(snapshot);
+	status = FALSE;
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    
+    return (!status);
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <iff.h>
+#include <fileio.h>
+#include <memio.h>
+#include <streamwriter.h>
+#include "catdata.h"
+
+/* A writer that forwards to a memory writer, but does not support seeking */
+typedef struct
+{
+    IFF_Writer base;
+    IFF_MemoryWriter *memoryWriter;
+}
+PipeWriter;
+
+static int pipeWrite(IFF_Writer *writer, const void *data, IFF_ULong size)
+{
+    PipeWriter *pipeWriter = (PipeWriter*)writer;
+    return IFF_writeData(&pipeWriter->memoryWriter->base, data, size);
+}
+
+static const struct IFF_WriterCallbacks pipeWriterCallbacks =
+{
+    &pipeWrite,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
+
+static int writeTestCAT(IFF_Writer *writer)
+{
+    IFF_StreamWriter *stream = IFF_createStreamWriter(writer, NULL, 0);
+    int status = IFF_beginGroup(stream, "CAT ", "TEST") &&
+	IFF_beginGroup(stream, "FORM", "TEST") &&
+	IFF_writeDataChunk(stream, "HELO", "abcd", 4) &&
+	IFF_writeDataChunk(stream, "BYE ", "EFG", 3) &&
+	IFF_endGroup(stream) &&
+	IFF_beginSizedGroup(stream, "FORM", "TEST", 30) && /* The size of the second form is known in advance */
+	IFF_writeDataChunk(stream, "HELO", "abcde", 5) &&
+	IFF_writeDataChunk(stream, "BYE ", "FGHI", 4) &&
+	IFF_endGroup(stream); /* The CAT is closed by IFF_closeStreamWriter() */
+    
+    return IFF_closeStreamWriter(stream) && status;
+}
+
+/* Writes a data chunk with a negative size and checks whether it has been rejected before its header was written */
+static int writeNegativeDataChunk(IFF_MemoryWriter *memoryWriter)
+{
+    IFF_StreamWriter *stream = IFF_createStreamWriter(&memoryWriter->base, NULL, 0);
+    int status;
+    IFF_ULong size;
+    
+    if(!IFF_beginGroup(stream, "FORM", "TEST"))
+    {
+	IFF_closeStreamWriter(stream);
+	return FALSE;
+    }
+    
+    size = memoryWriter->size;
+    status = !IFF_writeDataChunk(stream, "HELO", "abcd", -4) && memoryWriter->size == size;
+    
+    IFF_closeStreamWriter(stream);
+    return status;
+}
+
+static int compareTestCAT(IFF_Chunk *chunk)
+{
+    if(chunk == NULL)
+	return FALSE;
+    else
+    {
+	IFF_CAT *cat = IFF_createTestCAT();
+	int status = IFF_compare(chunk, (IFF_Chunk*)cat, NULL, 0);
+	
+	IFF_free(chunk, NULL, 0);
+	IFF_free((IFF_Chunk*)cat, NULL, 0);
+	
+	return status;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_FileWriter fileWriter;
+    IFF_MemoryWriter memoryWriter;
+    IFF_MemoryReader memoryReader;
+    PipeWriter pipeWriter;
+    FILE *file;
+    int status;
+    
+    /* Write to a seekable file, in which the chunk sizes are patched afterwards */
+    file = fopen("streamcat.TEST", "wb");
+    
+    if(file == NULL)
+    {
+	fprintf(stderr, "Cannot open 'streamcat.TEST'\n");
+	return 1;
+    }
+    
+    IFF_initFileWriter(&fileWriter, file);
+    status = writeTestCAT(&fileWriter.base);
+    fclose(file);
+    
+    if(!status || !compareTestCAT(IFF_read("streamcat.TEST", NULL, 0)))
+    {
+	fprintf(stderr, "Streaming to a seekable file failed\n");
+	return 1;
+    }
+    
+    /* Write to a non-seekable writer, which buffers the groups of unknown size */
+    IFF_initMemoryWriter(&memoryWriter);
+    pipeWriter.base.callbacks = &pipeWriterCallbacks;
+    pipeWriter.memoryWriter = &memoryWriter;
+    status = writeTestCAT(&pipeWriter.base);
+    
+    if(status)
+    {
+	IFF_initMemoryReader(&memoryReader, memoryWriter.data, memoryWriter.size);
+	status = compareTestCAT(IFF_readReader(&memoryReader.base, NULL, 0));
+    }
+    
+    IFF_cleanupMemoryWriter(&memoryWriter);
+    
+    if(!status)
+    {
+	fprintf(stderr, "Streaming to a non-seekable writer failed\n");
+	return 1;
+    }
+    
+    /* A data chunk with a negative size should be rejected without writing anything */
+    IFF_initMemoryWriter(&memoryWriter);
+    
+    if(!writeNegativeDataChunk(&memoryWriter))
+    {
+	fprintf(stderr, "A data chunk with a negative size should be rejected\n");
+	status = FALSE;
+    }
+    
+    IFF_cleanupMemoryWriter(&memoryWriter);
+    
+    if(!status)
+	return 1;
+    
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <cat.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <memio.h>
+#include <catfile.h>
+
+#define FILENAME "tailcat.TEST"
+
+static IFF_Form *createForm(const char *text)
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    IFF_RawChunk *rawChunk = IFF_createRawChunk("TEXT");
+    IFF_UByte *chunkData = (IFF_UByte*)malloc(strlen(text) * sizeof(IFF_UByte));
+    
+    memcpy(chunkData, text, strlen(text));
+    IFF_setRawChunkData(rawChunk, chunkData, strlen(text));
+    IFF_addToForm(form, (IFF_Chunk*)rawChunk);
+    
+    return form;
+}
+
+/* Appends the given bytes to the file, without updating the size of the CAT */
+static int appendBytes(const IFF_UByte *data, const size_t size)
+{
+    FILE *file = fopen(FILENAME, "ab");
+    int status = (file != NULL && fwrite(data, sizeof(IFF_UByte), size, file) == size);
+    
+    if(file != NULL && fclose(file) != 0)
+	status = FALSE;
+    
+    return status;
+}
+
+/* Reads the next sub chunk and checks whether it is equal to the expected chunk, or whether there is none if the expected chunk is NULL */
+static int expectChunk(IFF_CATTail *tail, const IFF_Form *expected, const char *step)
+{
+    IFF_Chunk *chunk;
+    int status = IFF_readCATTail(tail, &chunk);
+    
+    if(status)
+    {
+	if(expected == NULL)
+	    status = (chunk == NULL);
+	else
+	    status = (chunk != NULL && IFF_compare(chunk, (const IFF_Chunk*)expected, NULL, 0));
+    }
+    
+    if(chunk != NULL)
+	IFF_free(chunk, NULL, 0);
+    
+    if(!status)
+	fprintf(stderr, "Unexpected result after: %s\n", step);
+    
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_CAT *cat = IFF_createCAT("TEST");
+    IFF_Form *form1 = createForm("abcd");
+    IFF_Form *form2 = createForm("abc");
+    IFF_MemoryWriter writer;
+    IFF_CATTail *tail;
+    long offset;
+    int status;
+    
+    /* Start with an empty CAT */
+    if(!IFF_write(FILENAME, (IFF_Chunk*)cat, NULL, 0) || (tail = IFF_openCATTail(FILENAME, 0, NULL, 0)) == NULL)
+	return 1;
+    
+    status = expectChunk(tail, NULL, "opening an empty CAT");
+    
+    /* A properly appended form is consumed */
+    status = status && IFF_appendToCATFile(FILENAME, (IFF_Chunk*)form1, NULL, 0) && expectChunk(tail, form1, "appending a form");
+    status = status && expectChunk(tail, NULL, "consuming all forms");
+    
+    /* A form that is written in parts is only consumed once it is complete, even though the CAT size is never updated */
+    IFF_initMemoryWriter(&writer);
+    
+    if(status && !IFF_writeWriter(&writer.base, (IFF_Chunk*)form2, NULL, 0))
+	status = FALSE;
+    
+    status = status && appendBytes(writer.data, 5) && expectChunk(tail, NULL, "writing an incomplete header");
+    status = status && appendBytes(writer.data + 5, writer.size - 5) && expectChunk(tail, form2, "completing the form");
+    
+    IFF_cleanupMemoryWriter(&writer);
+    
+    /* A new session resumes at the offset of the previous one */
+    offset = IFF_getCATTailOffset(tail);
+    IFF_closeCATTail(tail);
+    
+    if((tail = IFF_openCATTail(FILENAME, offset, NULL, 0)) == NULL)
+	status = FALSE;
+    else
+    {
+	status = status && expectChunk(tail, NULL, "resuming");
+	status = status && IFF_appendToCATFile(FILENAME, (IFF_Chunk*)form1, NULL, 0) == FALSE; /* The size of the CAT lags behind, so appending is refused */
+	IFF_closeCATTail(tail);
+    }
+    
+    IFF_free((IFF_Chunk*)form1, NULL, 0);
+    IFF_free((IFF_Chunk*)form2, NULL, 0);
+    IFF_free((IFF_Chunk*)cat, NULL, 0);
+    
+    return (!status);
+}
@@ -21,6 +21,7 @@
 
 #include "test.h"
 #include "iff.h"
+#include "checkstream.h"
 #include "hello.h"
 #include "bye.h"
 
@@ -28,8 +29,8 @@
 #define TEST_NUM_OF_EXTENSION_CHUNKS 2
 
 static IFF_FormExtension testFormExtension[] = {
-    {"BYE ", &TEST_readBye, &TEST_writeBye, &TEST_checkBye, &TEST_freeBye, &TEST_printBye, &TEST_compareBye},
-    {"HELO", &TEST_readHello, &TEST_writeHello, &TEST_checkHello, &TEST_freeHello, &TEST_printHello, &TEST_compareHello}
+    {"BYE ", &TEST_readBye, &TEST_writeBye, &TEST_checkBye, &TEST_freeBye, &TEST_printBye, &TEST_compareBye, NULL},
+    {"HELO", &TEST_readHello, &TEST_writeHello, &TEST_checkHello, &TEST_freeHello, &TEST_printHello, &TEST_compareHello, NULL}
 };
 
 static IFF_Extension extension[] = {
@@ -41,6 +42,11 @@ IFF_Chunk *TEST_read(const char *filename)
     return IFF_read(filename, extension, TEST_NUM_OF_FORM_TYPES);
 }
 
+IFF_Chunk *TEST_readChecked(const char *filename)
+{
+    return IFF_readChecked(filename, extension, TEST_NUM_OF_FORM_TYPES);
+}
+
 int TEST_write(const char *filename, const IFF_Chunk *chunk)
 {
     return IFF_write(filename, chunk, extension, TEST_NUM_OF_FORM_TYPES);
@@ -56,6 +62,11 @@ int TEST_check(const IFF_Chunk *chunk)
     return IFF_check(chunk, extension, TEST_NUM_OF_FORM_TYPES);
 }
 
+int TEST_checkFile(const char *filename)
+{
+    return IFF_checkFile(filename, extension, TEST_NUM_OF_FORM_TYPES);
+}
+
 void TEST_print(const IFF_Chunk *chunk, const unsigned int indentLevel)
 {
     IFF_print(chunk, indentLevel, extension, TEST_NUM_OF_FORM_TYPES);
@@ -25,12 +25,16 @@
 
 IFF_Chunk *TEST_read(const char *filename);
 
+IFF_Chunk *TEST_readChecked(const char *filename);
+
 int TEST_write(const char *filename, const IFF_Chunk *chunk);
 
 void TEST_free(IFF_Chunk *chunk);
 
 int TEST_check(const IFF_Chunk *chunk);
 
+int TEST_checkFile(const char *filename);
+
 void TEST_print(const IFF_Chunk *chunk, const unsigned int indentLevel);
 
 int TEST_compare(const IFF_Chunk *chunk1, const IFF_Chunk *chunk2);
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <iff.h>
+#include <form.h>
+#include <list.h>
+#include <rawchunk.h>
+#include "listdata.h"
+
+static unsigned int checkCount = 0;
+
+static int checkBye(const IFF_Chunk *chunk)
+{
+    const IFF_RawChunk *rawChunk = (const IFF_RawChunk*)chunk;
+    
+    checkCount++;
+    return (rawChunk->chunkData[0] != 'z');
+}
+
+static IFF_FormExtension testFormExtension[] = {
+    {"BYE ", NULL, NULL, &checkBye, NULL, NULL, NULL, NULL}
+};
+
+static IFF_Extension extension[] = {
+    {"TEST", 1, testFormExtension}
+};
+
+static IFF_RawChunk *getByeChunk(IFF_List *list, unsigned int index)
+{
+    return (IFF_RawChunk*)((IFF_Form*)list->chunk[index])->chunk[0];
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_List *list = IFF_createTestList();
+    IFF_RawChunk *byeChunk = getByeChunk(list, 0);
+    IFF_RawChunk *otherChunk;
+    int status = TRUE;
+    
+    /* A check without caching visits every chunk and leaves the hierarchy untouched */
+    if(!IFF_check((IFF_Chunk*)list, extension, 1) || checkCount != 2 || (IFF_CHUNK_META(list)->flags & IFF_CHUNK_VALIDATED) || (IFF_CHUNK_META(byeChunk)->flags & IFF_CHUNK_VALIDATED))
+    {
+	fprintf(stderr, "A check without caching should not mark the chunks as validated!\n");
+	status = FALSE;
+    }
+    
+    /* The first cached check visits every chunk and caches the outcome */
+    checkCount = 0;
+    
+    if(!IFF_checkCached((IFF_Chunk*)list, extension, 1) || checkCount != 2)
+    {
+	fprintf(stderr, "The hierarchy should be valid and every BYE chunk should be checked!\n");
+	status = FALSE;
+    }
+    
+    if(!(IFF_CHUNK_META(list)->flags & IFF_CHUNK_VALIDATED) || !(IFF_CHUNK_META(list->prop[0])->flags & IFF_CHUNK_VALIDATED) || !(IFF_CHUNK_META(byeChunk)->flags & IFF_CHUNK_VALIDATED))
+    {
+	fprintf(stderr, "Every checked chunk should be marked as validated!\n");
+	status = FALSE;
+    }
+    
+    /* Checking an unmodified hierarchy again with caching does not invoke the extension */
+    checkCount = 0;
+    
+    if(!IFF_checkCached((IFF_Chunk*)list, extension, 1) || checkCount != 0)
+    {
+	fprintf(stderr, "An unmodified hierarchy should not be checked again!\n");
+	status = FALSE;
+    }
+    
+    /* A check without caching ignores the cached outcome */
+    if(!IFF_check((IFF_Chunk*)list, extension, 1) || checkCount != 2)
+    {
+	fprintf(stderr, "A check without caching should visit every chunk!\n");
+	status = FALSE;
+    }
+    
+    /* Modifying a body discards the outcome of the chunk and its ancestors only */
+    checkCount = 0;
+    byeChunk->chunkData[0] = 'z';
+    IFF_markChunkDirty((IFF_Chunk*)byeChunk);
+    
+    if((IFF_CHUNK_META(list)->flags & IFF_CHUNK_VALIDATED) || (IFF_CHUNK_META(list->chunk[0])->flags & IFF_CHUNK_VALIDATED) || (IFF_CHUNK_META(byeChunk)->flags & IFF_CHUNK_VALIDATED))
+    {
+	fprintf(stderr, "The modified chunk and its ancestors should no longer be validated!\n");
+	status = FALSE;
+    }
+    
+    if(!(IFF_CHUNK_META(list->chunk[1])->flags & IFF_CHUNK_VALIDATED) || !(IFF_CHUNK_META(list->prop[0])->flags & IFF_CHUNK_VALIDATED))
+    {
+	fprintf(stderr, "Unmodified chunks should stay validated!\n");
+	status = FALSE;
+    }
+    
+    if(IFF_checkCached((IFF_Chunk*)list, extension, 1) || checkCount != 1)
+    {
+	fprintf(stderr, "Only the modified chunk should be checked and found invalid!\n");
+	status = FALSE;
+    }
+    
+    /* A failed check is not cached */
+    byeChunk->chunkData[0] = 'a';
+    IFF_markChunkDirty((IFF_Chunk*)byeChunk);
+    checkCount = 0;
+    
+    if(!IFF_checkCached((IFF_Chunk*)list, extension, 1) || checkCount != 1)
+    {
+	fprintf(stderr, "A restored hierarchy should be valid again!\n");
+	status = FALSE;
+    }
+    
+    /* An outcome cached with one extension array does not apply to another */
+    byeChunk->chunkData[0] = 'z';
+    IFF_markChunkDirty((IFF_Chunk*)byeChunk);
+    
+    if(!IFF_checkCached((IFF_Chunk*)list, NULL, 0))
+    {
+	fprintf(stderr, "The hierarchy should be valid without extensions!\n");
+	status = FALSE;
+    }
+    
+    if(IFF_check((IFF_Chunk*)list, extension, 1) || IFF_checkCached((IFF_Chunk*)list, extension, 1))
+    {
+	fprintf(stderr, "A hierarchy validated without extensions should be checked again with them!\n");
+	status = FALSE;
+    }
+    
+    byeChunk->chunkData[0] = 'a';
+    IFF_markChunkDirty((IFF_Chunk*)byeChunk);
+    
+    /* Adding a chunk discards the outcome of the group it is added to */
+    otherChunk = IFF_createRawChunk(" BYE");
+    IFF_addToForm((IFF_Form*)list->chunk[1], (IFF_Chunk*)otherChunk);
+    
+    if(IFF_checkCached((IFF_Chunk*)list, extension, 1))
+    {
+	fprintf(stderr, "A hierarchy with an added invalid chunk should be invalid!\n");
+	status = FALSE;
+    }
+    
+    IFF_free((IFF_Chunk*)list, NULL, 0);
+    
+    return (!status);
+}
@@ -21,6 +21,7 @@
 
 #include "iff.h"
 #include "chunk.h"
+#include "checkstream.h"
 
 int main(int argc, char *argv[])
 {
@@ -30,15 +31,19 @@ int main(int argc, char *argv[])
 	return 1;
     else
     {
+	IFF_Chunk *checkedChunk = IFF_readChecked(argv[1], NULL, 0);
 	int status;
 	
-	if(IFF_check(chunk, NULL, 0)) /* Should succeed */
+	if(IFF_check(chunk, NULL, 0) && checkedChunk != NULL && IFF_compare(chunk, checkedChunk, NULL, 0) && IFF_checkFile(argv[1], NULL, 0)) /* Should succeed, also while reading or streaming */
 	    status = 0;
 	else
 	    status = 1;
 	
 	IFF_free(chunk, NULL, 0);
 	
+	if(checkedChunk != NULL)
+	    IFF_free(checkedChunk, NULL, 0);
+	
 	return status;
     }
 }
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <iff.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <fileio.h>
+#include <memio.h>
+
+#define DATA_FILENAME "filedata.DATA"
+#define FILENAME "filedata.TEST"
+
+#define DATA_SIZE 200000
+#define DATA_OFFSET 1234
+#define BODY_SIZE 100001
+
+static IFF_UByte byteAt(long offset)
+{
+    return (IFF_UByte)(offset * 13 + offset / 256);
+}
+
+static int createDataFile(void)
+{
+    FILE *file = fopen(DATA_FILENAME, "wb");
+    long i;
+    
+    if(file == NULL)
+	return FALSE;
+    
+    for(i = 0; i < DATA_SIZE; i++)
+	fputc(byteAt(i), file);
+    
+    return (fclose(file) == 0);
+}
+
+/* Checks whether a FORM that has been read back contains the referenced range of the data file, followed by the TEXT chunk */
+static int checkForm(const IFF_Chunk *chunk)
+{
+    const IFF_Form *form = (const IFF_Form*)chunk;
+    const IFF_RawChunk *bodyChunk, *textChunk;
+    long i;
+    
+    if(form == NULL || form->chunkLength != 2)
+	return FALSE;
+    
+    bodyChunk = (const IFF_RawChunk*)form->chunk[0];
+    textChunk = (const IFF_RawChunk*)form->chunk[1];
+    
+    if(bodyChunk->chunkSize != BODY_SIZE || textChunk->chunkSize != 5 || memcmp(textChunk->chunkData, "Hello", 5) != 0)
+	return FALSE;
+    
+    for(i = 0; i < BODY_SIZE; i++)
+    {
+	if(bodyChunk->chunkData[i] != byteAt(DATA_OFFSET + i))
+	    return FALSE;
+    }
+    
+    return TRUE;
+}
+
+static int checkFile(void)
+{
+    IFF_Chunk *chunk = IFF_read(FILENAME, NULL, 0);
+    int status = checkForm(chunk);
+    
+    if(chunk != NULL)
+	IFF_free(chunk, NULL, 0);
+    
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form;
+    IFF_RawChunk *bodyChunk, *textChunk;
+    IFF_FileWriter fileWriter;
+    IFF_MemoryWriter memoryWriter;
+    FILE *dataFile, *file;
+    int status = TRUE;
+    
+    if(!createDataFile() || (dataFile = fopen(DATA_FILENAME, "rb")) == NULL)
+	return 1;
+    
+    form = IFF_createForm("TEST");
+    bodyChunk = IFF_createRawChunk("BODY");
+    textChunk = IFF_createRawChunk("TEXT");
+    
+    IFF_setRawChunkFileData(bodyChunk, dataFile, DATA_OFFSET, BODY_SIZE);
+    IFF_setTextData(textChunk, "Hello");
+    IFF_addToForm(form, (IFF_Chunk*)bodyChunk);
+    IFF_addToForm(form, (IFF_Chunk*)textChunk);
+    
+    /* Write the file with the default writer */
+    if(!IFF_write(FILENAME, (IFF_Chunk*)form, NULL, 0) || !checkFile())
+    {
+	fprintf(stderr, "The data of the file should be copied by IFF_write()!\n");
+	status = FALSE;
+    }
+    
+    /* Write the file with a file writer */
+    if(status && (file = fopen(FILENAME, "wb")) != NULL)
+    {
+	IFF_initFileWriter(&fileWriter, file);
+	
+	if(!IFF_writeWriter(&fileWriter.base, (IFF_Chunk*)form, NULL, 0) || fclose(file) != 0 || !checkFile())
+	{
+	    fprintf(stderr, "The data of the file should be copied by a file writer!\n");
+	    status = FALSE;
+	}
+    }
+    
+    /* Write the hierarchy to memory, which does not support copying files */
+    if(status)
+    {
+	IFF_MemoryReader reader;
+	IFF_Chunk *chunk;
+	
+	IFF_initMemoryWriter(&memoryWriter);
+	
+	if(IFF_writeWriter(&memoryWriter.base, (IFF_Chunk*)form, NULL, 0))
+	{
+	    IFF_initMemoryReader(&reader, memoryWriter.data, memoryWriter.size);
+	    chunk = IFF_readReader(&reader.base, NULL, 0);
+	}
+	else
+	    chunk = NULL;
+	
+	if(!checkForm(chunk))
+	{
+	    fprintf(stderr, "The data of the file should be read by a memory writer!\n");
+	    status = FALSE;
+	}
+	
+	if(chunk != NULL)
+	    IFF_free(chunk, NULL, 0);
+	
+	IFF_cleanupMemoryWriter(&memoryWriter);
+    }
+    
+    /* Bodies in a data file can be compared with themselves, with each other and with bodies in memory */
+    if(status)
+    {
+	IFF_Chunk *chunk = IFF_read(FILENAME, NULL, 0);
+	IFF_RawChunk *sameChunk = IFF_createRawChunk("BODY");
+	IFF_RawChunk *otherChunk = IFF_createRawChunk("BODY");
+	
+	IFF_setRawChunkFileData(sameChunk, dataFile, DATA_OFFSET, BODY_SIZE);
+	IFF_setRawChunkFileData(otherChunk, dataFile, DATA_OFFSET + 1, BODY_SIZE);
+	
+	if(!IFF_compare((IFF_Chunk*)form, (IFF_Chunk*)form, NULL, 0) ||
+	    chunk == NULL || !IFF_compare((IFF_Chunk*)form, chunk, NULL, 0) ||
+	    !IFF_compareRawChunk(bodyChunk, sameChunk) ||
+	    IFF_compareRawChunk(bodyChunk, otherChunk) ||
+	    IFF_compareRawChunk((IFF_RawChunk*)((IFF_Form*)chunk)->chunk[0], otherChunk))
+	{
+	    fprintf(stderr, "Bodies in a data file should be compared by their contents!\n");
+	    status = FALSE;
+	}
+	
+	if(chunk != NULL)
+	    IFF_free(chunk, NULL, 0);
+	
+	IFF_free((IFF_Chunk*)sameChunk, NULL, 0);
+	IFF_free((IFF_Chunk*)otherChunk, NULL, 0);
+    }
+    
+    IFF_free((IFF_Chunk*)form, NULL, 0);
+    fclose(dataFile);
+    
+    return (!status);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <iff.h>
+#include <form.h>
+#include <rawchunk.h>
+
+#define NUM_OF_CHUNKS 3000
+#define BODY_SIZE 1025
+#define LARGE_BODY_SIZE 100001
+
+static IFF_RawChunk *createChunk(const IFF_Long chunkSize, const unsigned int seed)
+{
+    IFF_RawChunk *rawChunk = IFF_createRawChunk("DATA");
+    IFF_UByte *chunkData = (IFF_UByte*)malloc(chunkSize * sizeof(IFF_UByte));
+    IFF_Long i;
+    
+    for(i = 0; i < chunkSize; i++)
+	chunkData[i] = (IFF_UByte)(i + seed);
+    
+    IFF_setRawChunkData(rawChunk, chunkData, chunkSize);
+    
+    return rawChunk;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    IFF_Chunk *chunk;
+    unsigned int i;
+    int status;
+    
+    /* Many odd sized bodies, that are referenced in place, interleaved with headers and padding bytes */
+    for(i = 0; i < NUM_OF_CHUNKS; i++)
+	IFF_addToForm(form, (IFF_Chunk*)createChunk(BODY_SIZE, i));
+    
+    /* A body that does not fit in the writer's buffer */
+    IFF_addToForm(form, (IFF_Chunk*)createChunk(LARGE_BODY_SIZE, 0));
+    
+    status = IFF_write("gather.TEST", (IFF_Chunk*)form, NULL, 0);
+    
+    if(status)
+    {
+	chunk = IFF_read("gather.TEST", NULL, 0);
+	status = (chunk != NULL && IFF_compare(chunk, (IFF_Chunk*)form, NULL, 0));
+	
+	if(chunk != NULL)
+	    IFF_free(chunk, NULL, 0);
+    }
+    
+    IFF_free((IFF_Chunk*)form, NULL, 0);
+    
+    return (!status);
+}
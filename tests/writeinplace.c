@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <form.h>
+#include <list.h>
+#include <rawchunk.h>
+#include <inplace.h>
+#include "listdata.h"
+
+#define FILENAME "inplace.TEST"
+#define OTHER_FILENAME "inplace-other.TEST"
+
+/* Writes the hierarchy in place and checks whether the file has exactly the contents of the hierarchy */
+static int writeAndCompare(IFF_Chunk *chunk, const char *step)
+{
+    int status = IFF_writeInPlace(FILENAME, chunk, NULL, 0);
+    
+    if(status)
+    {
+	IFF_Chunk *readChunk = IFF_read(FILENAME, NULL, 0);
+	FILE *file = fopen(FILENAME, "rb");
+	
+	status = (readChunk != NULL && IFF_compare(readChunk, chunk, NULL, 0));
+	
+	/* A file that shrinks must have been truncated */
+	if(file == NULL || fseek(file, 0, SEEK_END) != 0 || ftell(file) != IFF_incrementChunkSize(0, chunk))
+	    status = FALSE;
+	
+	if(file != NULL)
+	    fclose(file);
+	
+	if(readChunk != NULL)
+	    IFF_free(readChunk, NULL, 0);
+    }
+    
+    /* Afterwards, the hierarchy corresponds to the file again */
+    if(status && !IFF_chunkIsClean(chunk))
+	status = FALSE;
+    
+    if(!status)
+	fprintf(stderr, "The file does not match the hierarchy after: %s\n", step);
+    
+    return status;
+}
+
+/* Writes a form with a single chunk that has the given body to a file and reads it back */
+static IFF_Form *writeAndReadForm(const char *filename, const char *text)
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    IFF_RawChunk *bodyChunk = IFF_createRawChunk("BODY");
+    int status;
+    
+    IFF_setTextData(bodyChunk, text);
+    IFF_addToForm(form, (IFF_Chunk*)bodyChunk);
+    
+    status = IFF_write(filename, (IFF_Chunk*)form, NULL, 0);
+    IFF_free((IFF_Chunk*)form, NULL, 0);
+    
+    return status ? (IFF_Form*)IFF_read(filename, NULL, 0) : NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *chunk = (IFF_Chunk*)IFF_createTestList();
+    IFF_List *list;
+    IFF_RawChunk *byeChunk;
+    IFF_UByte *chunkData;
+    int status;
+    
+    /* A hierarchy that has not been read from a file is written completely */
+    status = writeAndCompare(chunk, "writing a new file");
+    IFF_free(chunk, NULL, 0);
+    
+    if(!status)
+	return 1;
+    
+    chunk = IFF_read(FILENAME, NULL, 0);
+    
+    if(chunk == NULL || !IFF_chunkIsClean(chunk))
+    {
+	fprintf(stderr, "A hierarchy that has been read should be unmodified!\n");
+	return 1;
+    }
+    
+    list = (IFF_List*)chunk;
+    byeChunk = (IFF_RawChunk*)((IFF_Form*)list->chunk[0])->chunk[0];
+    
+    /* Modify a chunk without changing its size, which is patched in place */
+    byeChunk->chunkData[0] = 'z';
+    IFF_markChunkDirty((IFF_Chunk*)byeChunk);
+    status = writeAndCompare(chunk, "modifying a chunk");
+    
+    /* Grow a chunk, which moves all chunks behind it */
+    chunkData = (IFF_UByte*)malloc(5 * sizeof(IFF_UByte));
+    memcpy(chunkData, "abcde", 5);
+    free(byeChunk->chunkData);
+    IFF_setRawChunkData(byeChunk, chunkData, 5);
+    status = status && writeAndCompare(chunk, "growing a chunk");
+    
+    /* Remove the last form, which shrinks the file */
+    if(status)
+    {
+	IFF_Chunk *form = list->chunk[list->chunkLength - 1];
+	
+	status = IFF_removeFromList(list, form) && writeAndCompare(chunk, "removing a chunk");
+	IFF_free(form, NULL, 0);
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    
+    /* A chunk taken from a file with the same layout has the same offset, but not the same bytes */
+    if(status)
+    {
+	IFF_Form *form = writeAndReadForm(FILENAME, "aaaa");
+	IFF_Form *otherForm = writeAndReadForm(OTHER_FILENAME, "bbbb");
+	
+	if(form == NULL || otherForm == NULL)
+	    status = FALSE;
+	else
+	{
+	    IFF_Chunk *bodyChunk = form->chunk[0];
+	    IFF_Chunk *otherBodyChunk = otherForm->chunk[0];
+	    
+	    status = IFF_removeFromForm(form, bodyChunk) && IFF_removeFromForm(otherForm, otherBodyChunk);
+	    IFF_addToForm(form, otherBodyChunk);
+	    IFF_free(bodyChunk, NULL, 0);
+	    
+	    status = status && writeAndCompare((IFF_Chunk*)form, "moving a chunk from another file");
+	}
+	
+	if(form != NULL)
+	    IFF_free((IFF_Chunk*)form, NULL, 0);
+	
+	if(otherForm != NULL)
+	    IFF_free((IFF_Chunk*)otherForm, NULL, 0);
+    }
+    
+    return (!status);
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <memio.h>
+#include "formdata.h"
+
+int main(int argc, char *argv[])
+{
+#if HAVE_OPEN_MEMSTREAM == 1
+    IFF_Chunk *chunk = (IFF_Chunk*)IFF_createTestForm();
+    IFF_MemoryWriter writer;
+    char *data = NULL;
+    size_t size = 0;
+    FILE *file;
+    int status;
+    
+    /* A memory stream has no file descriptor, so it must be written through the stream */
+    IFF_initMemoryWriter(&writer);
+    
+    if((file = open_memstream(&data, &size)) == NULL)
+	status = FALSE;
+    else
+    {
+	status = IFF_writeFd(file, chunk, NULL, 0);
+	fclose(file);
+    }
+    
+    if(!status || !IFF_writeWriter(&writer.base, chunk, NULL, 0) || size != writer.size || memcmp(data, writer.data, size) != 0)
+    {
+	fprintf(stderr, "The form should be written to the memory stream!\n");
+	status = FALSE;
+    }
+    
+    free(data);
+    IFF_cleanupMemoryWriter(&writer);
+    IFF_free(chunk, NULL, 0);
+    
+    return (!status);
+#else
+    /* Skip the test if memory streams are not supported */
+    return 77;
+#endif
+}
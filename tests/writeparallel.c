@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdlib.h>
+#include <iff.h>
+#include <cat.h>
+#include <form.h>
+#include <rawchunk.h>
+#include <parallel.h>
+#include "listdata.h"
+
+#define NUM_OF_FORMS 100
+#define NUM_OF_THREADS 4
+
+static IFF_CAT *createLargeCAT(void)
+{
+    IFF_CAT *cat = IFF_createCAT("TEST");
+    unsigned int i;
+    
+    for(i = 0; i < NUM_OF_FORMS; i++)
+    {
+	IFF_Form *form = IFF_createForm("TEST");
+	IFF_RawChunk *rawChunk = IFF_createRawChunk("DATA");
+	IFF_Long chunkSize = i + 1; /* Both odd and even sizes */
+	IFF_UByte *chunkData = (IFF_UByte*)malloc(chunkSize * sizeof(IFF_UByte));
+	IFF_Long j;
+	
+	for(j = 0; j < chunkSize; j++)
+	    chunkData[j] = (IFF_UByte)(i + j);
+	
+	IFF_setRawChunkData(rawChunk, chunkData, chunkSize);
+	IFF_addToForm(form, (IFF_Chunk*)rawChunk);
+	IFF_addToCAT(cat, (IFF_Chunk*)form);
+    }
+    
+    return cat;
+}
+
+static int writeAndCompare(IFF_Chunk *chunk)
+{
+    int status = IFF_writeParallel("parallel.TEST", chunk, NULL, 0, NUM_OF_THREADS);
+    
+    if(status)
+    {
+	IFF_Chunk *readChunk = IFF_read("parallel.TEST", NULL, 0);
+	
+	status = (readChunk != NULL && IFF_compare(readChunk, chunk, NULL, 0));
+	
+	if(readChunk != NULL)
+	    IFF_free(readChunk, NULL, 0);
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    /* A concatenation of many forms, which are distributed over the threads */
+    if(!writeAndCompare((IFF_Chunk*)createLargeCAT()))
+	return 1;
+    
+    /* A list, of which the PROP chunks must precede the other sub chunks */
+    if(!writeAndCompare((IFF_Chunk*)IFF_createTestList()))
+	return 1;
+    
+    return 0;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2012 Sander van der Burg
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so, 
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iff.h>
+#include <form.h>
+#include <list.h>
+#include <rawchunk.h>
+#include <passthrough.h>
+#include "listdata.h"
+
+#define SOURCE_FILENAME "passthrough-source.TEST"
+#define FILENAME "passthrough.TEST"
+#define OTHER_SOURCE_FILENAME "passthrough-other.TEST"
+
+/* Checks whether two files have exactly the same contents */
+static int compareFiles(const char *filename1, const char *filename2)
+{
+    FILE *file1 = fopen(filename1, "rb");
+    FILE *file2 = fopen(filename2, "rb");
+    int status = (file1 != NULL && file2 != NULL);
+    
+    while(status)
+    {
+	int byte1 = fgetc(file1);
+	int byte2 = fgetc(file2);
+	
+	if(byte1 != byte2)
+	    status = FALSE;
+	else if(byte1 == EOF)
+	    break;
+    }
+    
+    if(file1 != NULL)
+	fclose(file1);
+    
+    if(file2 != NULL)
+	fclose(file2);
+    
+    return status;
+}
+
+/* Checks whether the written file has exactly the contents of the hierarchy */
+static int compareWithFile(const IFF_Chunk *chunk, const char *filename)
+{
+    IFF_Chunk *readChunk = IFF_read(filename, NULL, 0);
+    int status = (readChunk != NULL && IFF_compare(readChunk, chunk, NULL, 0));
+    
+    if(readChunk != NULL)
+	IFF_free(readChunk, NULL, 0);
+    
+    return status;
+}
+
+/* Writes a form with a single chunk that has the given body to a file and reads it back */
+static IFF_Form *writeAndReadForm(const char *filename, const char *text)
+{
+    IFF_Form *form = IFF_createForm("TEST");
+    IFF_RawChunk *bodyChunk = IFF_createRawChunk("BODY");
+    int status;
+    
+    IFF_setTextData(bodyChunk, text);
+    IFF_addToForm(form, (IFF_Chunk*)bodyChunk);
+    
+    status = IFF_write(filename, (IFF_Chunk*)form, NULL, 0);
+    IFF_free((IFF_Chunk*)form, NULL, 0);
+    
+    return status ? (IFF_Form*)IFF_read(filename, NULL, 0) : NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    IFF_Chunk *chunk = (IFF_Chunk*)IFF_createTestList();
+    IFF_RawChunk *byeChunk;
+    IFF_UByte *chunkData;
+    int status;
+    
+    status = IFF_write(SOURCE_FILENAME, chunk, NULL, 0);
+    IFF_free(chunk, NULL, 0);
+    
+    if(!status || (chunk = IFF_read(SOURCE_FILENAME, NULL, 0)) == NULL)
+	return 1;
+    
+    /* An unmodified hierarchy is copied completely */
+    if(!IFF_writePassthrough(FILENAME, chunk, SOURCE_FILENAME, NULL, 0) || !compareFiles(FILENAME, SOURCE_FILENAME))
+    {
+	fprintf(stderr, "Copying an unmodified hierarchy should produce an identical file!\n");
+	status = FALSE;
+    }
+    
+    /* Grow a chunk, so that its ancestors are serialized while its siblings are copied */
+    byeChunk = (IFF_RawChunk*)((IFF_Form*)((IFF_List*)chunk)->chunk[0])->chunk[0];
+    chunkData = (IFF_UByte*)malloc(5 * sizeof(IFF_UByte));
+    memcpy(chunkData, "abcde", 5);
+    free(byeChunk->chunkData);
+    IFF_setRawChunkData(byeChunk, chunkData, 5);
+    
+    if(status && (!IFF_writePassthrough(FILENAME, chunk, SOURCE_FILENAME, NULL, 0) || !compareWithFile(chunk, FILENAME)))
+    {
+	fprintf(stderr, "The file does not match the modified hierarchy!\n");
+	status = FALSE;
+    }
+    
+    /* The source file cannot be overwritten */
+    if(status && IFF_writePassthrough(SOURCE_FILENAME, chunk, SOURCE_FILENAME, NULL, 0))
+    {
+	fprintf(stderr, "Overwriting the source file should fail!\n");
+	status = FALSE;
+    }
+    
+    IFF_free(chunk, NULL, 0);
+    
+    /* A chunk moved in from a file with the same layout has the same offset and header, but not the same bytes */
+    if(status)
+    {
+	IFF_Form *form = writeAndReadForm(SOURCE_FILENAME, "aaaa");
+	IFF_Form *otherForm = writeAndReadForm(OTHER_SOURCE_FILENAME, "bbbb");
+	
+	if(form == NULL || otherForm == NULL)
+	    status = FALSE;
+	else
+	{
+	    IFF_Chunk *bodyChunk = form->chunk[0];
+	    IFF_Chunk *otherBodyChunk = otherForm->chunk[0];
+	    
+	    status = IFF_removeFromForm(form, bodyChunk) && IFF_removeFromForm(otherForm, otherBodyChunk);
+	    IFF_addToForm(form, otherBodyChunk);
+	    IFF_free(bodyChunk, NULL, 0);
+	    
+	    if(status && (!IFF_writePassthrough(FILENAME, (IFF_Chunk*)form, SOURCE_FILENAME, NULL, 0) || !compareWithFile((IFF_Chunk*)form, FILENAME)))
+	    {
+		fprintf(stderr, "A chunk from another file should not be copied from the source file!\n");
+		status = FALSE;
+	    }
+	}
+	
+	if(form != NULL)
+	    IFF_free((IFF_Chunk*)form, NULL, 0);
+	
+	if(otherForm != NULL)
+	    IFF_free((IFF_Chunk*)otherForm, NULL, 0);
+    }
+    
+    return (!status);
+}